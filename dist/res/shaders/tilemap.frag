@@ -0,0 +1,70 @@
+#version 330 core
+
+// Tile spritesheet
+uniform sampler2D tex;
+uniform int spritesheet_columns;
+uniform ivec2 sprite_size;
+uniform int sprite_padding;
+
+uniform sampler2D palette;
+uniform float palette_txy;
+
+// Texture index of every tile in the map
+uniform usampler2D tile_indices;
+
+// Horizontal distance between columns of tiles, in pixels.
+// Tiles overlap, so this is half the width of a tile (see RenderUtils::tileToPx_X).
+uniform int column_width;
+
+// Vertical distance between rows of tiles, in pixels.
+// Odd columns are offset by half of this (see RenderUtils::tileToPx_Y).
+uniform int row_height;
+
+in vec2 world_pos;
+
+out vec4 frag_color;
+
+void main() {
+    ivec2 map_size = textureSize(tile_indices, 0);
+    ivec2 pos = ivec2(floor(world_pos));
+
+    // Up to 6 tile sprites can overlap this pixel: 2 columns, and up to 3 rows within each column.
+    // We consider them in the order they would be drawn one by one, and take the first visible pixel.
+    int first_col = int(floor(world_pos.x / column_width)) - 1;
+    int first_row = int(floor(world_pos.y / row_height)) - 2;
+
+    for (int y = first_row; y <= first_row + 2; ++y)
+    {
+        for (int x = first_col; x <= first_col + 1; ++x)
+        {
+            if (x < 0 || y < 0 || x >= map_size.x || y >= map_size.y)
+            {
+                continue;
+            }
+
+            ivec2 sprite_pos = ivec2(x * column_width, y * row_height + (x % 2) * (row_height / 2));
+            ivec2 offset = pos - sprite_pos;
+            if (offset.x < 0 || offset.y < 0 || offset.x >= sprite_size.x || offset.y >= sprite_size.y)
+            {
+                continue;
+            }
+
+            int tx_index = int(texelFetch(tile_indices, ivec2(x, y), 0).r);
+            ivec2 sprite_cell = ivec2(tx_index % spritesheet_columns, tx_index / spritesheet_columns);
+            ivec2 texel = sprite_cell * (sprite_size + 2 * sprite_padding) + sprite_padding + offset;
+
+            float palette_index = texelFetch(tex, texel, 0).r;
+            if (palette_index == 0 || palette_index == 1)
+            {
+                // Transparent
+                continue;
+            }
+
+            vec2 palette_lookup = vec2(palette_index, palette_txy);
+            frag_color = texture(palette, palette_lookup);
+            return;
+        }
+    }
+
+    discard;
+}
@@ -0,0 +1,12 @@
+#version 330 core
+
+uniform mat4 view_proj_matrix;
+
+layout(location = 0) in vec3 in_vertex;
+
+out vec2 world_pos;
+
+void main() {
+    gl_Position = view_proj_matrix * vec4(in_vertex.x, in_vertex.y, in_vertex.z, 1);
+    world_pos = in_vertex.xy;
+}
@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "utils/BufferUtils.h"
+
+using namespace Rival;
+
+SCENARIO("16-bit values are written in little-endian byte order", "[buffer-utils]")
+{
+    GIVEN("A buffer containing a 16-bit value")
+    {
+        std::vector<char> buffer;
+        buffer.reserve(sizeof(std::uint16_t));
+        BufferUtils::addUint16ToBuffer(buffer, 0x1234);
+
+        THEN("the least significant byte comes first, regardless of the platform")
+        {
+            REQUIRE(buffer == std::vector<char> { 0x34, 0x12 });
+        }
+
+        THEN("the value can be read back")
+        {
+            std::size_t offset = 0;
+            REQUIRE(BufferUtils::readUint16FromBuffer(buffer, offset) == 0x1234);
+            REQUIRE(offset == buffer.size());
+        }
+    }
+}
+
+SCENARIO("Variable-length integers use fewer bytes for smaller values", "[buffer-utils]")
+{
+    GIVEN("An empty buffer")
+    {
+        std::vector<char> buffer;
+        buffer.reserve(BufferUtils::maxVarIntBytes);
+
+        WHEN("unsigned values are written")
+        {
+            THEN("each value takes one byte per 7 bits, and can be read back")
+            {
+                const std::vector<std::pair<std::uint32_t, std::size_t>> expectedSizes = {
+                    { 0, 1 }, { 127, 1 }, { 128, 2 }, { 16383, 2 }, { 16384, 3 }, { UINT32_MAX, 5 }
+                };
+
+                for (const auto& [val, expectedSize] : expectedSizes)
+                {
+                    buffer.clear();
+                    BufferUtils::addVarUintToBuffer(buffer, val);
+                    REQUIRE(buffer.size() == expectedSize);
+
+                    std::size_t offset = 0;
+                    REQUIRE(BufferUtils::readVarUintFromBuffer(buffer, offset) == val);
+                    REQUIRE(offset == expectedSize);
+                }
+            }
+        }
+
+        WHEN("signed values are written")
+        {
+            THEN("small negative values are also small, and every value can be read back")
+            {
+                const std::vector<std::pair<std::int32_t, std::size_t>> expectedSizes = {
+                    { 0, 1 }, { -1, 1 }, { 1, 1 }, { -64, 1 }, { 64, 2 }, { INT32_MIN, 5 }, { INT32_MAX, 5 }
+                };
+
+                for (const auto& [val, expectedSize] : expectedSizes)
+                {
+                    buffer.clear();
+                    BufferUtils::addVarIntToBuffer(buffer, val);
+                    REQUIRE(buffer.size() == expectedSize);
+
+                    std::size_t offset = 0;
+                    REQUIRE(BufferUtils::readVarIntFromBuffer(buffer, offset) == val);
+                }
+            }
+        }
+    }
+
+    GIVEN("A variable-length integer that is truncated")
+    {
+        const std::vector<char> buffer = { static_cast<char>(0x80) };
+
+        THEN("reading it throws an exception")
+        {
+            std::size_t offset = 0;
+            REQUIRE_THROWS_AS(BufferUtils::readVarUintFromBuffer(buffer, offset), std::runtime_error);
+        }
+    }
+
+    GIVEN("A variable-length integer that is too long")
+    {
+        const std::vector<char> buffer(BufferUtils::maxVarIntBytes + 1, static_cast<char>(0x80));
+
+        THEN("reading it throws an exception")
+        {
+            std::size_t offset = 0;
+            REQUIRE_THROWS_AS(BufferUtils::readVarUintFromBuffer(buffer, offset), std::runtime_error);
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "commands/GameCommandFactory.h"
+#include "net/Connection.h"
+#include "net/packets/GameCommandPacket.h"
+#include "net/packets/RelayedPacket.h"
+#include "GameCommand.h"
+#include "GroupMoveCommand.h"
+#include "MapUtils.h"
+#include "MoveCommand.h"
+
+using namespace Rival;
+
+namespace {
+
+/** Serializes a packet exactly as it would be sent. */
+std::vector<char> serialize(const Packet& packet)
+{
+    std::vector<char> buffer;
+    buffer.reserve(Connection::maxBufferSize);
+    packet.serialize(buffer);
+    packet.finalize(buffer);
+    return buffer;
+}
+
+/** Passes serialized packet data through the relay server, returning the data received by other clients. */
+std::vector<char> relay(const std::vector<char>& packetData, int clientId)
+{
+    RelayedPacket relayedPacket(std::vector<char>(packetData.cbegin() + Packet::sizeBytes, packetData.cend()), clientId);
+    std::vector<char> relayedData = serialize(relayedPacket);
+    return std::vector<char>(relayedData.cbegin() + Packet::sizeBytes, relayedData.cend());
+}
+
+}  // namespace
+
+SCENARIO("GameCommandPackets are sent in a compact format", "[net][game-command-packet]")
+{
+    GameCommandFactory commandFactory;
+
+    GIVEN("A packet containing a move command")
+    {
+        std::shared_ptr<GameCommand> command = std::make_shared<MoveCommand>(42, MapNode { 100, 200 });
+        GameCommandPacket packet({ command }, 1000, 999);
+        const std::vector<char> packetData = serialize(packet);
+
+        WHEN("the packet is received by another client")
+        {
+            const std::vector<char> receivedData = relay(packetData, 3);
+            auto received = GameCommandPacket::deserialize(receivedData.data(), receivedData.size(), commandFactory);
+
+            THEN("the tick is relative to the previous packet")
+            {
+                REQUIRE(received->getTickDelta() == 1);
+            }
+
+            THEN("the command is reproduced exactly")
+            {
+                REQUIRE(received->getCommands().size() == 1);
+                REQUIRE(received->getCommands()[0]->getType() == GameCommandType::Move);
+
+                std::vector<char> originalCommandData;
+                originalCommandData.reserve(Connection::maxBufferSize);
+                command->serialize(originalCommandData);
+                std::vector<char> receivedCommandData;
+                receivedCommandData.reserve(Connection::maxBufferSize);
+                received->getCommands()[0]->serialize(receivedCommandData);
+                REQUIRE(receivedCommandData == originalCommandData);
+            }
+
+            AND_WHEN("another packet is received after the first has been released")
+            {
+                const GameCommandPacket* firstPacket = received.get();
+                received.reset();
+
+                GameCommandPacket emptyPacket({}, 1001, 1000);
+                const std::vector<char> emptyPacketData = serialize(emptyPacket);
+                const std::vector<char> secondReceivedData = relay(emptyPacketData, 3);
+                auto secondReceived = GameCommandPacket::deserialize(
+                        secondReceivedData.data(), secondReceivedData.size(), commandFactory);
+
+                THEN("the same packet object is reused, without any of its previous contents")
+                {
+                    REQUIRE(secondReceived.get() == firstPacket);
+                    REQUIRE(secondReceived->getCommands().empty());
+                    REQUIRE(secondReceived->getTickDelta() == 1);
+                }
+            }
+        }
+
+        THEN("it is less than half the size of a packet using fixed-size fields")
+        {
+            const std::size_t fixedSize = sizeof(int) /* packet size */ + sizeof(PacketType)
+                    + sizeof(std::uint8_t) /* num commands */ + sizeof(int) /* tick */ + sizeof(GameCommandType)
+                    + sizeof(int) /* entity ID */ + sizeof(MapNode);
+            REQUIRE(packetData.size() * 2 <= fixedSize);
+        }
+    }
+
+    GIVEN("A packet containing a group move command for 50 units")
+    {
+        std::vector<int> entityIds;
+        for (int i = 0; i < 50; ++i)
+        {
+            entityIds.push_back(1000 + i);
+        }
+        std::shared_ptr<GameCommand> command = std::make_shared<GroupMoveCommand>(entityIds, MapNode { 100, 200 });
+        GameCommandPacket packet({ command }, 1000, 999);
+        const std::vector<char> packetData = serialize(packet);
+
+        WHEN("the packet is received by another client")
+        {
+            const std::vector<char> receivedData = relay(packetData, 3);
+            auto received = GameCommandPacket::deserialize(receivedData.data(), receivedData.size(), commandFactory);
+
+            THEN("the command is reproduced exactly")
+            {
+                REQUIRE(received->getCommands().size() == 1);
+                REQUIRE(received->getCommands()[0]->getType() == GameCommandType::GroupMove);
+
+                const auto& receivedCommand = static_cast<const GroupMoveCommand&>(*received->getCommands()[0]);
+                REQUIRE(receivedCommand.getEntityIds() == entityIds);
+                REQUIRE(receivedCommand.getDestination() == MapNode { 100, 200 });
+            }
+        }
+
+        THEN("it is much smaller than a packet containing a move command for each unit")
+        {
+            std::vector<std::shared_ptr<GameCommand>> moveCommands;
+            for (int entityId : entityIds)
+            {
+                moveCommands.push_back(std::make_shared<MoveCommand>(entityId, MapNode { 100, 200 }));
+            }
+            GameCommandPacket movePacket(moveCommands, 1000, 999);
+            const std::vector<char> movePacketData = serialize(movePacket);
+
+            REQUIRE(packetData.size() * 4 <= movePacketData.size());
+        }
+    }
+
+    GIVEN("A group move command with too many units")
+    {
+        const std::vector<int> entityIds(GroupMoveCommand::maxGroupSize + 1, 1);
+        GroupMoveCommand command(entityIds, MapNode { 100, 200 });
+
+        THEN("it cannot be serialized")
+        {
+            std::vector<char> buffer;
+            buffer.reserve(Connection::maxBufferSize);
+            REQUIRE_THROWS_AS(command.serialize(buffer), std::runtime_error);
+        }
+    }
+
+    GIVEN("An empty packet")
+    {
+        GameCommandPacket packet({}, 1000, 999);
+        const std::vector<char> packetData = serialize(packet);
+
+        THEN("it is no more than half the size of a packet using fixed-size fields")
+        {
+            const std::size_t fixedSize = sizeof(int) /* packet size */ + sizeof(PacketType)
+                    + sizeof(std::uint8_t) /* num commands */ + sizeof(int) /* tick */;
+            REQUIRE(packetData.size() * 2 <= fixedSize);
+        }
+    }
+}
@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <algorithm>  // std::find
+#include <cstddef>    // std::size_t
+#include <cstdlib>    // std::abs
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "Entity.h"
+#include "GameCommand.h"
+#include "GroupMoveCommand.h"
+#include "MapUtils.h"
+#include "MovementComponent.h"
+#include "Pathfinding.h"
+#include "World.h"
+
+using namespace Rival;
+
+namespace {
+
+/** Allows units to move over any clear tile. */
+class ClearTilePassabilityChecker : public Pathfinding::PassabilityChecker
+{
+public:
+    bool isNodePathable(const PathfindingMap& map, const MapNode& node) const override
+    {
+        return map.getPassability(node) == TilePassability::Clear;
+    }
+
+    bool isNodeTraversable(const PathfindingMap& map, const MapNode& node) const override
+    {
+        return isNodePathable(map, node);
+    }
+};
+
+/** Leaves the passability of the map untouched as units move. */
+class NullPassabilityUpdater : public Pathfinding::PassabilityUpdater
+{
+public:
+    void onUnitLeavingTile(WritablePathfindingMap&, const MapNode&) override {}
+    void onUnitEnteringTile(WritablePathfindingMap&, const MapNode&) override {}
+    void onUnitLeftTile(WritablePathfindingMap&, const MapNode&) override {}
+    void onUnitEnteredTile(WritablePathfindingMap&, const MapNode&) override {}
+};
+
+class TestCommandContext : public GameCommandContext
+{
+public:
+    TestCommandContext(World& world)
+        : world(world)
+    {
+    }
+
+    World& getWorld() override
+    {
+        return world;
+    }
+
+    void setCommandDelay(int) override {}
+
+private:
+    World& world;
+};
+
+/** Adds a unit to the World, returning the ID it was given. */
+int addUnit(World& world,
+        const Pathfinding::PassabilityChecker& passabilityChecker,
+        Pathfinding::PassabilityUpdater& passabilityUpdater,
+        MapNode pos)
+{
+    auto entity = std::make_shared<Entity>(EntityType::Unit, 1, 1);
+    entity->attach(std::make_shared<MovementComponent>(passabilityChecker, passabilityUpdater));
+    world.addEntity(entity, pos.x, pos.y);
+    return entity->getId();
+}
+
+const Pathfinding::Route& getRoute(World& world, int entityId)
+{
+    return world.getMutableEntity(entityId)->getComponent<MovementComponent>(MovementComponent::key)->getRoute();
+}
+
+/** Gets the tile where a unit will end up. */
+MapNode getEndTile(World& world, int entityId)
+{
+    const Pathfinding::Route& route = getRoute(world, entityId);
+    return route.isEmpty() ? world.getEntity(entityId)->getPos() : route.getPath().back();
+}
+
+/** Determines if every node in `route` is the corresponding node of `leaderRoute`, offset by `offset`. */
+bool isShiftedRoute(const std::deque<MapNode>& route, const std::deque<MapNode>& leaderRoute, MapNode offset)
+{
+    if (route.size() != leaderRoute.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < route.size(); ++i)
+    {
+        if (route[i] != MapNode { leaderRoute[i].x + offset.x, leaderRoute[i].y + offset.y })
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+SCENARIO("GroupMoveCommand moves units in formation", "[group-move-command]")
+{
+    ClearTilePassabilityChecker passabilityChecker;
+    NullPassabilityUpdater passabilityUpdater;
+    World world(16, 10, false);
+    TestCommandContext context(world);
+
+    GIVEN("A leader and a follower 2 columns apart")
+    {
+        const int leaderId = addUnit(world, passabilityChecker, passabilityUpdater, { 2, 2 });
+        const int followerId = addUnit(world, passabilityChecker, passabilityUpdater, { 4, 2 });
+
+        WHEN("the group is moved")
+        {
+            GroupMoveCommand command({ leaderId, followerId }, { 2, 6 });
+            command.execute(context);
+
+            THEN("the leader finds a route to the destination")
+            {
+                REQUIRE(getEndTile(world, leaderId) == MapNode { 2, 6 });
+            }
+
+            AND_THEN("the follower's route is the leader's route, shifted by the same offset")
+            {
+                const Pathfinding::Route& leaderRoute = getRoute(world, leaderId);
+                const Pathfinding::Route& followerRoute = getRoute(world, followerId);
+                REQUIRE(isShiftedRoute(followerRoute.getPath(), leaderRoute.getPath(), { 2, 0 }));
+                REQUIRE(getEndTile(world, followerId) == MapNode { 4, 6 });
+            }
+        }
+    }
+
+    GIVEN("A leader and a follower in a column with a different parity")
+    {
+        const int leaderId = addUnit(world, passabilityChecker, passabilityUpdater, { 2, 2 });
+        const int followerId = addUnit(world, passabilityChecker, passabilityUpdater, { 5, 2 });
+
+        WHEN("the group is moved")
+        {
+            GroupMoveCommand command({ leaderId, followerId }, { 2, 6 });
+            command.execute(context);
+
+            THEN("the follower first takes a diagonal step towards the leader")
+            {
+                const std::deque<MapNode>& followerPath = getRoute(world, followerId).getPath();
+                REQUIRE(!followerPath.empty());
+                REQUIRE(followerPath.front() == MapNode { 4, 2 });
+
+                const std::vector<MapNode> neighbors = MapUtils::findNeighbors({ 5, 2 }, world);
+                REQUIRE(std::find(neighbors.cbegin(), neighbors.cend(), MapNode { 4, 2 }) != neighbors.cend());
+            }
+
+            AND_THEN("the rest of its route is the leader's route, shifted by an even number of columns")
+            {
+                const std::deque<MapNode>& leaderPath = getRoute(world, leaderId).getPath();
+                const std::deque<MapNode>& followerPath = getRoute(world, followerId).getPath();
+                const std::deque<MapNode> formationPath(followerPath.cbegin() + 1, followerPath.cend());
+                REQUIRE(isShiftedRoute(formationPath, leaderPath, { 2, 0 }));
+            }
+        }
+    }
+
+    GIVEN("A leader and some followers whose shifted routes are blocked")
+    {
+        const int leaderId = addUnit(world, passabilityChecker, passabilityUpdater, { 2, 2 });
+        const std::vector<int> followerIds = {
+            addUnit(world, passabilityChecker, passabilityUpdater, { 4, 2 }),
+            addUnit(world, passabilityChecker, passabilityUpdater, { 6, 2 }),
+            addUnit(world, passabilityChecker, passabilityUpdater, { 8, 2 }),
+        };
+        world.setPassability({ 4, 4 }, TilePassability::Building);
+        world.setPassability({ 6, 4 }, TilePassability::Building);
+        world.setPassability({ 8, 4 }, TilePassability::Building);
+
+        WHEN("the group is moved")
+        {
+            std::vector<int> entityIds = { leaderId };
+            entityIds.insert(entityIds.end(), followerIds.cbegin(), followerIds.cend());
+            GroupMoveCommand command(entityIds, { 2, 6 });
+            command.execute(context);
+
+            THEN("every unit ends up on a different free tile")
+            {
+                std::unordered_set<MapNode> endTiles = { getEndTile(world, leaderId) };
+                for (int followerId : followerIds)
+                {
+                    const MapNode endTile = getEndTile(world, followerId);
+                    REQUIRE(passabilityChecker.isNodePathable(world, endTile));
+                    REQUIRE(endTiles.insert(endTile).second);
+                }
+            }
+
+            AND_THEN("the followers end up close to the destination")
+            {
+                for (int followerId : followerIds)
+                {
+                    const MapNode endTile = getEndTile(world, followerId);
+                    REQUIRE(std::abs(endTile.x - 2) <= 2 * MapUtils::eastWestTileSpan);
+                    REQUIRE(std::abs(endTile.y - 6) <= 2);
+                }
+            }
+        }
+    }
+}
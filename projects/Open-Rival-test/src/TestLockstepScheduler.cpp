@@ -0,0 +1,145 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <optional>
+#include <stdexcept>
+
+#include "net/packets/GameCommandPacket.h"
+#include "LockstepScheduler.h"
+#include "TimeUtils.h"
+
+using namespace Rival;
+
+SCENARIO("LockstepScheduler waits for every client before a tick can run", "[lockstep-scheduler]")
+{
+    LockstepScheduler scheduler;
+    scheduler.addClient(1);
+    scheduler.addClient(2);
+
+    const int firstTick = TimeUtils::netCommandDelay;
+
+    GIVEN("No commands have been received yet")
+    {
+        THEN("the ticks before the initial command delay are ready")
+        {
+            REQUIRE(scheduler.isCurrentTickReady());
+        }
+
+        AND_THEN("the first tick after the command delay is waiting for every client")
+        {
+            REQUIRE_FALSE(scheduler.isTickConfirmed(firstTick));
+            REQUIRE(scheduler.getMissingClients(firstTick) == ((1u << 1) | (1u << 2)));
+        }
+    }
+
+    GIVEN("One client has covered a range of ticks")
+    {
+        scheduler.onClientReady(firstTick, firstTick + 2, 1);
+
+        THEN("those ticks are only waiting for the other client")
+        {
+            REQUIRE_FALSE(scheduler.isTickConfirmed(firstTick));
+            REQUIRE(scheduler.getMissingClients(firstTick + 2) == (1u << 2));
+        }
+
+        WHEN("the other client covers the first tick")
+        {
+            scheduler.onClientReady(firstTick, firstTick, 2);
+
+            THEN("the first tick is confirmed but the next one is not")
+            {
+                REQUIRE(scheduler.isTickConfirmed(firstTick));
+                REQUIRE_FALSE(scheduler.isTickConfirmed(firstTick + 1));
+            }
+        }
+
+        WHEN("the same client covers one of those ticks again")
+        {
+            THEN("it is rejected")
+            {
+                REQUIRE_THROWS_AS(scheduler.onClientReady(firstTick + 2, firstTick + 3, 1), std::runtime_error);
+            }
+        }
+    }
+
+    GIVEN("Some packets received from another client")
+    {
+        THEN("each tick is resolved relative to the previous packet from that client")
+        {
+            const int tick = scheduler.resolveReceivedTick(1, firstTick - GameCommandPacket::initialPreviousTick);
+            REQUIRE(tick == firstTick);
+            REQUIRE(scheduler.resolveReceivedTick(1, 5) == firstTick + 5);
+            REQUIRE(scheduler.resolveReceivedTick(2, 3) == GameCommandPacket::initialPreviousTick + 3);
+        }
+    }
+
+    GIVEN("A tick outside the scheduling window")
+    {
+        THEN("it cannot be scheduled")
+        {
+            REQUIRE_THROWS_AS(scheduler.getScheduledTick(-1), std::runtime_error);
+            REQUIRE_THROWS_AS(scheduler.getScheduledTick(LockstepScheduler::maxScheduledTicks), std::runtime_error);
+        }
+    }
+}
+
+SCENARIO("LockstepScheduler decides which tick to send our commands for", "[lockstep-scheduler]")
+{
+    LockstepScheduler scheduler;
+    const int commandDelay = TimeUtils::netCommandDelay;
+
+    GIVEN("A client that stays idle")
+    {
+        const std::optional<SendTick> firstSend = scheduler.takeSendTick(commandDelay, false);
+        scheduler.advanceTick();
+        const std::optional<SendTick> secondSend = scheduler.takeSendTick(commandDelay, false);
+
+        THEN("the first packet covers only the tick after the command delay")
+        {
+            REQUIRE(firstSend);
+            REQUIRE(firstSend->tick == commandDelay);
+            REQUIRE(firstSend->previousTick == GameCommandPacket::initialPreviousTick);
+        }
+
+        AND_THEN("the next packet promises to stay idle for the longest range")
+        {
+            REQUIRE(secondSend);
+            REQUIRE(secondSend->tick == 1 + commandDelay + LockstepScheduler::maxIdleRangeTicks - 1);
+            REQUIRE(secondSend->previousTick == firstSend->tick);
+        }
+
+        AND_WHEN("a command is issued within the promised range")
+        {
+            scheduler.advanceTick();
+
+            THEN("it has to wait until the end of the range")
+            {
+                REQUIRE_FALSE(scheduler.takeSendTick(commandDelay, true));
+
+                while (scheduler.getCurrentTick() + commandDelay <= secondSend->tick)
+                {
+                    scheduler.advanceTick();
+                }
+                const std::optional<SendTick> commandSend = scheduler.takeSendTick(commandDelay, true);
+                REQUIRE(commandSend);
+                REQUIRE(commandSend->tick == secondSend->tick + 1);
+            }
+        }
+    }
+
+    GIVEN("A client with idle ranges disabled")
+    {
+        scheduler.setIdleRangesEnabled(false);
+
+        THEN("a packet is sent for every tick")
+        {
+            for (int tick = 0; tick < LockstepScheduler::maxIdleRangeTicks; ++tick)
+            {
+                const std::optional<SendTick> sendTick = scheduler.takeSendTick(commandDelay, false);
+                REQUIRE(sendTick);
+                REQUIRE(sendTick->tick == tick + commandDelay);
+                scheduler.advanceTick();
+            }
+        }
+    }
+}
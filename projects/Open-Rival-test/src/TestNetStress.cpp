@@ -0,0 +1,957 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <functional>  // std::ref
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "net/Connection.h"
+#include "net/LoopbackLink.h"
+#include "net/NetUtils.h"
+#include "net/PacketFactory.h"
+#include "net/ReliableChannel.h"
+#include "net/Server.h"
+#include "net/Socket.h"
+#include "net/packets/GameCommandPacket.h"
+#include "net/packets/JoinRoomPacket.h"
+#include "net/packets/PingPacket.h"
+#include "GameCommand.h"
+#include "LockstepScheduler.h"
+#include "MapUtils.h"
+#include "MoveCommand.h"
+#include "TimeUtils.h"
+
+/*
+ * Loopback stress harness for the multiplayer code.
+ *
+ * This runs a relay server and a number of headless clients in a single process. The clients play a lockstep game
+ * at 60 ticks per second, exchanging GameCommandPackets through the relay using real sockets, real Connections and
+ * the real packet serialization. Each client talks to the relay over UDP, through an emulated link that adds latency,
+ * jitter, a bandwidth cap and packet loss in both directions.
+ *
+ * The same clients can also play through a relay with no sockets at all, connected by LoopbackLinks, with the relay
+ * and every client stepped in turn on a single thread. This plays out identically every time, so it can check the
+ * lockstep logic itself independently of any timing.
+ *
+ * The quick scenarios run as part of the normal test suite. The heavier profiles are hidden, and can be run with:
+ *
+ *     Open-Rival-test.exe [net-stress]
+ *
+ * Each run prints the relay throughput, the time clients spent stalled waiting for commands, and the end-to-end
+ * latency of commands.
+ */
+
+using namespace Rival;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** Port used by the relay server. Emulated links listen on the ports that follow. */
+static constexpr std::uint16_t relayPort = 25420;
+
+/** Maximum time that a client will wait for commands before giving up. */
+static constexpr std::uint32_t maxStallMs = 10000;
+
+/**
+ * Initializes networking for the lifetime of a test.
+ */
+class NetworkingScope
+{
+public:
+    NetworkingScope()
+    {
+        NetUtils::initNetworking();
+    }
+
+    ~NetworkingScope()
+    {
+        NetUtils::destroyNetworking();
+    }
+};
+
+/**
+ * Network conditions imposed by an EmulatedLink, in each direction.
+ */
+struct LinkConditions
+{
+    std::uint32_t latencyMs = 0;
+
+    /** Maximum random delay added on top of the latency. Datagrams may be reordered as a result. */
+    std::uint32_t jitterMs = 0;
+
+    /** Maximum throughput, or zero for no limit. */
+    std::uint32_t bandwidthBytesPerSecond = 0;
+
+    /** Chance of each datagram being lost. */
+    float lossChance = 0.f;
+};
+
+struct NetStressConfig
+{
+    int numClients = 4;
+    int numTicks = 10 * TimeUtils::fps;
+    LinkConditions link;
+
+    /** Chance of each client issuing a command each tick. */
+    float commandChance = 0.1f;
+
+    /** Whether idle clients cover several ticks with a single packet, instead of sending an empty one every tick. */
+    bool elideIdleTicks = true;
+
+    unsigned int seed = 1234;
+};
+
+/**
+ * Forwards datagrams between a single client and the relay server, imposing some LinkConditions.
+ *
+ * The client sends to the port on which this link listens, instead of sending directly to the relay.
+ */
+class EmulatedLink
+{
+public:
+    EmulatedLink(std::uint16_t listenPort, const LinkConditions& conditions, unsigned int seed)
+        : clientSide(Socket::createUdpServer(listenPort))
+        , relaySide(Socket::createUdpClient("localhost", relayPort))
+        , conditions(conditions)
+        , random(seed)
+    {
+        relaySide.setNonBlocking();
+        thread = std::thread(&EmulatedLink::run, this);
+    }
+
+    ~EmulatedLink()
+    {
+        running = false;
+        thread.join();
+    }
+
+private:
+    /** Datagrams travelling in one direction. */
+    struct Direction
+    {
+        /** Datagrams that have been sent but not yet delivered, by delivery time. */
+        std::multimap<Clock::time_point, std::vector<char>> inFlight;
+
+        /** Time at which the link will have finished transmitting everything sent so far. */
+        Clock::time_point linkFreeTime;
+    };
+
+    void run()
+    {
+        std::vector<char> buffer(ReliableChannel::maxDatagramSize);
+
+        while (running)
+        {
+            const Clock::time_point now = Clock::now();
+
+            SocketAddress address;
+            int size = 0;
+            while ((size = clientSide.tryReceiveFrom(buffer.data(), buffer.size(), address)) > 0)
+            {
+                clientAddress = address;
+                hasClientAddress = true;
+                send(upstream, buffer.data(), static_cast<std::size_t>(size), now);
+            }
+
+            while ((size = relaySide.tryReceive(buffer.data(), buffer.size())) > 0)
+            {
+                send(downstream, buffer.data(), static_cast<std::size_t>(size), now);
+            }
+
+            for (auto iter = upstream.inFlight.begin(); iter != upstream.inFlight.end() && iter->first <= now;)
+            {
+                relaySide.trySend(iter->second.data(), iter->second.size());
+                iter = upstream.inFlight.erase(iter);
+            }
+
+            // Nothing can come back from the relay until the client has sent something, so we know where to send it
+            for (auto iter = downstream.inFlight.begin(); iter != downstream.inFlight.end() && iter->first <= now;)
+            {
+                if (hasClientAddress)
+                {
+                    clientSide.trySendTo(iter->second.data(), iter->second.size(), clientAddress);
+                }
+                iter = downstream.inFlight.erase(iter);
+            }
+
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+
+    void send(Direction& direction, const char* data, std::size_t size, Clock::time_point now)
+    {
+        if (lossDistribution(random) < conditions.lossChance)
+        {
+            return;
+        }
+
+        Clock::time_point sendTime = now;
+        if (conditions.bandwidthBytesPerSecond > 0)
+        {
+            // The link can only transmit one datagram at a time, so anything beyond its capacity is queued
+            const auto transmitTime = std::chrono::microseconds(size * 1000000 / conditions.bandwidthBytesPerSecond);
+            direction.linkFreeTime = std::max(now, direction.linkFreeTime) + transmitTime;
+            sendTime = direction.linkFreeTime;
+        }
+
+        std::uniform_int_distribution<std::uint32_t> jitterDistribution(0, conditions.jitterMs);
+        const auto delay = std::chrono::milliseconds(conditions.latencyMs + jitterDistribution(random));
+        direction.inFlight.emplace(sendTime + delay, std::vector<char>(data, data + size));
+    }
+
+private:
+    Socket clientSide;
+    Socket relaySide;
+    SocketAddress clientAddress;
+    bool hasClientAddress = false;
+
+    LinkConditions conditions;
+    std::mt19937 random;
+    std::uniform_real_distribution<float> lossDistribution { 0.f, 1.f };
+
+    Direction upstream;
+    Direction downstream;
+
+    std::atomic<bool> running = true;
+    std::thread thread;
+};
+
+/**
+ * Time at which each client sent its commands for each tick.
+ *
+ * Since every client shares the same clock, this lets the recipient work out how long the commands took to arrive.
+ */
+class SendLog
+{
+public:
+    SendLog(int numClients, int numTicks)
+        : numTicks(numTicks)
+        , sendTimes(static_cast<std::size_t>(numClients * numTicks))
+    {
+    }
+
+    void record(int clientId, int tick, std::uint32_t time)
+    {
+        if (tick < numTicks)
+        {
+            sendTimes[getIndex(clientId, tick)].store(time, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint32_t get(int clientId, int tick) const
+    {
+        return sendTimes[getIndex(clientId, tick)].load(std::memory_order_relaxed);
+    }
+
+private:
+    std::size_t getIndex(int clientId, int tick) const
+    {
+        return static_cast<std::size_t>(clientId * numTicks + tick);
+    }
+
+    int numTicks;
+    std::vector<std::atomic<std::uint32_t>> sendTimes;
+};
+
+struct ClientResults
+{
+    int ticksCompleted = 0;
+
+    /** Time spent waiting for commands before each tick could go ahead. */
+    std::vector<std::uint32_t> stallTimesMs;
+
+    /** Time taken for each set of commands to arrive from another client. */
+    std::vector<std::uint32_t> latenciesMs;
+
+    /** Checksum of every command executed, in tick order; this should be the same for every client. */
+    std::uint32_t checksum = 0;
+
+    /** Number of GameCommandPackets sent during the game. */
+    int commandPacketsSent = 0;
+};
+
+/**
+ * A client that plays a lockstep game without a World, renderer or any player input.
+ *
+ * This uses the same LockstepScheduler as GameState: every tick, each client sends its commands for a tick in the
+ * future, and no client can simulate a tick until it has received the commands for that tick from every other client.
+ * Commands are issued at random, and "executing" them just means adding them to a checksum.
+ */
+class HeadlessClient
+{
+public:
+    HeadlessClient(int clientId,
+                   std::uint16_t port,
+                   std::shared_ptr<PacketFactory> packetFactory,
+                   const NetStressConfig& config,
+                   SendLog& sendLog)
+        : clientId(clientId)
+        , connection(Socket::createUdpClient("localhost", port), packetFactory, Transport::Udp)
+        , config(config)
+        , sendLog(sendLog)
+        , random(config.seed + static_cast<unsigned int>(clientId))
+    {
+        initScheduler();
+    }
+
+    /** Creates a client that connects to a relay in the same process, without using any sockets. */
+    HeadlessClient(int clientId,
+                   std::shared_ptr<LoopbackLink> link,
+                   std::shared_ptr<PacketFactory> packetFactory,
+                   const NetStressConfig& config,
+                   SendLog& sendLog)
+        : clientId(clientId)
+        , connection(link, packetFactory)
+        , config(config)
+        , sendLog(sendLog)
+        , random(config.seed + static_cast<unsigned int>(clientId))
+    {
+        initScheduler();
+    }
+
+    /**
+     * Joins the relay server's default room, waiting until the relay has processed the request.
+     *
+     * Clients must join one at a time, so that their client IDs match the order in which they were created.
+     */
+    void join()
+    {
+        connection.send(JoinRoomPacket(Server::defaultRoomId));
+
+        // The relay handles packets in order, so once it returns our ping we know that we have joined
+        connection.send(PingPacket(TimeUtils::getNetTimestamp()));
+
+        const Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(maxStallMs);
+        while (Clock::now() < deadline)
+        {
+            connection.flush();
+            connection.getReceivedPackets(receivedPackets);
+            for (const auto& packet : receivedPackets)
+            {
+                if (packet->getType() == PacketType::Ping)
+                {
+                    return;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        throw std::runtime_error("Timed out joining the relay server");
+    }
+
+    /** Asks to join the relay server's default room, without waiting for the relay to process the request. */
+    void requestJoin()
+    {
+        connection.send(JoinRoomPacket(Server::defaultRoomId));
+        connection.flush();
+    }
+
+    /**
+     * Runs the current tick if the commands for it have arrived, without ever waiting.
+     *
+     * Returns true once the game has finished.
+     */
+    bool step()
+    {
+        if (scheduler.getCurrentTick() < config.numTicks)
+        {
+            pollNetwork();
+            if (isTickReady())
+            {
+                runTick();
+            }
+        }
+
+        return scheduler.getCurrentTick() == config.numTicks;
+    }
+
+    /** Plays the game to the end, then keeps the connection going until every client has finished. */
+    void run(std::atomic<int>& numClientsFinished)
+    {
+        const auto tickInterval = std::chrono::microseconds(1000000 / TimeUtils::fps);
+        Clock::time_point nextTickTime = Clock::now();
+
+        while (scheduler.getCurrentTick() < config.numTicks)
+        {
+            std::this_thread::sleep_until(nextTickTime);
+
+            if (!waitForTick())
+            {
+                break;
+            }
+
+            runTick();
+
+            // If we have fallen behind, the next ticks run straight away until we catch up, just like the game
+            nextTickTime += tickInterval;
+        }
+
+        ++numClientsFinished;
+
+        // Other clients may still need to hear from us, or receive our acknowledgements
+        while (numClientsFinished < config.numClients)
+        {
+            pollNetwork();
+            connection.flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(TimeUtils::timeStepMs));
+        }
+    }
+
+    const ClientResults& getResults() const
+    {
+        return results;
+    }
+
+private:
+    /** Expects commands from every other client, which will have joined the relay in order of client ID. */
+    void initScheduler()
+    {
+        for (int otherClientId = 0; otherClientId < config.numClients; ++otherClientId)
+        {
+            if (otherClientId != clientId)
+            {
+                scheduler.addClient(otherClientId);
+            }
+        }
+        scheduler.setIdleRangesEnabled(config.elideIdleTicks);
+    }
+
+    void runTick()
+    {
+        sendCommands();
+        executeTick();
+        connection.flush();
+
+        scheduler.advanceTick();
+        ++results.ticksCompleted;
+    }
+
+    /**
+     * Waits until we have received the commands for the current tick from every other client.
+     *
+     * Returns false if they never arrive.
+     */
+    bool waitForTick()
+    {
+        pollNetwork();
+        if (isTickReady())
+        {
+            results.stallTimesMs.push_back(0);
+            return true;
+        }
+
+        const std::uint32_t stallStartTime = TimeUtils::getNetTimestamp();
+        std::uint32_t lastFlushTime = stallStartTime;
+        std::uint32_t stallTime = 0;
+        while (!isTickReady())
+        {
+            if (stallTime > maxStallMs)
+            {
+                return false;
+            }
+
+            // Like the game, keep flushing once per frame while stalled so that acknowledgements and resends still go
+            // out. Flushing any more often than this would flood the link with repeated data.
+            const std::uint32_t now = TimeUtils::getNetTimestamp();
+            if (now - lastFlushTime >= static_cast<std::uint32_t>(TimeUtils::timeStepMs))
+            {
+                connection.flush();
+                lastFlushTime = now;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            pollNetwork();
+            stallTime = TimeUtils::getNetTimestamp() - stallStartTime;
+        }
+
+        results.stallTimesMs.push_back(stallTime);
+        return true;
+    }
+
+    bool isTickReady()
+    {
+        return scheduler.isCurrentTickReady();
+    }
+
+    void pollNetwork()
+    {
+        connection.getReceivedPackets(receivedPackets);
+        for (const auto& packet : receivedPackets)
+        {
+            if (packet->getType() != PacketType::GameCommand)
+            {
+                continue;
+            }
+
+            const auto& commandPacket = static_cast<const GameCommandPacket&>(*packet);
+            const int senderId = commandPacket.getClientId();
+
+            const int tickDelta = commandPacket.getTickDelta();
+            const int tick = scheduler.resolveReceivedTick(senderId, tickDelta);
+
+            // The sender has no commands for any of the ticks since its previous packet
+            scheduler.onClientReady(tick - tickDelta + 1, tick, senderId);
+
+            for (const auto& command : commandPacket.getCommands())
+            {
+                scheduler.scheduleCommand(command, tick);
+            }
+
+            if (tick < config.numTicks && senderId >= 0 && senderId < config.numClients)
+            {
+                results.latenciesMs.push_back(packet->getReceiveTime() - sendLog.get(senderId, tick));
+            }
+        }
+        receivedPackets.clear();
+    }
+
+    void sendCommands()
+    {
+        if (commandDistribution(random) < config.commandChance)
+        {
+            std::uniform_int_distribution<int> valueDistribution(0, 255);
+            const MapNode destination { valueDistribution(random), valueDistribution(random) };
+            outgoingCommands.push_back(std::make_shared<MoveCommand>(valueDistribution(random), destination));
+        }
+
+        const std::optional<SendTick> sendTick =
+                scheduler.takeSendTick(TimeUtils::netCommandDelay, !outgoingCommands.empty());
+        if (!sendTick)
+        {
+            // We have promised to be idle, so any commands have to wait
+            return;
+        }
+
+        for (const auto& command : outgoingCommands)
+        {
+            scheduler.scheduleCommand(command, sendTick->tick);
+        }
+
+        sendLog.record(clientId, sendTick->tick, TimeUtils::getNetTimestamp());
+        connection.send(GameCommandPacket(outgoingCommands, sendTick->tick, sendTick->previousTick));
+        ++results.commandPacketsSent;
+        outgoingCommands.clear();
+    }
+
+    void executeTick()
+    {
+        ScheduledTick& scheduledTick = scheduler.getScheduledTick(scheduler.getCurrentTick());
+
+        // Sum the hashes of all commands for this tick, so that the order in which they arrived is irrelevant
+        std::uint32_t commandsHash = 0;
+        for (const auto& command : scheduledTick.commands)
+        {
+            commandsHash += hashCommand(*command);
+        }
+        results.checksum = results.checksum * 31 + commandsHash;
+
+        scheduledTick.commands.clear();
+        scheduledTick.clientsReady = 0;
+    }
+
+    static std::uint32_t hashCommand(const GameCommand& command)
+    {
+        std::vector<char> buffer;
+        buffer.reserve(Connection::maxBufferSize);
+        command.serialize(buffer);
+
+        // FNV-1a
+        std::uint32_t hash = 2166136261u;
+        for (char c : buffer)
+        {
+            hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
+        }
+        return hash;
+    }
+
+private:
+    int clientId;
+    Connection connection;
+    const NetStressConfig& config;
+    SendLog& sendLog;
+
+    std::mt19937 random;
+    std::uniform_real_distribution<float> commandDistribution { 0.f, 1.f };
+
+    LockstepScheduler scheduler;
+    std::vector<std::shared_ptr<GameCommand>> outgoingCommands;
+    std::vector<std::shared_ptr<const Packet>> receivedPackets;
+
+    ClientResults results;
+};
+
+struct NetStressResults
+{
+    std::vector<ClientResults> clients;
+
+    /** Average relay throughput while the game was running. */
+    RoomMetrics relayMetrics;
+};
+
+/** Gets the value below which the given proportion of the values fall. */
+std::uint32_t getPercentile(std::vector<std::uint32_t> values, float percentile)
+{
+    if (values.empty())
+    {
+        return 0;
+    }
+
+    const auto index = static_cast<std::size_t>(percentile * static_cast<float>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+/** Runs a relay server and a game between headless clients, returning once every client has finished. */
+NetStressResults runNetStressTest(const NetStressConfig& config)
+{
+    Server server(relayPort, config.numClients);
+    server.start();
+
+    auto packetFactory = std::make_shared<PacketFactory>();
+    SendLog sendLog(config.numClients, config.numTicks);
+
+    std::vector<std::unique_ptr<EmulatedLink>> links;
+    std::vector<std::unique_ptr<HeadlessClient>> clients;
+    for (int i = 0; i < config.numClients; ++i)
+    {
+        const auto linkPort = static_cast<std::uint16_t>(relayPort + 1 + i);
+        const unsigned int linkSeed = config.seed + 1000u * static_cast<unsigned int>(i + 1);
+        links.push_back(std::make_unique<EmulatedLink>(linkPort, config.link, linkSeed));
+        clients.push_back(std::make_unique<HeadlessClient>(i, linkPort, packetFactory, config, sendLog));
+        clients.back()->join();
+    }
+
+    std::atomic<int> numClientsFinished = 0;
+    std::vector<std::thread> threads;
+    for (auto& client : clients)
+    {
+        threads.emplace_back(&HeadlessClient::run, client.get(), std::ref(numClientsFinished));
+    }
+
+    // Sample the relay throughput while the game is running
+    NetStressResults results;
+    int numSamples = 0;
+    while (numClientsFinished < config.numClients)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        for (const RoomMetrics& metrics : *server.getRoomMetrics())
+        {
+            if (metrics.numClients == config.numClients)
+            {
+                results.relayMetrics.packetsInPerSecond += metrics.packetsInPerSecond;
+                results.relayMetrics.packetsOutPerSecond += metrics.packetsOutPerSecond;
+                results.relayMetrics.bytesInPerSecond += metrics.bytesInPerSecond;
+                results.relayMetrics.bytesOutPerSecond += metrics.bytesOutPerSecond;
+                ++numSamples;
+            }
+        }
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (numSamples > 0)
+    {
+        results.relayMetrics.packetsInPerSecond /= static_cast<float>(numSamples);
+        results.relayMetrics.packetsOutPerSecond /= static_cast<float>(numSamples);
+        results.relayMetrics.bytesInPerSecond /= static_cast<float>(numSamples);
+        results.relayMetrics.bytesOutPerSecond /= static_cast<float>(numSamples);
+    }
+
+    for (const auto& client : clients)
+    {
+        results.clients.push_back(client->getResults());
+    }
+
+    return results;
+}
+
+/**
+ * Plays a game between headless clients connected to an in-process relay by LoopbackLinks, all on a single thread.
+ *
+ * The relay is stepped in between the clients, so no sockets or timing are involved, and every run of the same config
+ * plays out in exactly the same way.
+ */
+NetStressResults runLoopbackGame(const NetStressConfig& config)
+{
+    Server server(std::nullopt, config.numClients);
+
+    auto packetFactory = std::make_shared<PacketFactory>();
+    SendLog sendLog(config.numClients, config.numTicks);
+
+    std::vector<std::unique_ptr<HeadlessClient>> clients;
+    for (int i = 0; i < config.numClients; ++i)
+    {
+        clients.push_back(
+                std::make_unique<HeadlessClient>(i, server.connectLoopback(), packetFactory, config, sendLog));
+        clients.back()->requestJoin();
+
+        // Let the relay handle each client before the next one, so that client IDs match the order of creation
+        server.poll(0);
+    }
+
+    // Every client should complete a tick each round; this just stops a broken game from running forever
+    const int maxRounds = 2 * config.numTicks;
+
+    int numClientsFinished = 0;
+    for (int round = 0; round < maxRounds && numClientsFinished < config.numClients; ++round)
+    {
+        numClientsFinished = 0;
+        for (auto& client : clients)
+        {
+            if (client->step())
+            {
+                ++numClientsFinished;
+            }
+        }
+
+        // Pass on everything the clients sent this round
+        server.poll(0);
+    }
+
+    NetStressResults results;
+    for (const auto& client : clients)
+    {
+        results.clients.push_back(client->getResults());
+    }
+    return results;
+}
+
+int getTotalCommandPacketsSent(const NetStressResults& results)
+{
+    int total = 0;
+    for (const ClientResults& client : results.clients)
+    {
+        total += client.commandPacketsSent;
+    }
+    return total;
+}
+
+void printReport(const NetStressConfig& config, const NetStressResults& results)
+{
+    std::vector<std::uint32_t> stallTimes;
+    std::vector<std::uint32_t> latencies;
+    std::size_t numStalledTicks = 0;
+    for (const ClientResults& client : results.clients)
+    {
+        stallTimes.insert(stallTimes.cend(), client.stallTimesMs.cbegin(), client.stallTimesMs.cend());
+        latencies.insert(latencies.cend(), client.latenciesMs.cbegin(), client.latenciesMs.cend());
+        numStalledTicks += static_cast<std::size_t>(std::count_if(
+                client.stallTimesMs.cbegin(), client.stallTimesMs.cend(), [](std::uint32_t t) { return t > 0; }));
+    }
+
+    std::uint64_t totalStallMs = 0;
+    for (std::uint32_t stallTime : stallTimes)
+    {
+        totalStallMs += stallTime;
+    }
+
+    std::cout << "Net stress test: " << config.numClients << " clients, " << config.numTicks << " ticks, "
+              << config.link.latencyMs << "ms latency, " << config.link.jitterMs << "ms jitter, "
+              << config.link.lossChance * 100.f << "% loss, bandwidth cap: " << config.link.bandwidthBytesPerSecond
+              << " bytes/s\n";
+    std::cout << "  Relay throughput: " << results.relayMetrics.packetsInPerSecond << " packets/s ("
+              << results.relayMetrics.bytesInPerSecond << " bytes/s) in, "
+              << results.relayMetrics.packetsOutPerSecond << " packets/s ("
+              << results.relayMetrics.bytesOutPerSecond << " bytes/s) out\n";
+    std::cout << "  Stalls: " << numStalledTicks << " of " << stallTimes.size() << " ticks, " << totalStallMs
+              << "ms in total; p50 " << getPercentile(stallTimes, 0.5f) << "ms, p99 "
+              << getPercentile(stallTimes, 0.99f) << "ms, max " << getPercentile(stallTimes, 1.f) << "ms\n";
+    std::cout << "  Command latency: p50 " << getPercentile(latencies, 0.5f) << "ms, p95 "
+              << getPercentile(latencies, 0.95f) << "ms, p99 " << getPercentile(latencies, 0.99f) << "ms, max "
+              << getPercentile(latencies, 1.f) << "ms\n";
+    std::cout << "  Command packets sent: " << getTotalCommandPacketsSent(results) << " over " << config.numTicks
+              << " ticks (idle tick elision " << (config.elideIdleTicks ? "on" : "off") << ")\n";
+}
+
+void requireGameCompleted(const NetStressConfig& config, const NetStressResults& results)
+{
+    REQUIRE(results.clients.size() == static_cast<std::size_t>(config.numClients));
+    for (const ClientResults& client : results.clients)
+    {
+        REQUIRE(client.ticksCompleted == config.numTicks);
+        REQUIRE(client.checksum == results.clients[0].checksum);
+    }
+}
+
+}  // namespace
+
+SCENARIO("Headless clients can play a lockstep game through the relay over a lossy link", "[net][net-stress]")
+{
+    NetworkingScope networkingScope;
+
+    GIVEN("A few clients with some latency, jitter and packet loss")
+    {
+        NetStressConfig config;
+        config.numClients = 3;
+        config.numTicks = TimeUtils::fps;
+        config.link.latencyMs = 10;
+        config.link.jitterMs = 5;
+        config.link.lossChance = 0.05f;
+        config.commandChance = 0.5f;
+
+        WHEN("they play a short game")
+        {
+            const NetStressResults results = runNetStressTest(config);
+
+            THEN("every client executes the same commands on the same ticks")
+            {
+                requireGameCompleted(config, results);
+            }
+        }
+    }
+}
+
+SCENARIO("Idle clients cover several ticks with each GameCommandPacket", "[net][net-stress]")
+{
+    NetworkingScope networkingScope;
+
+    GIVEN("A few clients that never issue any commands")
+    {
+        NetStressConfig config;
+        config.numClients = 3;
+        config.numTicks = TimeUtils::fps;
+        config.link.latencyMs = 5;
+        config.commandChance = 0.f;
+
+        WHEN("they play a short game with and without idle tick elision")
+        {
+            const NetStressResults elidedResults = runNetStressTest(config);
+
+            config.elideIdleTicks = false;
+            const NetStressResults fullResults = runNetStressTest(config);
+
+            THEN("both games complete, but far fewer packets are sent when idle ticks are elided")
+            {
+                requireGameCompleted(config, elidedResults);
+                requireGameCompleted(config, fullResults);
+                REQUIRE(getTotalCommandPacketsSent(fullResults) == config.numClients * config.numTicks);
+                REQUIRE(getTotalCommandPacketsSent(elidedResults) * 4 < getTotalCommandPacketsSent(fullResults));
+            }
+        }
+    }
+}
+
+SCENARIO("Headless clients play the same game every time through a relay without sockets", "[net][net-stress]")
+{
+    GIVEN("A game between several clients connected to the relay by loopback links")
+    {
+        NetStressConfig config;
+        config.numClients = 8;
+        config.numTicks = 10 * TimeUtils::fps;
+
+        WHEN("the game is played")
+        {
+            const NetStressResults results = runLoopbackGame(config);
+
+            THEN("every client completes every tick with the same result")
+            {
+                requireGameCompleted(config, results);
+            }
+
+            AND_WHEN("the same game is played again")
+            {
+                const NetStressResults replayedResults = runLoopbackGame(config);
+
+                THEN("it plays out in exactly the same way")
+                {
+                    REQUIRE(replayedResults.clients.size() == results.clients.size());
+                    for (std::size_t i = 0; i < results.clients.size(); ++i)
+                    {
+                        REQUIRE(replayedResults.clients[i].checksum == results.clients[i].checksum);
+                        REQUIRE(replayedResults.clients[i].commandPacketsSent == results.clients[i].commandPacketsSent);
+                    }
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Stress test: a full game on a fast local network", "[.][net-stress]")
+{
+    NetworkingScope networkingScope;
+
+    GIVEN("8 clients on a fast local network")
+    {
+        NetStressConfig config;
+        config.numClients = 8;
+        config.link.latencyMs = 1;
+
+        WHEN("they play a full game")
+        {
+            const NetStressResults results = runNetStressTest(config);
+            printReport(config, results);
+
+            THEN("every client executes the same commands on the same ticks")
+            {
+                requireGameCompleted(config, results);
+            }
+        }
+    }
+}
+
+SCENARIO("Stress test: a full game over a typical internet connection", "[.][net-stress]")
+{
+    NetworkingScope networkingScope;
+
+    GIVEN("8 clients with moderate latency and jitter, and some packet loss")
+    {
+        NetStressConfig config;
+        config.numClients = 8;
+        config.link.latencyMs = 40;
+        config.link.jitterMs = 15;
+        config.link.lossChance = 0.02f;
+
+        WHEN("they play a full game")
+        {
+            const NetStressResults results = runNetStressTest(config);
+            printReport(config, results);
+
+            THEN("every client executes the same commands on the same ticks")
+            {
+                requireGameCompleted(config, results);
+            }
+        }
+    }
+}
+
+SCENARIO("Stress test: a full game over a poor connection", "[.][net-stress]")
+{
+    NetworkingScope networkingScope;
+
+    GIVEN("4 clients with high latency and jitter, limited bandwidth and heavy packet loss")
+    {
+        NetStressConfig config;
+        config.numClients = 4;
+        config.link.latencyMs = 120;
+        config.link.jitterMs = 60;
+        config.link.lossChance = 0.1f;
+        config.link.bandwidthBytesPerSecond = 16 * 1024;
+
+        WHEN("they play a full game")
+        {
+            const NetStressResults results = runNetStressTest(config);
+            printReport(config, results);
+
+            THEN("every client executes the same commands on the same ticks")
+            {
+                requireGameCompleted(config, results);
+            }
+        }
+    }
+}
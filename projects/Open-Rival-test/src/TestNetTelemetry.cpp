@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include "net/Connection.h"
+#include "net/NetTelemetry.h"
+
+using namespace Rival;
+
+SCENARIO("NetTelemetry calculates rates from the connection totals", "[net]")
+{
+    GIVEN("A NetTelemetry that has already collected some metrics")
+    {
+        NetTelemetry telemetry;
+
+        ConnectionStats stats;
+        stats.packetsSent = 100;
+        stats.bytesSent = 1000;
+        stats.packetsReceived = 200;
+        stats.bytesReceived = 4000;
+        telemetry.collectMetrics(1000, stats);
+
+        WHEN("more traffic passes through the connection")
+        {
+            stats.packetsSent += 60;
+            stats.bytesSent += 600;
+            stats.packetsReceived += 120;
+            stats.bytesReceived += 2400;
+            stats.receiveQueueDepth = 3;
+            stats.maxReceiveQueueDepth = 7;
+            stats.sendQueueDepth = 1;
+            stats.maxSendQueueDepth = 4;
+
+            const NetMetrics metrics = telemetry.collectMetrics(2000, stats);
+
+            THEN("the rates only include the traffic since the last collection")
+            {
+                REQUIRE(metrics.packetsOutPerSecond == 30.f);
+                REQUIRE(metrics.bytesOutPerSecond == 300.f);
+                REQUIRE(metrics.packetsInPerSecond == 60.f);
+                REQUIRE(metrics.bytesInPerSecond == 1200.f);
+            }
+
+            THEN("the queue depths are passed through")
+            {
+                REQUIRE(metrics.receiveQueueDepth == 3);
+                REQUIRE(metrics.maxReceiveQueueDepth == 7);
+                REQUIRE(metrics.sendQueueDepth == 1);
+                REQUIRE(metrics.maxSendQueueDepth == 4);
+            }
+        }
+    }
+}
+
+SCENARIO("NetTelemetry tracks which client the game is waiting for", "[net]")
+{
+    GIVEN("A NetTelemetry")
+    {
+        NetTelemetry telemetry;
+
+        WHEN("some updates are spent waiting for different clients")
+        {
+            telemetry.addStalledUpdate(0b0010);
+            telemetry.addStalledUpdate(0b0110);
+            telemetry.addStalledUpdate(0b0100);
+            telemetry.addStalledUpdate(0b0100);
+
+            const NetMetrics metrics = telemetry.collectMetrics(1000, ConnectionStats());
+
+            THEN("every stalled update is counted once")
+            {
+                REQUIRE(metrics.stalledUpdates == 4);
+            }
+
+            THEN("the client that held up the game the most is reported")
+            {
+                REQUIRE(metrics.worstClientId == 2);
+                REQUIRE(metrics.worstClientStalledUpdates == 3);
+            }
+
+            AND_WHEN("the metrics are collected again")
+            {
+                const NetMetrics nextMetrics = telemetry.collectMetrics(1000, ConnectionStats());
+
+                THEN("the stalls have been reset")
+                {
+                    REQUIRE(nextMetrics.stalledUpdates == 0);
+                    REQUIRE(nextMetrics.worstClientId == -1);
+                }
+            }
+        }
+
+        WHEN("some round-trip times are measured")
+        {
+            telemetry.addRttSample(80);
+            telemetry.addRttSample(150);
+            telemetry.addRttSample(90);
+
+            const NetMetrics metrics = telemetry.collectMetrics(1000, ConnectionStats());
+
+            THEN("the latest and highest measurements are reported")
+            {
+                REQUIRE(metrics.lastRttSampleMs == 90);
+                REQUIRE(metrics.maxRttSampleMs == 150);
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <cstddef>  // std::max_align_t
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "utils/ObjectPool.h"
+
+using namespace Rival;
+
+namespace {
+
+struct PooledValue
+{
+    std::int64_t value;
+};
+
+class PooledBuffer
+{
+public:
+    std::vector<int> values;
+    int numResets = 0;
+
+    void reset()
+    {
+        values.clear();
+        ++numResets;
+    }
+};
+
+}  // namespace
+
+SCENARIO("A FixedBlockPool hands out aligned blocks and reuses them", "[utils][object-pool]")
+{
+    GIVEN("A pool of small blocks")
+    {
+        FixedBlockPool pool(3);
+
+        THEN("blocks are big enough to hold any suitably-sized type")
+        {
+            REQUIRE(pool.getBlockSize() % alignof(std::max_align_t) == 0);
+            REQUIRE(pool.getBlockSize() >= sizeof(void*));
+        }
+
+        WHEN("more blocks are allocated than fit in a single chunk")
+        {
+            std::vector<void*> blocks;
+            for (int i = 0; i < 200; ++i)
+            {
+                blocks.push_back(pool.allocate());
+            }
+
+            THEN("every block is distinct and aligned")
+            {
+                const std::set<void*> uniqueBlocks(blocks.cbegin(), blocks.cend());
+                REQUIRE(uniqueBlocks.size() == blocks.size());
+
+                for (void* block : blocks)
+                {
+                    REQUIRE(reinterpret_cast<std::uintptr_t>(block) % alignof(std::max_align_t) == 0);
+                }
+            }
+
+            for (void* block : blocks)
+            {
+                pool.deallocate(block);
+            }
+        }
+
+        WHEN("a block is released and another is allocated")
+        {
+            void* first = pool.allocate();
+            pool.deallocate(first);
+            void* second = pool.allocate();
+
+            THEN("the released block is reused")
+            {
+                REQUIRE(second == first);
+            }
+
+            pool.deallocate(second);
+        }
+    }
+}
+
+SCENARIO("Shared objects can be allocated from a pool", "[utils][object-pool]")
+{
+    GIVEN("An object allocated using a PoolAllocator")
+    {
+        auto first = std::allocate_shared<PooledValue>(PoolAllocator<PooledValue>(), PooledValue { 42 });
+        const PooledValue* firstAddress = first.get();
+
+        WHEN("the object is released and another is allocated")
+        {
+            first.reset();
+            auto second = std::allocate_shared<PooledValue>(PoolAllocator<PooledValue>(), PooledValue { 7 });
+
+            THEN("the memory is reused")
+            {
+                REQUIRE(second.get() == firstAddress);
+                REQUIRE(second->value == 7);
+            }
+        }
+    }
+}
+
+SCENARIO("An ObjectPool recycles objects once they are released", "[utils][object-pool]")
+{
+    GIVEN("An object acquired from an ObjectPool")
+    {
+        std::shared_ptr<PooledBuffer> first = ObjectPool<PooledBuffer>::acquire();
+        first->values.assign(100, 1);
+        const PooledBuffer* firstAddress = first.get();
+
+        WHEN("the object is still in use")
+        {
+            std::shared_ptr<PooledBuffer> second = ObjectPool<PooledBuffer>::acquire();
+
+            THEN("a different object is acquired")
+            {
+                REQUIRE(second.get() != firstAddress);
+            }
+        }
+
+        WHEN("the object is released and another is acquired")
+        {
+            const int numResets = first->numResets;
+            first.reset();
+            std::shared_ptr<PooledBuffer> second = ObjectPool<PooledBuffer>::acquire();
+
+            THEN("the same object is reset and reused, keeping its storage")
+            {
+                REQUIRE(second.get() == firstAddress);
+                REQUIRE(second->numResets == numResets + 1);
+                REQUIRE(second->values.empty());
+                REQUIRE(second->values.capacity() >= 100);
+            }
+        }
+    }
+}
@@ -0,0 +1,281 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "net/ReliableChannel.h"
+
+using namespace Rival;
+
+namespace {
+
+/**
+ * Sends the next datagram from one channel to another at the given time, unless it is dropped.
+ *
+ * Returns false if nothing was sent.
+ */
+bool transfer(
+        ReliableChannel& from,
+        ReliableChannel& to,
+        std::vector<char>& received,
+        bool drop = false,
+        std::uint32_t now = 0)
+{
+    std::vector<char> datagram;
+    if (!from.writeDatagram(datagram, now))
+    {
+        return false;
+    }
+
+    if (!drop)
+    {
+        to.readDatagram(datagram.data(), datagram.size(), now, received);
+    }
+
+    return true;
+}
+
+/** Reads the number of messages in a datagram. */
+int getNumMessages(const std::vector<char>& datagram)
+{
+    return static_cast<std::uint8_t>(datagram[sizeof(std::uint32_t)]);
+}
+
+}  // namespace
+
+SCENARIO("A ReliableChannel delivers data in order, without gaps or duplicates", "[net][reliable-channel]")
+{
+    GIVEN("A pair of channels")
+    {
+        ReliableChannel sender;
+        ReliableChannel receiver;
+        std::vector<char> received;
+        std::vector<char> unused;
+
+        WHEN("nothing has been queued")
+        {
+            THEN("there is nothing to send")
+            {
+                std::vector<char> datagram;
+                REQUIRE_FALSE(sender.writeDatagram(datagram, 0));
+            }
+        }
+
+        WHEN("data is sent without loss")
+        {
+            const std::string data = "Rival";
+            sender.queueMessage(data.data(), data.size());
+            transfer(sender, receiver, received);
+
+            THEN("the data is delivered, and becomes acknowledged once the receiver replies")
+            {
+                REQUIRE(std::string(received.cbegin(), received.cend()) == data);
+                REQUIRE(sender.hasUnackedMessages());
+
+                REQUIRE(transfer(receiver, sender, unused));
+                REQUIRE_FALSE(sender.hasUnackedMessages());
+            }
+        }
+
+        WHEN("a single datagram is lost")
+        {
+            sender.queueMessage("a", 1);
+            transfer(sender, receiver, received, true);
+            sender.queueMessage("b", 1);
+            transfer(sender, receiver, received);
+
+            THEN("its data is recovered by the very next datagram")
+            {
+                REQUIRE(std::string(received.cbegin(), received.cend()) == "ab");
+            }
+        }
+
+        WHEN("a datagram is received twice")
+        {
+            sender.queueMessage("a", 1);
+            std::vector<char> datagram;
+            sender.writeDatagram(datagram, 0);
+            receiver.readDatagram(datagram.data(), datagram.size(), 0, received);
+            receiver.readDatagram(datagram.data(), datagram.size(), 0, received);
+
+            THEN("its data is only delivered once")
+            {
+                REQUIRE(std::string(received.cbegin(), received.cend()) == "a");
+            }
+        }
+
+        WHEN("datagrams arrive out of order")
+        {
+            sender.queueMessage("a", 1);
+            std::vector<char> first;
+            sender.writeDatagram(first, 0);
+
+            // Acknowledge the first message so that it is not repeated in the second datagram
+            receiver.readDatagram(first.data(), first.size(), 0, unused);
+            transfer(receiver, sender, unused);
+            sender.queueMessage("b", 1);
+            std::vector<char> second;
+            sender.writeDatagram(second, 0);
+
+            ReliableChannel lateReceiver;
+            lateReceiver.readDatagram(second.data(), second.size(), 0, received);
+            const std::size_t receivedBeforeGap = received.size();
+            lateReceiver.readDatagram(first.data(), first.size(), 0, received);
+
+            THEN("data is held back until the gap is filled")
+            {
+                REQUIRE(receivedBeforeGap == 0);
+                REQUIRE(std::string(received.cbegin(), received.cend()) == "ab");
+            }
+        }
+
+        WHEN("data too large for a single message is queued")
+        {
+            std::vector<char> data(ReliableChannel::maxMessageSize * 3 + 1);
+            for (std::size_t i = 0; i < data.size(); ++i)
+            {
+                data[i] = static_cast<char>(i % 127);
+            }
+            sender.queueMessage(data.data(), data.size());
+
+            while (transfer(sender, receiver, received))
+            {
+                transfer(receiver, sender, unused);
+            }
+
+            THEN("the data is split across datagrams and reassembled")
+            {
+                REQUIRE(received == data);
+            }
+        }
+
+        WHEN("a message is never acknowledged")
+        {
+            sender.queueMessage("a", 1);
+            std::vector<char> datagram;
+            int numCopies = 0;
+            while (sender.writeDatagram(datagram, 0))
+            {
+                numCopies += getNumMessages(datagram);
+            }
+
+            THEN("it is only repeated in the first few datagrams")
+            {
+                REQUIRE(numCopies == ReliableChannel::redundantSends);
+                REQUIRE(sender.hasUnackedMessages());
+            }
+
+            AND_THEN("it is resent once the retransmission timeout expires")
+            {
+                const std::uint32_t timeout = sender.getResendTimeoutMs();
+                REQUIRE_FALSE(sender.writeDatagram(datagram, timeout - 1));
+                REQUIRE(sender.writeDatagram(datagram, timeout));
+                REQUIRE(getNumMessages(datagram) == 1);
+                REQUIRE_FALSE(sender.writeDatagram(datagram, timeout));
+            }
+        }
+
+        WHEN("many messages are waiting to be acknowledged")
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                sender.queueMessage("a", 1);
+                std::vector<char> datagram;
+                sender.writeDatagram(datagram, 0);
+            }
+
+            THEN("a datagram only repeats the most recent ones")
+            {
+                sender.queueMessage("b", 1);
+                std::vector<char> datagram;
+                REQUIRE(sender.writeDatagram(datagram, 0));
+                REQUIRE(getNumMessages(datagram) == ReliableChannel::redundantSends);
+            }
+        }
+
+        WHEN("the receiver acknowledges data after a delay")
+        {
+            constexpr std::uint32_t roundTripMs = 300;
+            for (std::uint32_t time = 0; time < 100 * roundTripMs; time += roundTripMs)
+            {
+                sender.queueMessage("a", 1);
+                transfer(sender, receiver, received, false, time);
+                transfer(receiver, sender, unused, false, time + roundTripMs);
+            }
+
+            THEN("the retransmission timeout adapts to the round-trip time")
+            {
+                REQUIRE(sender.getResendTimeoutMs() >= roundTripMs);
+                REQUIRE(sender.getResendTimeoutMs() < 2 * roundTripMs);
+            }
+        }
+
+        WHEN("a malformed datagram is received")
+        {
+            const std::vector<char> datagram = { 0, 0, 0, 0, 1, 0, 0, 0, 0, 100, 0 };
+
+            THEN("an exception is thrown")
+            {
+                REQUIRE_THROWS_AS(receiver.readDatagram(datagram.data(), datagram.size(), 0, received),
+                                  std::runtime_error);
+            }
+        }
+    }
+}
+
+SCENARIO("A ReliableChannel tolerates heavy packet loss in both directions", "[net][reliable-channel]")
+{
+    GIVEN("Two channels exchanging a datagram every tick over a link that loses 30% of datagrams")
+    {
+        ReliableChannel a;
+        ReliableChannel b;
+        std::vector<char> sentByA;
+        std::vector<char> sentByB;
+        std::vector<char> receivedByA;
+        std::vector<char> receivedByB;
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> lossDistribution(0.f, 1.f);
+        auto isLost = [&]() { return lossDistribution(random) < 0.3f; };
+
+        WHEN("each side sends data every tick")
+        {
+            constexpr int numTicks = 500;
+            constexpr std::uint32_t tickMs = 16;
+            std::uint32_t now = 0;
+            for (int tick = 0; tick < numTicks; ++tick)
+            {
+                const std::string tickData = std::to_string(tick) + ";";
+                a.queueMessage(tickData.data(), tickData.size());
+                sentByA.insert(sentByA.cend(), tickData.cbegin(), tickData.cend());
+                b.queueMessage(tickData.data(), tickData.size());
+                sentByB.insert(sentByB.cend(), tickData.cbegin(), tickData.cend());
+
+                transfer(a, b, receivedByB, isLost(), now);
+                transfer(b, a, receivedByA, isLost(), now);
+                now += tickMs;
+            }
+
+            // Keep exchanging datagrams until everything has been acknowledged
+            int extraTicks = 0;
+            while ((a.hasUnackedMessages() || b.hasUnackedMessages()) && extraTicks < 1000)
+            {
+                transfer(a, b, receivedByB, isLost(), now);
+                transfer(b, a, receivedByA, isLost(), now);
+                now += tickMs;
+                ++extraTicks;
+            }
+
+            THEN("all data is delivered in order")
+            {
+                REQUIRE(receivedByB == sentByA);
+                REQUIRE(receivedByA == sentByB);
+            }
+        }
+    }
+}
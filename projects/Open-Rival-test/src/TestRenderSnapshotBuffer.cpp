@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include "RenderSnapshotBuffer.h"
+
+using namespace Rival;
+
+SCENARIO("RenderSnapshotBuffer passes the latest snapshot to the renderer", "[render-snapshot]")
+{
+    GIVEN("A RenderSnapshotBuffer")
+    {
+        RenderSnapshotBuffer buffer;
+
+        WHEN("nothing has been published")
+        {
+            THEN("the latest snapshot is empty")
+            {
+                REQUIRE(buffer.getLatest().time == 0);
+            }
+        }
+
+        WHEN("a snapshot is published")
+        {
+            buffer.getWriteSnapshot().time = 1;
+            buffer.publish();
+
+            THEN("the renderer receives it")
+            {
+                REQUIRE(buffer.getLatest().time == 1);
+            }
+
+            AND_WHEN("the renderer reads it again without a new snapshot being published")
+            {
+                buffer.getLatest();
+
+                THEN("the renderer receives the same snapshot")
+                {
+                    REQUIRE(buffer.getLatest().time == 1);
+                }
+            }
+
+            AND_WHEN("the renderer is reading it")
+            {
+                const RenderSnapshot& readSnapshot = buffer.getLatest();
+
+                THEN("the simulation writes to a different snapshot")
+                {
+                    REQUIRE(&buffer.getWriteSnapshot() != &readSnapshot);
+                }
+            }
+        }
+
+        WHEN("several snapshots are published before the renderer reads any")
+        {
+            for (Uint32 time = 1; time <= 5; ++time)
+            {
+                buffer.getWriteSnapshot().time = time;
+                buffer.publish();
+            }
+
+            THEN("the renderer receives only the most recent")
+            {
+                REQUIRE(buffer.getLatest().time == 5);
+            }
+        }
+    }
+}
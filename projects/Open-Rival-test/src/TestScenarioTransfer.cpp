@@ -0,0 +1,310 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <algorithm>  // std::min
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "net/Connection.h"
+#include "net/PacketFactory.h"
+#include "net/ScenarioTransfer.h"
+#include "net/Server.h"
+#include "net/packets/JoinRoomPacket.h"
+#include "net/packets/Packet.h"
+#include "net/packets/ScenarioAckPacket.h"
+#include "net/packets/ScenarioChunkPacket.h"
+#include "utils/ChecksumUtils.h"
+#include "utils/CompressionUtils.h"
+
+using namespace Rival;
+
+namespace {
+
+/**
+ * Creates data laid out like the tiles of a scenario file.
+ *
+ * Each tile definition is 10 bytes, and most tiles are the same as the one before.
+ */
+std::vector<std::uint8_t> makeTileData(int numTiles)
+{
+    std::mt19937 random(1234);
+    std::vector<std::uint8_t> data;
+
+    std::uint8_t type = 0;
+    std::uint8_t variant = 0;
+    for (int i = 0; i < numTiles; ++i)
+    {
+        if (random() % 8 == 0)
+        {
+            type = static_cast<std::uint8_t>(random() % 4);
+            variant = static_cast<std::uint8_t>(random() % 16);
+        }
+
+        const std::vector<std::uint8_t> tile = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, type, 0x00, variant, 0x00 };
+        data.insert(data.cend(), tile.cbegin(), tile.cend());
+    }
+
+    return data;
+}
+
+/** Creates data that cannot be compressed. */
+std::vector<std::uint8_t> makeRandomData(std::size_t size)
+{
+    std::mt19937 random(5678);
+    std::vector<std::uint8_t> data(size);
+    for (std::uint8_t& byte : data)
+    {
+        byte = static_cast<std::uint8_t>(random());
+    }
+    return data;
+}
+
+/** Connects a client to the server's default room, using a loopback link. */
+std::unique_ptr<Connection> connectToRoom(Server& server, std::shared_ptr<PacketFactory> packetFactory)
+{
+    auto connection = std::make_unique<Connection>(server.connectLoopback(), packetFactory);
+    connection->send(JoinRoomPacket(Server::defaultRoomId));
+    connection->flush();
+    server.poll(0);
+    return connection;
+}
+
+}  // namespace
+
+SCENARIO("Scenario data can be compressed and decompressed", "[scenario-transfer]")
+{
+    GIVEN("Tile data in which most tiles repeat the one before")
+    {
+        const std::vector<std::uint8_t> data = makeTileData(10000);
+
+        WHEN("the data is compressed")
+        {
+            const std::vector<char> compressed = CompressionUtils::compress(data);
+
+            THEN("it is much smaller than the original")
+            {
+                REQUIRE(compressed.size() < data.size() / 10);
+            }
+
+            THEN("it decompresses to the original data")
+            {
+                REQUIRE(CompressionUtils::decompress(compressed, data.size()) == data);
+            }
+
+            THEN("decompression fails if the data is incomplete, or not of the expected size")
+            {
+                const std::vector<char> truncated(compressed.cbegin(), compressed.cend() - 1);
+                REQUIRE_THROWS_AS(CompressionUtils::decompress(truncated, data.size()), std::runtime_error);
+                REQUIRE_THROWS_AS(CompressionUtils::decompress(compressed, data.size() - 1), std::runtime_error);
+                REQUIRE_THROWS_AS(CompressionUtils::decompress(compressed, data.size() + 1), std::runtime_error);
+            }
+        }
+    }
+
+    GIVEN("Random data")
+    {
+        const std::vector<std::uint8_t> data = makeRandomData(10000);
+
+        WHEN("the data is compressed")
+        {
+            const std::vector<char> compressed = CompressionUtils::compress(data);
+
+            THEN("it barely grows, and decompresses to the original data")
+            {
+                REQUIRE(compressed.size() <= data.size() + data.size() / 64);
+                REQUIRE(CompressionUtils::decompress(compressed, data.size()) == data);
+            }
+        }
+    }
+
+    GIVEN("Compressed data containing a match that refers back before the start of the data")
+    {
+        const std::vector<char> compressed = { 0x00, 'a', static_cast<char>(0x80), 0x02 };
+
+        THEN("decompression fails")
+        {
+            REQUIRE_THROWS_AS(CompressionUtils::decompress(compressed, 4), std::runtime_error);
+        }
+    }
+}
+
+SCENARIO("Checksums match the standard CRC-32", "[scenario-transfer]")
+{
+    const std::string input = "123456789";
+    const std::vector<std::uint8_t> data(input.cbegin(), input.cend());
+
+    REQUIRE(ChecksumUtils::crc32(data) == 0xcbf43926u);
+}
+
+SCENARIO("A scenario is sent to a player a few chunks at a time", "[scenario-transfer]")
+{
+    const std::vector<std::uint8_t> scenario = makeRandomData(50 * ScenarioChunkPacket::maxDataSize);
+    const auto compressed = std::make_shared<const std::vector<char>>(CompressionUtils::compress(scenario));
+    const std::uint32_t numChunks = ScenarioUpload::getNumChunks(compressed->size());
+    const int playerId = 1;
+    const int playerClientId = 1;
+
+    GIVEN("A host, a player and a bystander connected to a relay server")
+    {
+        Server server(std::nullopt, 3);
+        auto packetFactory = std::make_shared<PacketFactory>();
+        auto host = connectToRoom(server, packetFactory);
+        auto player = connectToRoom(server, packetFactory);
+        auto bystander = connectToRoom(server, packetFactory);
+
+        ScenarioUpload upload(playerId, playerClientId, compressed);
+        const std::size_t initialPacketsSent = host->getStats().packetsSent;
+
+        THEN("nothing is sent until the player asks for it")
+        {
+            upload.sendChunks(*host);
+            REQUIRE(host->getStats().packetsSent == initialPacketsSent);
+        }
+
+        WHEN("the player already has the scenario")
+        {
+            upload.onAckReceived(numChunks);
+
+            THEN("the upload is complete without sending anything")
+            {
+                upload.sendChunks(*host);
+                REQUIRE(upload.isComplete());
+                REQUIRE(host->getStats().packetsSent == initialPacketsSent);
+            }
+        }
+
+        WHEN("the player asks for the scenario")
+        {
+            upload.onAckReceived(0);
+
+            THEN("only a limited number of chunks are sent until the player acknowledges them")
+            {
+                upload.sendChunks(*host);
+                upload.sendChunks(*host);
+                REQUIRE(host->getStats().packetsSent - initialPacketsSent == ScenarioUpload::maxChunksInFlight);
+            }
+
+            THEN("the player receives the whole scenario, and never has too many chunks in flight")
+            {
+                ScenarioDownload download(
+                        static_cast<std::uint32_t>(scenario.size()),
+                        static_cast<std::uint32_t>(compressed->size()),
+                        ChecksumUtils::crc32(scenario));
+
+                std::uint32_t chunksAcked = 0;
+                std::vector<std::shared_ptr<const Packet>> packets;
+                for (int i = 0; i < 1000 && !upload.isComplete(); ++i)
+                {
+                    upload.sendChunks(*host);
+                    const std::size_t chunksSent = host->getStats().packetsSent - initialPacketsSent;
+                    REQUIRE(chunksSent - chunksAcked <= ScenarioUpload::maxChunksInFlight);
+                    host->flush();
+                    server.poll(0);
+
+                    player->getReceivedPackets(packets);
+                    for (const auto& packet : packets)
+                    {
+                        const auto& chunkPacket = static_cast<const ScenarioChunkPacket&>(*packet);
+                        REQUIRE(chunkPacket.getPlayerId() == playerId);
+                        download.addChunk(chunkPacket.getChunkIndex(), chunkPacket.getData());
+                        if (download.isAckDue())
+                        {
+                            player->send(ScenarioAckPacket(playerId, download.getChunksReceived()));
+                        }
+                    }
+                    player->flush();
+                    server.poll(0);
+
+                    host->getReceivedPackets(packets);
+                    for (const auto& packet : packets)
+                    {
+                        const auto& ackPacket = static_cast<const ScenarioAckPacket&>(*packet);
+                        chunksAcked = ackPacket.getChunksReceived();
+                        upload.onAckReceived(chunksAcked);
+                    }
+                }
+
+                REQUIRE(upload.isComplete());
+                REQUIRE(download.isComplete());
+                REQUIRE(download.getChunksReceived() == numChunks);
+                REQUIRE(download.extract() == scenario);
+            }
+
+            THEN("no chunks are delivered to anyone else")
+            {
+                upload.sendChunks(*host);
+                host->flush();
+                server.poll(0);
+
+                std::vector<std::shared_ptr<const Packet>> packets;
+                player->getReceivedPackets(packets);
+                REQUIRE(packets.size() == ScenarioUpload::maxChunksInFlight);
+
+                bystander->getReceivedPackets(packets);
+                REQUIRE(packets.empty());
+            }
+        }
+    }
+
+    GIVEN("A download expecting a different checksum")
+    {
+        ScenarioDownload download(
+                static_cast<std::uint32_t>(scenario.size()),
+                static_cast<std::uint32_t>(compressed->size()),
+                ChecksumUtils::crc32(scenario) + 1);
+
+        WHEN("every chunk is received")
+        {
+            for (std::uint32_t i = 0; i < numChunks; ++i)
+            {
+                const std::size_t start = i * ScenarioChunkPacket::maxDataSize;
+                const std::size_t end = std::min(start + ScenarioChunkPacket::maxDataSize, compressed->size());
+                download.addChunk(i, std::vector<char>(compressed->cbegin() + start, compressed->cbegin() + end));
+            }
+
+            THEN("the scenario is rejected")
+            {
+                REQUIRE(download.isComplete());
+                REQUIRE_THROWS_AS(download.extract(), std::runtime_error);
+            }
+        }
+    }
+
+    GIVEN("A download that has not yet received anything")
+    {
+        ScenarioDownload download(
+                static_cast<std::uint32_t>(scenario.size()),
+                static_cast<std::uint32_t>(compressed->size()),
+                ChecksumUtils::crc32(scenario));
+
+        THEN("chunks received out of order are rejected")
+        {
+            REQUIRE_THROWS_AS(download.addChunk(1, std::vector<char>(10)), std::runtime_error);
+        }
+    }
+}
+
+SCENARIO("Scenario filenames received from the host are checked", "[scenario-transfer]")
+{
+    THEN("plain filenames are accepted")
+    {
+        REQUIRE(ScenarioDownload::isValidFilename("Rival.sco"));
+        REQUIRE(ScenarioDownload::isValidFilename("My map.sco"));
+    }
+
+    THEN("anything that could lead outside of the maps directory is rejected")
+    {
+        REQUIRE_FALSE(ScenarioDownload::isValidFilename(""));
+        REQUIRE_FALSE(ScenarioDownload::isValidFilename("../Rival.sco"));
+        REQUIRE_FALSE(ScenarioDownload::isValidFilename(".."));
+        REQUIRE_FALSE(ScenarioDownload::isValidFilename("/etc/passwd"));
+        REQUIRE_FALSE(ScenarioDownload::isValidFilename("maps/Rival.sco"));
+        REQUIRE_FALSE(ScenarioDownload::isValidFilename("maps\\Rival.sco"));
+    }
+}
@@ -0,0 +1,728 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <chrono>
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "net/Connection.h"
+#include "net/LoopbackLink.h"
+#include "net/NetUtils.h"
+#include "net/PacketFactory.h"
+#include "net/RelayClient.h"
+#include "net/ReliableChannel.h"
+#include "net/Server.h"
+#include "net/Socket.h"
+#include "net/packets/GameCommandPacket.h"
+#include "net/packets/JoinRoomPacket.h"
+#include "net/packets/Packet.h"
+#include "net/packets/PingPacket.h"
+#include "net/packets/TargetedPacket.h"
+#include "utils/BufferUtils.h"
+#include "TimeUtils.h"
+
+using namespace Rival;
+
+namespace {
+
+/** Port used for loopback tests. */
+static constexpr std::uint16_t testPort = 25413;
+
+/** Size of the header that the server adds to relayed packets: client ID and relay time. */
+static constexpr std::size_t relayHeaderSize = sizeof(int) + sizeof(std::uint32_t);
+
+/**
+ * Initializes networking for the lifetime of a test.
+ */
+class NetworkingScope
+{
+public:
+    NetworkingScope()
+    {
+        NetUtils::initNetworking();
+    }
+
+    ~NetworkingScope()
+    {
+        NetUtils::destroyNetworking();
+    }
+};
+
+/** Serializes a packet containing the given type and payload, prefixed by its size. */
+std::vector<char> makePacket(PacketType type, const std::vector<char>& payload)
+{
+    std::vector<char> buffer;
+    buffer.reserve(Packet::sizeBytes + sizeof(type) + payload.size());
+    BufferUtils::addUint16ToBuffer(buffer, static_cast<std::uint16_t>(sizeof(type) + payload.size()));
+    BufferUtils::addToBuffer(buffer, type);
+    buffer.insert(buffer.end(), payload.cbegin(), payload.cend());
+    return buffer;
+}
+
+/** Sends a packet containing the given type and payload, prefixed by its size. */
+void sendPacket(Socket& socket, PacketType type, const std::vector<char>& payload)
+{
+    socket.send(makePacket(type, payload));
+}
+
+/** Sends a packet containing the given type and payload over a loopback link. */
+void sendPacket(LoopbackLink& link, PacketType type, const std::vector<char>& payload)
+{
+    if (!link.toServer.tryPush(std::make_shared<const std::vector<char>>(makePacket(type, payload))))
+    {
+        throw std::runtime_error("Loopback link is full");
+    }
+}
+
+/** Discards everything that the server has passed to a loopback link, returning the number of packets discarded. */
+int discardPackets(LoopbackLink& link)
+{
+    int numPackets = 0;
+    LoopbackLink::Block block;
+    while (link.toClient.tryPop(block))
+    {
+        ++numPackets;
+    }
+    return numPackets;
+}
+
+/** A packet as received from the relay server. */
+struct ReceivedPacket
+{
+    int clientId = -1;
+    PacketType type = PacketType::Invalid;
+    std::vector<char> payload;
+};
+
+/** Reads a packet sent by the relay server, excluding its size. */
+ReceivedPacket readPacket(const std::vector<char>& packetBuffer)
+{
+    ReceivedPacket packet;
+    std::size_t offset = 0;
+    BufferUtils::readFromBuffer(packetBuffer, offset, packet.clientId);
+    offset += sizeof(std::uint32_t);  // Relay time
+    BufferUtils::readFromBuffer(packetBuffer, offset, packet.type);
+    packet.payload.assign(packetBuffer.cbegin() + offset, packetBuffer.cend());
+    return packet;
+}
+
+/** Receives the next packet sent by the relay server. */
+ReceivedPacket receivePacket(Socket& socket)
+{
+    std::vector<char> sizeBuffer(Packet::sizeBytes);
+    socket.receive(sizeBuffer);
+    std::size_t offset = 0;
+    const std::size_t packetSize = Packet::readSize(sizeBuffer.data(), sizeBuffer.size(), offset);
+
+    std::vector<char> packetBuffer(packetSize);
+    socket.receive(packetBuffer);
+
+    return readPacket(packetBuffer);
+}
+
+/**
+ * Client that communicates with the relay server using datagrams, and can simulate packet loss.
+ */
+class DatagramClient
+{
+public:
+    DatagramClient()
+        : socket(Socket::createUdpClient("localhost", testPort))
+    {
+    }
+
+    /** Queues a packet to be sent with the next datagram. */
+    void send(PacketType type, const std::vector<char>& payload)
+    {
+        const std::vector<char> packet = makePacket(type, payload);
+        channel.queueMessage(packet.data(), packet.size());
+    }
+
+    /** Queues a request to join a room, which the server expects before anything else. */
+    void joinRoom(int roomId)
+    {
+        std::vector<char> payload;
+        payload.reserve(sizeof(roomId));
+        BufferUtils::addToBuffer(payload, roomId);
+        send(PacketType::JoinRoom, payload);
+    }
+
+    /** Sends the next datagram, unless it is dropped. This also acknowledges everything received so far. */
+    void tick(bool drop = false)
+    {
+        std::vector<char> datagram;
+        if (channel.writeDatagram(datagram, TimeUtils::getNetTimestamp()) && !drop)
+        {
+            socket.trySend(datagram.data(), datagram.size());
+        }
+    }
+
+    /** Exchanges datagrams with the server until the next packet arrives. */
+    ReceivedPacket receivePacket()
+    {
+        std::vector<char> datagram(ReliableChannel::maxDatagramSize);
+        for (int attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            std::size_t offset = 0;
+            if (stream.size() >= Packet::sizeBytes)
+            {
+                const std::size_t packetSize = Packet::readSize(stream.data(), stream.size(), offset);
+                if (stream.size() >= offset + packetSize)
+                {
+                    const auto packetEnd = stream.cbegin() + offset + packetSize;
+                    const std::vector<char> packetBuffer(stream.cbegin() + offset, packetEnd);
+                    stream.erase(stream.cbegin(), packetEnd);
+                    return readPacket(packetBuffer);
+                }
+            }
+
+            tick();
+            const int size = socket.receiveDatagram(datagram.data(), datagram.size(), receiveTimeoutMs);
+            if (size > 0)
+            {
+                channel.readDatagram(
+                        datagram.data(), static_cast<std::size_t>(size), TimeUtils::getNetTimestamp(), stream);
+            }
+        }
+
+        throw std::runtime_error("Timed out waiting for packet");
+    }
+
+private:
+    static constexpr int maxAttempts = 200;
+    static constexpr int receiveTimeoutMs = 10;
+
+    Socket socket;
+    ReliableChannel channel;
+    std::vector<char> stream;
+};
+
+/** Sends a request to join a room. */
+void joinRoom(Socket& socket, int roomId)
+{
+    std::vector<char> payload;
+    payload.reserve(sizeof(roomId));
+    BufferUtils::addToBuffer(payload, roomId);
+    sendPacket(socket, PacketType::JoinRoom, payload);
+}
+
+/** Waits until the server has registered a client by having it ping the server. */
+void waitUntilConnected(Socket& socket)
+{
+    sendPacket(socket, PacketType::Ping, {});
+    receivePacket(socket);
+}
+
+/**
+ * Waits for a Connection to receive the given number of packets of the given type.
+ *
+ * Any other packets received in the meantime are discarded.
+ */
+std::vector<std::shared_ptr<const Packet>>
+waitForPackets(Connection& connection, PacketType type, std::size_t numPackets)
+{
+    static constexpr int maxAttempts = 200;
+    static constexpr int attemptIntervalMs = 10;
+
+    std::vector<std::shared_ptr<const Packet>> matchingPackets;
+    std::vector<std::shared_ptr<const Packet>> packets;
+    for (int attempt = 0; attempt < maxAttempts; ++attempt)
+    {
+        connection.getReceivedPackets(packets);
+        for (const auto& packet : packets)
+        {
+            if (packet->getType() == type)
+            {
+                matchingPackets.push_back(packet);
+            }
+        }
+
+        if (matchingPackets.size() >= numPackets)
+        {
+            return matchingPackets;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(attemptIntervalMs));
+    }
+
+    throw std::runtime_error("Timed out waiting for packet");
+}
+
+/** Waits for a Connection to receive a packet of the given type. */
+std::shared_ptr<const Packet> waitForPacket(Connection& connection, PacketType type)
+{
+    return waitForPackets(connection, type, 1).front();
+}
+
+}  // namespace
+
+SCENARIO("The relay server forwards packets between clients", "[net][server]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server with two connected clients")
+    {
+        Server server(testPort, 2);
+        server.start();
+
+        Socket client0 = Socket::createClient("localhost", testPort);
+        waitUntilConnected(client0);
+        Socket client1 = Socket::createClient("localhost", testPort);
+        waitUntilConnected(client1);
+
+        WHEN("a client sends a packet")
+        {
+            const std::vector<char> payload = { 'R', 'i', 'v', 'a', 'l' };
+            sendPacket(client0, PacketType::GameCommand, payload);
+
+            THEN("the other client receives it, stamped with the sender's client ID")
+            {
+                ReceivedPacket packet = receivePacket(client1);
+                REQUIRE(packet.clientId == 0);
+                REQUIRE(packet.type == PacketType::GameCommand);
+                REQUIRE(packet.payload == payload);
+            }
+        }
+
+        WHEN("a client sends a ping")
+        {
+            sendPacket(client1, PacketType::Ping, { 'x' });
+
+            THEN("the ping is returned to the sender only")
+            {
+                ReceivedPacket packet = receivePacket(client1);
+                REQUIRE(packet.clientId == 1);
+                REQUIRE(packet.type == PacketType::Ping);
+
+                // Client 0 should receive the next packet from client 1, not the ping
+                sendPacket(client1, PacketType::GameCommand, {});
+                REQUIRE(receivePacket(client0).type == PacketType::GameCommand);
+            }
+        }
+
+        WHEN("a client sends an invalid packet size")
+        {
+            std::vector<char> buffer;
+            buffer.reserve(Packet::sizeBytes);
+            BufferUtils::addUint16ToBuffer(buffer, UINT16_MAX);
+            client0.send(buffer);
+
+            THEN("the server disconnects that client but keeps serving the others")
+            {
+                std::vector<char> received(1);
+                client0.receive(received);
+                REQUIRE_FALSE(client0.isOpen());
+
+                sendPacket(client1, PacketType::Ping, {});
+                REQUIRE(receivePacket(client1).type == PacketType::Ping);
+            }
+        }
+    }
+}
+
+SCENARIO("The relay server can deliver a packet to a single client", "[net][server]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server with three connected clients")
+    {
+        Server server(testPort, 3);
+        server.start();
+
+        Socket client0 = Socket::createClient("localhost", testPort);
+        waitUntilConnected(client0);
+        Socket client1 = Socket::createClient("localhost", testPort);
+        waitUntilConnected(client1);
+        Socket client2 = Socket::createClient("localhost", testPort);
+        waitUntilConnected(client2);
+
+        WHEN("a client sends a packet targeted at another client")
+        {
+            std::vector<char> buffer;
+            buffer.reserve(Connection::maxBufferSize);
+            TargetedPacket packet(2, GameCommandPacket({}, 3, GameCommandPacket::initialPreviousTick));
+            packet.serialize(buffer);
+            packet.finalize(buffer);
+            client0.send(buffer);
+
+            THEN("the recipient receives the wrapped packet, stamped with the sender's client ID")
+            {
+                ReceivedPacket received = receivePacket(client2);
+                REQUIRE(received.clientId == 0);
+                REQUIRE(received.type == PacketType::GameCommand);
+            }
+
+            AND_THEN("it is not received by any other client")
+            {
+                // Client 1 should receive the next packet from client 0, not the targeted one
+                sendPacket(client0, PacketType::StartGame, {});
+                REQUIRE(receivePacket(client1).type == PacketType::StartGame);
+            }
+        }
+
+        WHEN("a client sends a targeted packet that does not contain a packet")
+        {
+            std::vector<char> payload;
+            payload.reserve(sizeof(int));
+            BufferUtils::addToBuffer(payload, 2);
+            sendPacket(client0, PacketType::Targeted, payload);
+
+            THEN("the server disconnects that client")
+            {
+                std::vector<char> received(1);
+                client0.receive(received);
+                REQUIRE_FALSE(client0.isOpen());
+            }
+        }
+    }
+}
+
+SCENARIO("The relay server keeps rooms separate", "[net][server]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server with clients in two different rooms")
+    {
+        Server server(testPort, 2, 2);
+        server.start();
+
+        Socket roomAClient0 = Socket::createClient("localhost", testPort);
+        joinRoom(roomAClient0, 7);
+        waitUntilConnected(roomAClient0);
+        Socket roomAClient1 = Socket::createClient("localhost", testPort);
+        joinRoom(roomAClient1, 7);
+        waitUntilConnected(roomAClient1);
+        Socket roomBClient0 = Socket::createClient("localhost", testPort);
+        joinRoom(roomBClient0, 9);
+        waitUntilConnected(roomBClient0);
+
+        WHEN("a client sends a packet")
+        {
+            sendPacket(roomAClient1, PacketType::GameCommand, {});
+
+            THEN("it is received by the other client in the same room, with a client ID for that room")
+            {
+                ReceivedPacket packet = receivePacket(roomAClient0);
+                REQUIRE(packet.clientId == 1);
+                REQUIRE(packet.type == PacketType::GameCommand);
+            }
+
+            AND_THEN("it is not received by clients in other rooms")
+            {
+                sendPacket(roomBClient0, PacketType::Ping, {});
+                ReceivedPacket packet = receivePacket(roomBClient0);
+                REQUIRE(packet.clientId == 0);
+                REQUIRE(packet.type == PacketType::Ping);
+            }
+        }
+
+        WHEN("a client tries to join a room that is full")
+        {
+            Socket client = Socket::createClient("localhost", testPort);
+            joinRoom(client, 7);
+
+            THEN("the client is disconnected")
+            {
+                std::vector<char> received(1);
+                client.receive(received);
+                REQUIRE_FALSE(client.isOpen());
+            }
+        }
+
+        WHEN("a client tries to create a room when the maximum number of rooms already exist")
+        {
+            Socket client = Socket::createClient("localhost", testPort);
+            joinRoom(client, 11);
+
+            THEN("the client is disconnected")
+            {
+                std::vector<char> received(1);
+                client.receive(received);
+                REQUIRE_FALSE(client.isOpen());
+            }
+        }
+    }
+}
+
+SCENARIO("The relay server forwards packets between loopback and socket clients", "[net][server]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server with a loopback client and a socket client")
+    {
+        Server server(testPort, 2);
+        server.start();
+
+        auto packetFactory = std::make_shared<PacketFactory>();
+        Connection loopbackClient(server.connectLoopback(), packetFactory);
+        loopbackClient.send(JoinRoomPacket(Server::defaultRoomId));
+        loopbackClient.send(PingPacket(0));
+        loopbackClient.flush();
+        waitForPacket(loopbackClient, PacketType::Ping);
+
+        Socket socketClient = Socket::createClient("localhost", testPort);
+        waitUntilConnected(socketClient);
+
+        WHEN("the loopback client sends a packet")
+        {
+            loopbackClient.send(GameCommandPacket({}, 3, GameCommandPacket::initialPreviousTick));
+            loopbackClient.flush();
+
+            THEN("the socket client receives it, stamped with the sender's client ID")
+            {
+                ReceivedPacket packet = receivePacket(socketClient);
+                REQUIRE(packet.clientId == 0);
+                REQUIRE(packet.type == PacketType::GameCommand);
+            }
+        }
+
+        WHEN("the socket client sends a packet")
+        {
+            std::vector<char> buffer;
+            buffer.reserve(Connection::maxBufferSize);
+            GameCommandPacket packet({}, 5, GameCommandPacket::initialPreviousTick);
+            packet.serialize(buffer);
+            packet.finalize(buffer);
+            socketClient.send(buffer);
+
+            THEN("the loopback client receives it, stamped with the sender's client ID")
+            {
+                auto received = waitForPacket(loopbackClient, PacketType::GameCommand);
+                const auto& commandPacket = static_cast<const GameCommandPacket&>(*received);
+                REQUIRE(commandPacket.getClientId() == 1);
+                REQUIRE(commandPacket.getTickDelta() == 5 - GameCommandPacket::initialPreviousTick);
+            }
+        }
+    }
+}
+
+SCENARIO("A TCP connection sends packets from its own writer thread", "[net][server]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server with two clients connected using TCP")
+    {
+        Server server(testPort, 2);
+        server.start();
+
+        auto packetFactory = std::make_shared<PacketFactory>();
+        Connection sender(Socket::createClient("localhost", testPort), packetFactory, Transport::Tcp);
+        sender.send(PingPacket(0));
+        sender.flush();
+        waitForPacket(sender, PacketType::Ping);
+
+        Connection receiver(Socket::createClient("localhost", testPort), packetFactory, Transport::Tcp);
+        receiver.send(PingPacket(0));
+        receiver.flush();
+        waitForPacket(receiver, PacketType::Ping);
+
+        WHEN("a client sends a packet every tick")
+        {
+            static constexpr int numTicks = 100;
+
+            int previousTick = GameCommandPacket::initialPreviousTick;
+            for (int i = 0; i < numTicks; ++i)
+            {
+                // Each packet skips one more tick than the last, so that the order can be checked
+                const int tick = previousTick + i + 1;
+                sender.send(GameCommandPacket({}, tick, previousTick));
+                sender.flush();
+                previousTick = tick;
+            }
+
+            THEN("the other client receives every packet, in order")
+            {
+                const auto packets = waitForPackets(receiver, PacketType::GameCommand, numTicks);
+                REQUIRE(packets.size() == numTicks);
+                for (int i = 0; i < numTicks; ++i)
+                {
+                    REQUIRE(static_cast<const GameCommandPacket&>(*packets[i]).getTickDelta() == i + 1);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("The relay server limits how much it queues for clients that fall behind", "[net][server]")
+{
+    // Packets large enough to reach the limit quickly
+    const std::vector<char> payload(400, 'x');
+
+    // Enough packets to fill the slow client's link, and then go over the limit of what the server will queue
+    const std::size_t numPackets = LoopbackLink::capacity + RelayClient::maxPendingWriteBytes / payload.size() + 1;
+
+    GIVEN("A server that disconnects slow clients, where one client has stopped reading")
+    {
+        Server server(std::nullopt, 2, 1, SlowClientPolicy::Disconnect);
+
+        auto sender = server.connectLoopback();
+        sendPacket(*sender, PacketType::Ping, {});
+        server.poll(0);
+
+        auto slowClient = server.connectLoopback();
+        sendPacket(*slowClient, PacketType::Ping, {});
+        server.poll(0);
+
+        discardPackets(*sender);
+        discardPackets(*slowClient);
+
+        WHEN("another client sends more than the server will queue for it")
+        {
+            for (std::size_t i = 0; i < numPackets; ++i)
+            {
+                sendPacket(*sender, PacketType::GameCommand, payload);
+                server.poll(0);
+            }
+
+            THEN("the slow client is disconnected")
+            {
+                REQUIRE(slowClient->closed);
+            }
+
+            THEN("the other client is still served")
+            {
+                sendPacket(*sender, PacketType::Ping, {});
+                server.poll(0);
+                REQUIRE_FALSE(sender->closed);
+                REQUIRE(discardPackets(*sender) == 1);
+            }
+        }
+    }
+
+    GIVEN("A server that drops packets for slow clients, where one client has stopped reading")
+    {
+        Server server(std::nullopt, 2, 1, SlowClientPolicy::DropPackets);
+
+        auto sender = server.connectLoopback();
+        sendPacket(*sender, PacketType::Ping, {});
+        server.poll(0);
+
+        auto slowClient = server.connectLoopback();
+        sendPacket(*slowClient, PacketType::Ping, {});
+        server.poll(0);
+
+        discardPackets(*sender);
+        discardPackets(*slowClient);
+
+        WHEN("another client sends more than the server will queue for it")
+        {
+            for (std::size_t i = 0; i < numPackets; ++i)
+            {
+                sendPacket(*sender, PacketType::GameCommand, payload);
+                server.poll(0);
+            }
+
+            THEN("the slow client stays connected, but misses some packets")
+            {
+                std::size_t numReceived = 0;
+                int numDiscarded = 0;
+                do
+                {
+                    numDiscarded = discardPackets(*slowClient);
+                    numReceived += static_cast<std::size_t>(numDiscarded);
+                    server.poll(0);
+                } while (numDiscarded > 0);
+
+                REQUIRE_FALSE(slowClient->closed);
+                REQUIRE(numReceived < numPackets);
+
+                AND_THEN("it receives new packets once it has caught up")
+                {
+                    sendPacket(*sender, PacketType::GameCommand, payload);
+                    server.poll(0);
+                    REQUIRE(discardPackets(*slowClient) == 1);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("The relay server forwards packets between clients using datagrams", "[net][server]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server with two clients connected using datagrams")
+    {
+        Server server(testPort, 2);
+        server.start();
+
+        DatagramClient client0;
+        client0.joinRoom(0);
+        client0.send(PacketType::Ping, {});
+        REQUIRE(client0.receivePacket().type == PacketType::Ping);
+        DatagramClient client1;
+        client1.joinRoom(0);
+        client1.send(PacketType::Ping, {});
+        REQUIRE(client1.receivePacket().type == PacketType::Ping);
+
+        WHEN("a client sends a packet")
+        {
+            const std::vector<char> payload = { 'R', 'i', 'v', 'a', 'l' };
+            client0.send(PacketType::GameCommand, payload);
+            client0.tick();
+
+            THEN("the other client receives it, stamped with the sender's client ID")
+            {
+                ReceivedPacket packet = client1.receivePacket();
+                REQUIRE(packet.clientId == 0);
+                REQUIRE(packet.type == PacketType::GameCommand);
+                REQUIRE(packet.payload == payload);
+            }
+        }
+
+        WHEN("a client sends a packet every tick, but some of its datagrams are lost")
+        {
+            constexpr int numTicks = 20;
+            for (int tick = 0; tick < numTicks; ++tick)
+            {
+                client0.send(PacketType::GameCommand, { static_cast<char>(tick) });
+                client0.tick(tick % 3 == 0);
+            }
+            client0.tick();
+
+            THEN("the other client receives every packet, in order")
+            {
+                for (int tick = 0; tick < numTicks; ++tick)
+                {
+                    ReceivedPacket packet = client1.receivePacket();
+                    REQUIRE(packet.type == PacketType::GameCommand);
+                    REQUIRE(packet.payload == std::vector<char> { static_cast<char>(tick) });
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("The relay server ignores datagrams from unknown addresses that do not join a room", "[net][server]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server with room for a single client")
+    {
+        Server server(testPort, 1, 1);
+        server.start();
+
+        WHEN("an unknown address sends a datagram without joining a room")
+        {
+            DatagramClient strayClient;
+            strayClient.send(PacketType::Ping, {});
+            strayClient.tick();
+
+            THEN("it is not given a reply")
+            {
+                REQUIRE_THROWS(strayClient.receivePacket());
+
+                AND_THEN("it does not take the place of a client that joins a room")
+                {
+                    DatagramClient client;
+                    client.joinRoom(0);
+                    client.send(PacketType::Ping, {});
+                    REQUIRE(client.receivePacket().type == PacketType::Ping);
+                }
+            }
+        }
+    }
+}
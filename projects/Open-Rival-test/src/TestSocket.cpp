@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <cstdint>
+#include <numeric>  // std::iota
+#include <thread>
+#include <vector>
+
+#include "net/NetUtils.h"
+#include "net/Socket.h"
+
+using namespace Rival;
+
+namespace {
+
+/** Port used for loopback tests. */
+static constexpr std::uint16_t testPort = 25412;
+
+/**
+ * Initializes networking for the lifetime of a test.
+ */
+class NetworkingScope
+{
+public:
+    NetworkingScope()
+    {
+        NetUtils::initNetworking();
+    }
+
+    ~NetworkingScope()
+    {
+        NetUtils::destroyNetworking();
+    }
+};
+
+/**
+ * Creates a connected pair of sockets over the loopback interface.
+ */
+void connectLoopback(Socket& serverSocket, Socket& acceptedSocket, Socket& clientSocket)
+{
+    serverSocket = Socket::createServer(testPort);
+    std::thread acceptThread([&]() { acceptedSocket = serverSocket.accept(); });
+    clientSocket = Socket::createClient("localhost", testPort);
+    acceptThread.join();
+}
+
+}  // namespace
+
+SCENARIO("Sockets can exchange data over the loopback interface", "[net][socket]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A client connected to a server")
+    {
+        Socket serverSocket;
+        Socket acceptedSocket;
+        Socket clientSocket;
+        connectLoopback(serverSocket, acceptedSocket, clientSocket);
+
+        REQUIRE(acceptedSocket.isOpen());
+        REQUIRE(clientSocket.isOpen());
+
+        WHEN("the client sends some data")
+        {
+            const std::vector<char> sent = { 'R', 'i', 'v', 'a', 'l' };
+            clientSocket.send(sent);
+
+            THEN("the server receives the same data")
+            {
+                std::vector<char> received(sent.size());
+                acceptedSocket.receive(received);
+                REQUIRE(received == sent);
+            }
+        }
+
+        WHEN("the client sends several buffers in a single gathered write")
+        {
+            const std::vector<char> first = { 'O', 'p', 'e', 'n' };
+            const std::vector<char> second = { '-' };
+            const std::vector<char> third = { 'R', 'i', 'v', 'a', 'l' };
+            const SendBuffer buffers[] = { { first.data(), first.size() },
+                                           { second.data(), second.size() },
+                                           { third.data(), third.size() } };
+            clientSocket.setNonBlocking();
+            int bytesSent = clientSocket.trySend(buffers, 3);
+
+            THEN("the server receives the buffers in order")
+            {
+                REQUIRE(bytesSent == 10);
+
+                std::vector<char> received(10);
+                acceptedSocket.receive(received);
+                REQUIRE(received == std::vector<char> { 'O', 'p', 'e', 'n', '-', 'R', 'i', 'v', 'a', 'l' });
+            }
+        }
+
+        WHEN("the server sends more data than fits in the socket buffers")
+        {
+            std::vector<char> sent(4 * 1024 * 1024);
+            std::iota(sent.begin(), sent.end(), static_cast<char>(0));
+
+            std::thread sendThread([&]() { acceptedSocket.send(sent); });
+            std::vector<char> received(sent.size());
+            clientSocket.receive(received);
+            sendThread.join();
+
+            THEN("the client receives all of it, in order")
+            {
+                REQUIRE(received == sent);
+                REQUIRE(acceptedSocket.isOpen());
+            }
+        }
+
+        WHEN("the client disconnects while the server is waiting to receive")
+        {
+            std::thread receiveThread([&]() {
+                std::vector<char> received(1);
+                acceptedSocket.receive(received);
+            });
+            clientSocket.close();
+            receiveThread.join();
+
+            THEN("the server's socket is closed")
+            {
+                REQUIRE_FALSE(acceptedSocket.isOpen());
+            }
+        }
+    }
+}
+
+SCENARIO("Closing a socket wakes up blocking calls", "[net][socket]")
+{
+    NetworkingScope networking;
+
+    GIVEN("A server waiting for a connection")
+    {
+        Socket serverSocket = Socket::createServer(testPort);
+        Socket acceptedSocket;
+        std::thread acceptThread([&]() { acceptedSocket = serverSocket.accept(); });
+
+        WHEN("the server socket is closed")
+        {
+            serverSocket.close();
+            acceptThread.join();
+
+            THEN("accept returns without a connection")
+            {
+                REQUIRE_FALSE(acceptedSocket.isOpen());
+            }
+        }
+    }
+
+    GIVEN("A connected socket waiting to receive data")
+    {
+        Socket serverSocket;
+        Socket acceptedSocket;
+        Socket clientSocket;
+        connectLoopback(serverSocket, acceptedSocket, clientSocket);
+
+        std::thread receiveThread([&]() {
+            std::vector<char> received(1);
+            clientSocket.receive(received);
+        });
+
+        WHEN("the socket is closed")
+        {
+            clientSocket.close();
+            receiveThread.join();
+
+            THEN("receive returns and the socket stays closed")
+            {
+                REQUIRE_FALSE(clientSocket.isOpen());
+            }
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <memory>
+#include <thread>
+
+#include "utils/SpscQueue.h"
+
+using namespace Rival;
+
+SCENARIO("An SpscQueue passes items along in order", "[utils][spsc-queue]")
+{
+    GIVEN("An empty queue")
+    {
+        SpscQueue<int, 4> queue;
+        int item = 0;
+
+        THEN("nothing can be popped")
+        {
+            REQUIRE_FALSE(queue.tryPop(item));
+        }
+
+        WHEN("items are pushed")
+        {
+            REQUIRE(queue.tryPush(1));
+            REQUIRE(queue.tryPush(2));
+
+            THEN("they are popped in the same order")
+            {
+                REQUIRE(queue.tryPop(item));
+                REQUIRE(item == 1);
+                REQUIRE(queue.tryPop(item));
+                REQUIRE(item == 2);
+                REQUIRE_FALSE(queue.tryPop(item));
+            }
+        }
+
+        WHEN("the queue is filled")
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                REQUIRE(queue.tryPush(std::move(i)));
+            }
+
+            THEN("no more items can be pushed until one is popped")
+            {
+                REQUIRE_FALSE(queue.tryPush(4));
+                REQUIRE(queue.tryPop(item));
+                REQUIRE(queue.tryPush(4));
+            }
+        }
+
+        WHEN("many more items than the capacity pass through the queue")
+        {
+            bool inOrder = true;
+            for (int i = 0; i < 100; ++i)
+            {
+                queue.tryPush(std::move(i));
+                queue.tryPop(item);
+                inOrder &= (item == i);
+            }
+
+            THEN("the ring buffer wraps around correctly")
+            {
+                REQUIRE(inOrder);
+            }
+        }
+    }
+}
+
+SCENARIO("An SpscQueue does not consume items that it has no room for", "[utils][spsc-queue]")
+{
+    GIVEN("A full queue of move-only items")
+    {
+        SpscQueue<std::unique_ptr<int>, 1> queue;
+        REQUIRE(queue.tryPush(std::make_unique<int>(1)));
+
+        WHEN("another item is pushed")
+        {
+            auto item = std::make_unique<int>(2);
+            const bool pushed = queue.tryPush(std::move(item));
+
+            THEN("the push fails and the item is left untouched")
+            {
+                REQUIRE_FALSE(pushed);
+                REQUIRE(item);
+                REQUIRE(*item == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("An SpscQueue can be used by 2 threads at once", "[utils][spsc-queue]")
+{
+    GIVEN("A producer thread pushing a sequence of numbers")
+    {
+        constexpr int numItems = 100000;
+        SpscQueue<int, 64> queue;
+
+        std::thread producer([&queue]() {
+            for (int i = 0; i < numItems; ++i)
+            {
+                int item = i;
+                while (!queue.tryPush(std::move(item)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        WHEN("the consumer pops every item")
+        {
+            int expected = 0;
+            bool inOrder = true;
+            while (expected < numItems)
+            {
+                int item = -1;
+                if (queue.tryPop(item))
+                {
+                    inOrder &= (item == expected);
+                    ++expected;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+            producer.join();
+
+            THEN("every item arrives exactly once, in order")
+            {
+                REQUIRE(inOrder);
+                REQUIRE(expected == numItems);
+            }
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#include "pch.h"
+#include "catch2/catch.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "utils/BufferUtils.h"
+#include "Entity.h"
+#include "EntityComponent.h"
+#include "World.h"
+#include "WorldSnapshot.h"
+
+using namespace Rival;
+
+class CounterComponent : public EntityComponent
+{
+public:
+    int counter = 0;
+    bool restored = false;
+    bool onDeleteCalled = false;
+
+    CounterComponent()
+        : EntityComponent("counter")
+    {
+    }
+
+    void saveState(std::vector<char>& buffer) const override
+    {
+        BufferUtils::reserveInBuffer(buffer, sizeof(counter));
+        BufferUtils::addToBuffer(buffer, counter);
+    }
+
+    void restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset) override
+    {
+        BufferUtils::readFromBuffer(buffer, bufferSize, offset, counter);
+    }
+
+    void onStateRestored() override
+    {
+        restored = true;
+    }
+
+    void onDelete() override
+    {
+        onDeleteCalled = true;
+    }
+};
+
+SCENARIO("A World can be restored from a snapshot", "[world-snapshot]")
+{
+
+    GIVEN("A World containing an Entity")
+    {
+        World world(4, 4, false);
+        auto entity = std::make_shared<Entity>(EntityType::Unit, 1, 1);
+        auto component = std::make_shared<CounterComponent>();
+        entity->attach(component);
+        world.addEntity(entity, 1, 2);
+        component->counter = 7;
+
+        std::vector<char> snapshot;
+        WorldSnapshot::save(world, snapshot);
+
+        WHEN("the World is modified and the snapshot is restored")
+        {
+            world.setPassability({ 3, 3 }, TilePassability::Building);
+            entity->setPos({ 2, 2 });
+            entity->markForDeletion();
+            component->counter = 100;
+
+            WorldSnapshot::restore(world, snapshot.data(), snapshot.size());
+
+            THEN("the map data is restored")
+            {
+                REQUIRE(world.getPassability({ 3, 3 }) == TilePassability::Clear);
+            }
+
+            AND_THEN("the Entity is restored")
+            {
+                REQUIRE(entity->getPos() == MapNode { 1, 2 });
+                REQUIRE(!entity->isDeleted());
+            }
+
+            AND_THEN("the component state is restored")
+            {
+                REQUIRE(component->counter == 7);
+                REQUIRE(component->restored);
+            }
+        }
+
+        AND_WHEN("the snapshot is restored into a World that is missing one of its Entities")
+        {
+            World otherWorld(4, 4, false);
+
+            THEN("the snapshot is rejected")
+            {
+                REQUIRE_THROWS_AS(
+                        WorldSnapshot::restore(otherWorld, snapshot.data(), snapshot.size()), std::runtime_error);
+            }
+        }
+
+        AND_WHEN("the snapshot is truncated")
+        {
+            THEN("the snapshot is rejected")
+            {
+                REQUIRE_THROWS_AS(
+                        WorldSnapshot::restore(world, snapshot.data(), snapshot.size() - 1), std::runtime_error);
+            }
+        }
+    }
+}
+
+SCENARIO("A World can be rolled back across Entities spawning and dying", "[world-snapshot]")
+{
+    GIVEN("A snapshot of a World containing an Entity")
+    {
+        World world(4, 4, false);
+        auto entity = std::make_shared<Entity>(EntityType::Unit, 1, 1);
+        auto component = std::make_shared<CounterComponent>();
+        entity->attach(component);
+        world.addEntity(entity, 1, 2);
+        component->counter = 7;
+
+        std::vector<char> snapshot;
+        WorldSnapshot::save(world, snapshot);
+
+        WHEN("the Entity dies, a new Entity spawns, and the snapshot is restored")
+        {
+            entity->markForDeletion();
+            component->counter = 0;
+            world.removeEntity(entity);
+
+            auto spawnedEntity = std::make_shared<Entity>(EntityType::Unit, 1, 1);
+            auto spawnedComponent = std::make_shared<CounterComponent>();
+            spawnedEntity->attach(spawnedComponent);
+            world.addEntity(spawnedEntity, 3, 3);
+
+            WorldSnapshot::restore(world, snapshot.data(), snapshot.size(), { entity });
+
+            THEN("the dead Entity is brought back")
+            {
+                REQUIRE(world.getEntity(entity->getId()) == entity.get());
+                REQUIRE(!entity->isDeleted());
+                REQUIRE(component->counter == 7);
+                REQUIRE(component->restored);
+                REQUIRE(!component->onDeleteCalled);
+            }
+
+            AND_THEN("the spawned Entity is deleted")
+            {
+                REQUIRE(world.getEntity(spawnedEntity->getId()) == nullptr);
+                REQUIRE(spawnedComponent->onDeleteCalled);
+                REQUIRE(world.getEntities().size() == 1);
+            }
+
+            AND_THEN("the next Entity to spawn is given the same ID as the deleted one")
+            {
+                auto respawnedEntity = std::make_shared<Entity>(EntityType::Unit, 1, 1);
+                world.addEntity(respawnedEntity, 3, 3);
+                REQUIRE(respawnedEntity->getId() == spawnedEntity->getId());
+            }
+        }
+
+        AND_WHEN("the Entity dies, a new Entity spawns, and the snapshot is restored without the dead Entity")
+        {
+            world.removeEntity(entity);
+            world.setPassability({ 3, 3 }, TilePassability::Building);
+
+            auto spawnedEntity = std::make_shared<Entity>(EntityType::Unit, 1, 1);
+            auto spawnedComponent = std::make_shared<CounterComponent>();
+            spawnedEntity->attach(spawnedComponent);
+            world.addEntity(spawnedEntity, 3, 3);
+            spawnedComponent->counter = 3;
+
+            THEN("the snapshot is rejected")
+            {
+                REQUIRE_THROWS_AS(WorldSnapshot::restore(world, snapshot.data(), snapshot.size()), std::runtime_error);
+            }
+
+            AND_THEN("the World is left unchanged")
+            {
+                const std::uint32_t tilesVersion = world.getTilesVersion();
+                REQUIRE_THROWS(WorldSnapshot::restore(world, snapshot.data(), snapshot.size()));
+
+                REQUIRE(world.getTilesVersion() == tilesVersion);
+                REQUIRE(world.getPassability({ 3, 3 }) == TilePassability::Building);
+                REQUIRE(world.getEntity(entity->getId()) == nullptr);
+                REQUIRE(world.getEntity(spawnedEntity->getId()) == spawnedEntity.get());
+                REQUIRE(world.getEntities().size() == 1);
+                REQUIRE(spawnedComponent->counter == 3);
+                REQUIRE(!spawnedComponent->restored);
+                REQUIRE(!spawnedComponent->onDeleteCalled);
+
+                auto nextEntity = std::make_shared<Entity>(EntityType::Unit, 1, 1);
+                world.addEntity(nextEntity, 2, 2);
+                REQUIRE(nextEntity->getId() == spawnedEntity->getId() + 1);
+            }
+        }
+    }
+}
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "SDLWrapper.h"
+
+#include <atomic>
 #include <cstdint>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>  // std::move
@@ -17,6 +22,9 @@ class State;
 
 /**
  * Runs the game loop and switches between states.
+ *
+ * If the active State supports it, the logic runs on a separate simulation thread so that slow ticks and slow frames
+ * do not hold each other up.
  */
 class Application
 {
@@ -35,6 +43,14 @@ public:
         exiting = true;
     }
 
+    /**
+     * Sets whether the game logic should run as fast as possible, without rendering.
+     */
+    void setFastForward(bool enabled)
+    {
+        fastForward = enabled;
+    }
+
     void setState(std::unique_ptr<State> newState)
     {
         nextState = std::move(newState);
@@ -50,27 +66,61 @@ public:
         return *state;
     }
 
+    /**
+     * Gets the mutex that is held while the State is updated or handles input.
+     */
+    std::mutex& getStateMutex()
+    {
+        return stateMutex;
+    }
+
     std::optional<Connection>& getConnection()
     {
         return connection;
     }
 
-    /** Starts a server and connects to it. */
+    /**
+     * Starts a server and connects to it.
+     *
+     * Other players can connect using any transport, but we always connect to our own server over a LoopbackLink.
+     */
     void startServer(std::uint16_t port);
 
-    /** Connects to a server. */
-    void connectToServer(const std::string& address, std::uint16_t port);
+    /** Connects to a server and joins the given room. */
+    void connectToServer(const std::string& address,
+                         std::uint16_t port,
+                         int roomId = Server::defaultRoomId,
+                         Transport transport = Transport::Tcp);
 
 private:
     void makeNextStateActive();
+    void updateState();
+    void runFastForward();
+    void runSingleThreaded();
+    void runWithSimulationThread();
+    void runSimulation();
 
 private:
-    bool exiting { false };
+    // These may be set from the simulation thread
+    std::atomic<bool> exiting { false };
+    std::atomic<bool> fastForward { false };
+
+    /** Whether the simulation thread should keep running. */
+    std::atomic<bool> simulating { false };
+
+    /** Time at which the last logic update was due, in milliseconds. */
+    std::atomic<Uint32> lastUpdateTime { 0 };
+
+    /** Error thrown on the simulation thread, to be rethrown on the main thread. */
+    std::exception_ptr simulationError;
 
     ApplicationContext& context;
     std::unique_ptr<State> state;
     std::unique_ptr<State> nextState;
 
+    /** Mutex held while the State is updated or handles input. */
+    std::mutex stateMutex;
+
     std::optional<Server> server;
     std::optional<Connection> connection;
     std::shared_ptr<PacketFactory> packetFactory;
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <iostream>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "EntityComponent.h"
 #include "MapUtils.h"
@@ -118,6 +120,27 @@ public:
      */
     void onDelete();
 
+    /**
+     * Writes the mutable state of this Entity and its EntityComponents to the given buffer.
+     */
+    void saveState(std::vector<char>& buffer) const;
+
+    /**
+     * Restores the state previously written by `saveState`.
+     *
+     * The Entity must have the same EntityComponents as when the state was saved.
+     */
+    void restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
+    /**
+     * Checks that state previously written by `saveState` matches the EntityComponents of this Entity, and skips past
+     * it, without restoring anything.
+     *
+     * The state of each EntityComponent is not examined, so this cannot catch every error that `restoreState` might
+     * raise, but it does catch any state that was saved for a different Entity.
+     */
+    void checkState(const char* buffer, std::size_t bufferSize, std::size_t& offset) const;
+
     /**
      * Gets a pointer to the World that holds this Entity.
      */
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <string>
+#include <vector>
 
 namespace Rival {
 
@@ -41,6 +43,31 @@ public:
      */
     virtual void update() {};
 
+    /**
+     * Writes any mutable state of this EntityComponent to the given buffer.
+     *
+     * This is used when taking a snapshot of the World; any state that is
+     * fixed at creation time need not be saved. The buffer may be grown
+     * using `BufferUtils::reserveInBuffer`.
+     */
+    virtual void saveState(std::vector<char>&) const {}
+
+    /**
+     * Restores the state previously written by `saveState`.
+     *
+     * The offset should be increased by the size of the data read.
+     */
+    virtual void restoreState(const char*, std::size_t, std::size_t&) {}
+
+    /**
+     * Callback for when all EntityComponents of the owning Entity have been
+     * restored from a snapshot.
+     *
+     * This can be used to re-derive any state that depends on other
+     * EntityComponents.
+     */
+    virtual void onStateRestored() {}
+
     /**
      * Determines if this EntityComponent has been marked for deletion.
      */
@@ -1,52 +1,78 @@
 #pragma once
 
+#include <gl/glew.h>
 #include <glm/vec2.hpp>
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
-#include "EntityUtils.h"
 #include "SpriteRenderable.h"
 
 namespace Rival {
 
 class Camera;
 class Entity;
-class SpriteComponent;
+class Spritesheet;
 class Texture;
 class TextureStore;
-struct PlayerContext;
+struct EntityRenderState;
+struct MapNode;
+struct Movement;
+struct RenderSnapshot;
 
 /**
  * Class responsible for rendering Entities.
+ *
+ * Entities are rendered from a RenderSnapshot rather than from the World, so that rendering never has to wait for the
+ * simulation. Entities that share a Spritesheet and palette are drawn together in a single batch.
  */
 class EntityRenderer
 {
 public:
-    EntityRenderer(const TextureStore& textureStore, const PlayerContext& playerContext);
+    EntityRenderer(const TextureStore& textureStore);
 
     // Prevent copying
     EntityRenderer(const EntityRenderer&) = delete;
     EntityRenderer& operator=(const EntityRenderer&) = delete;
 
-    void render(const Camera& camera, SharedEntityList entities, int delta) const;
+    /**
+     * Renders the Entities in a snapshot.
+     *
+     * @param delta Time since the snapshot was published, in milliseconds.
+     */
+    void render(const RenderSnapshot& snapshot, int delta) const;
 
     static glm::vec2 getLerpOffset(const Entity& entity, int delta);
+    static glm::vec2 getLerpOffset(const MapNode& pos, const Movement& movement, int delta);
 
 private:
-    bool isEntityVisible(const Entity& entity, const Camera& camera) const;
-    void renderEntity(const Entity& entity, int delta) const;
-    bool needsUpdate(const Entity& entity, const SpriteComponent& spriteComponent) const;
-    void sendDataToGpu(const Entity& entity, const SpriteComponent& spriteComponent, int delta) const;
-    bool isEntityUnderMouse(const Entity& entity) const;
-    void renderHitbox(const Entity& entity) const;
+    bool isEntityVisible(const MapNode& pos, const Camera& camera) const;
+    void addToBatch(const EntityRenderState& entity, int delta) const;
+    void renderBatch(const Spritesheet& spritesheet, int paletteIndex, int numSprites) const;
+    const SpriteRenderable& getBatchRenderable(const Spritesheet& spritesheet) const;
+    void usePalette(int paletteIndex) const;
+    void renderHitbox(const EntityRenderState& entity) const;
 
 private:
     static constexpr int numHitboxSprites = 4;
 
+    /** Maximum number of Entities that can be drawn in a single batch. */
+    static constexpr int maxSpritesPerBatch = 256;
+
     std::shared_ptr<const Texture> paletteTexture;
-    const PlayerContext& playerContext;
 
     SpriteRenderable hitboxRenderable;
+
+    /** Renderables used to draw batches of Entities, by Spritesheet. */
+    mutable std::unordered_map<const Spritesheet*, std::unique_ptr<SpriteRenderable>> batchRenderables;
+
+    /** Visible Entities in the snapshot being rendered, sorted into batches. */
+    mutable std::vector<const EntityRenderState*> visibleEntities;
+
+    // Vertex data for the batch being rendered
+    mutable std::vector<GLfloat> batchPositions;
+    mutable std::vector<GLfloat> batchTexCoords;
 };
 
 }  // namespace Rival
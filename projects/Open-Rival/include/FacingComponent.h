@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <string>
+#include <vector>
 
 #include "EntityComponent.h"
 #include "MapUtils.h"
@@ -33,6 +35,8 @@ public:
     // Begin EntityComponent override
     virtual void onEntitySpawned(World* world) override;
     virtual void onDelete() override;
+    virtual void saveState(std::vector<char>& buffer) const override;
+    virtual void restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset) override;
     // End EntityComponent override
 
     // Begin MovementComponent override
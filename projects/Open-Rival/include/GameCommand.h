@@ -11,7 +11,9 @@ namespace Rival {
 enum class GameCommandType : std::uint8_t
 {
     Invalid,
-    Move
+    Move,
+    SetCommandDelay,
+    GroupMove
 };
 
 /**
@@ -19,6 +21,9 @@ enum class GameCommandType : std::uint8_t
  */
 class GameCommandContext : public WorldStore
 {
+public:
+    /** Sets the number of ticks in the future that new commands should be scheduled for in a net game. */
+    virtual void setCommandDelay(int commandDelay) = 0;
 };
 
 /**
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "EntityRenderer.h"
 #include "Framebuffer.h"
 #include "FramebufferRenderer.h"
@@ -16,27 +19,50 @@ class Resources;
 class Window;
 class World;
 struct PlayerContext;
+struct RenderSnapshot;
 
+/**
+ * Renders the game.
+ *
+ * The game world is rendered from a RenderSnapshot, but the UI still reads the live game state.
+ */
 class GameRenderer
 {
 public:
+    /**
+     * Creates a GameRenderer for the given World.
+     *
+     * The World is only read here; after that, it is only ever seen through RenderSnapshots.
+     */
     GameRenderer(
             const Window* window,
             const World& world,
             const PlayerStore& playerStore,
-            const Camera& camera,
             const Rect& viewport,
             const Resources& res,
             const PlayerContext& playerContext);
 
-    void render(int delta);
+    /**
+     * Renders the game world.
+     *
+     * @param delta Time since the snapshot was published, in milliseconds.
+     */
+    void renderWorld(const RenderSnapshot& snapshot, int delta) const;
+
+    /**
+     * Renders the UI on top of the game world.
+     *
+     * This reads the live game state, so it must not run at the same time as the simulation.
+     *
+     * @param overlayLines Lines of diagnostic text to show in the corner of the screen, if any.
+     */
+    void renderInterface(int delta, const std::vector<std::string>& overlayLines);
 
 private:
-    void renderGameViaFramebuffer(int delta) const;
-    void renderGame(int viewportWidth, int viewportHeight, int delta) const;
+    void renderGame(const RenderSnapshot& snapshot, int viewportWidth, int viewportHeight, int delta) const;
     void renderFramebuffer(int srcWidth, int srcHeight) const;
     void renderUi();
-    void renderText();
+    void renderText(const std::vector<std::string>& overlayLines);
     void renderCursor(int delta);
 
 private:
@@ -47,9 +73,7 @@ private:
     static constexpr int framebufferHeight = RenderUtils::tileHeightPx * RenderUtils::maxTilesY / 2;
 
     const Window* window;
-    const World& world;
     const Rect& viewport;
-    const Camera& camera;
 
     /**
      * Framebuffer to which the visible region of the game is rendered at
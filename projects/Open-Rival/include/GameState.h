@@ -2,22 +2,34 @@
 
 #include "SDLWrapper.h"
 
+#include <array>
+#include <cstddef>  // std::size_t
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include "net/ClientInfo.h"
+#include "net/LatencyTracker.h"
+#include "net/NetTelemetry.h"
 #include "net/packet-handlers/PacketHandler.h"
+#include "net/packets/GameCommandPacket.h"
 #include "net/packets/Packet.h"
+#include "replay/ReplayReader.h"
+#include "replay/ReplayWriter.h"
 #include "Camera.h"
 #include "GameCommand.h"
 #include "GameRenderer.h"
+#include "LockstepScheduler.h"
 #include "MousePicker.h"
 #include "PlayerContext.h"
 #include "PlayerState.h"
 #include "Rect.h"
+#include "RenderSnapshotBuffer.h"
 #include "State.h"
+#include "TimeUtils.h"
 #include "World.h"
 
 namespace Rival {
@@ -44,6 +56,30 @@ struct Input
     Direction lastDirectionY = Direction::None;
 };
 
+/**
+ * Latency received from another client.
+ */
+struct LatencyReport
+{
+    std::uint32_t rttMs = 0;
+    std::uint32_t jitterMs = 0;
+};
+
+/**
+ * Statistics about the performance of a lockstep net game.
+ */
+struct LockstepMetrics
+{
+    /** Number of times we have had to wait for commands from other clients. */
+    int numStalls = 0;
+
+    /** Total time spent waiting for commands from other clients, in milliseconds. */
+    Uint32 totalStallMs = 0;
+
+    /** Number of times the command delay has changed. */
+    int numDelayChanges = 0;
+};
+
 /**
  * Application state active when in-game.
  */
@@ -61,6 +97,7 @@ public:
             std::unordered_map<int, PlayerState>& playerStates,
             std::unordered_map<int, ClientInfo> clients,
             int localPlayerId);
+    ~GameState();
 
     // Begin State override
     void onLoad() override;
@@ -71,6 +108,7 @@ public:
     void mouseWheelMoved(const SDL_MouseWheelEvent event) override;
     void update() override;
     void render(int delta) override;
+    bool supportsSimulationThread() const override;
     // End State override
 
     // Begin WorldStore override
@@ -88,20 +126,90 @@ public:
     void dispatchCommand(std::shared_ptr<GameCommand> command) override;
     // End GameCommandInvoker override
 
+    // Begin GameCommandContext override
+    void setCommandDelay(int commandDelay) override;
+    // End GameCommandContext override
+
+    void onPingReturned(std::uint32_t sendTime, std::uint32_t receiveTime);
+    void onLatencyReportReceived(int clientId, std::uint32_t rttMs, std::uint32_t jitterMs);
+
+    const LockstepMetrics& getLockstepMetrics() const
+    {
+        return lockstepMetrics;
+    }
+
+    /** Gets the network metrics for the last telemetry interval. */
+    const NetMetrics& getNetMetrics() const
+    {
+        return netMetrics;
+    }
+
     void scheduleCommand(std::shared_ptr<GameCommand> command, int tick);
-    void onClientReady(int tick, int clientId);
+
+    /** Records that we have received all commands from the given client for every tick in the given range. */
+    void onClientReady(int firstTick, int lastTick, int clientId);
+
+    /**
+     * Determines the tick of a GameCommandPacket received from another client, which is only sent relative to the
+     * previous packet from that client.
+     */
+    int resolveReceivedTick(int clientId, int tickDelta);
+
+    /** Records all executed commands to the given replay. */
+    void startRecording(std::unique_ptr<ReplayWriter> writer);
+
+    /** Plays back the given replay instead of accepting player input. */
+    void startReplay(std::shared_ptr<const ReplayReader> replay, bool fastForward);
+
+    /** Executes local commands immediately and rolls back the World whenever remote commands arrive late.
+     * All players in a net game must use the same setting. */
+    void enableRollback();
 
 private:
     bool isTickReady();
     void pollNetwork();
     void earlyUpdateEntities() const;
-    void updateEntities() const;
+    void updateEntities();
     void respondToInput();
     void sendOutgoingCommands();
+    void sendLatencyInfo();
+    void adjustCommandDelay();
+    void updateStallMetrics(bool tickReady);
+    void updateNetTelemetry();
+    void logNetMetrics() const;
+    void refreshNetOverlay();
+    void scheduleReplayCommands();
+    void simulateTick();
     void processCommands();
+    int getCommandDelay() const;
+    void saveSnapshot();
+    void rollBack();
+    void confirmTicks();
+    void checkReplayFinished();
+    void publishRenderSnapshot();
     bool isNetGame() const;
+    bool isReplay() const;
+    bool canQuickSave() const;
+    void quickSave() const;
+    void quickLoad();
 
 private:
+    /** Interval at which clients measure and report their latency, in ticks. */
+    static constexpr int latencyIntervalTicks = TimeUtils::fps;
+
+    /** Interval at which the host reconsiders the command delay, in ticks.
+     * This must be longer than the command delay, so that any previous change has taken effect. */
+    static constexpr int commandDelayIntervalTicks = 2 * TimeUtils::fps;
+    static_assert(
+            commandDelayIntervalTicks > LockstepScheduler::maxCommandDelay, "Command delay interval is too short");
+
+    /** Number of multiples of the jitter that we allow for when choosing the command delay. */
+    static constexpr std::uint32_t jitterMultiplier = 4;
+
+    /** File used for quick saves.
+     * The saved World can only be restored into a game created from the same scenario. */
+    static constexpr const char* quickSaveFilename = "quicksave.sav";
+
     /** Map of client ID -> ClientInfo. */
     std::unordered_map<int, ClientInfo> clients;
 
@@ -126,18 +234,88 @@ private:
     /** Object that renders the game. */
     GameRenderer gameRenderer;
 
+    /** Snapshots of the World passed from the simulation to the renderer. */
+    RenderSnapshotBuffer renderSnapshots;
+
     /** Registered PacketHandlers by packet type. */
     std::unordered_map<PacketType, std::unique_ptr<PacketHandler>> packetHandlers;
 
-    /** Commands ready to be executed, indexed by the tick number when they are due. */
-    std::unordered_map<int, std::vector<std::shared_ptr<GameCommand>>> pendingCommands;
+    /** Packets received from the network during the current tick; this is kept to avoid reallocating every tick. */
+    std::vector<std::shared_ptr<const Packet>> receivedPackets;
+
+    /** Commands scheduled for upcoming ticks, and the clients we have heard from. */
+    LockstepScheduler scheduler;
+
+    /** World snapshots taken at the start of each of the last few ticks, indexed by tick number modulo the size.
+     * Only used when rollback is enabled. */
+    std::array<std::vector<char>, LockstepScheduler::maxRollbackTicks + 1> snapshots;
+
+    /** Entities removed from the World during each of the last few ticks, indexed like `snapshots`.
+     * These are kept intact until no snapshot contains them, in case a rollback needs to bring them back.
+     * Only used when rollback is enabled. */
+    std::array<SharedMutableEntityList, LockstepScheduler::maxRollbackTicks + 1> removedEntities;
+
+    /** Earliest tick for which we have not yet received commands from all clients.
+     * Only used when rollback is enabled. */
+    int firstUnconfirmedTick = 0;
 
-    /** Clients for whom we have received commands, indexed by tick number. */
-    std::unordered_map<int, std::unordered_set<int>> clientsReady;
+    /** Earliest past tick for which late commands have been received, or -1 if no rollback is needed. */
+    int rollbackTick = -1;
 
     /** Commands queued for sending over the network. */
     std::vector<std::shared_ptr<GameCommand>> outgoingCommands;
 
+    /** Number of ticks in the future that local commands are scheduled for in a lockstep net game. */
+    int commandDelay = TimeUtils::netCommandDelay;
+
+    /** Our own latency to the relay server. */
+    LatencyTracker latencyTracker;
+
+    /** Latest latency reported by each other client, by client ID. Only used by the host. */
+    std::unordered_map<int, LatencyReport> latencyReports;
+
+    /** Whether we are currently waiting for commands from other clients. */
+    bool stalled = false;
+
+    /** Time at which we started waiting for commands from other clients, in milliseconds. */
+    Uint32 stallStartTime = 0;
+
+    /** Lockstep performance statistics. */
+    LockstepMetrics lockstepMetrics;
+
+    /** Collects network telemetry during a net game. */
+    NetTelemetry netTelemetry;
+
+    /** Network metrics for the last telemetry interval. */
+    NetMetrics netMetrics;
+
+    /** Time at which the network metrics were last collected, in milliseconds. */
+    Uint32 lastNetMetricsTime = 0;
+
+    /** Time at which the network metrics were last logged, in milliseconds. */
+    Uint32 lastNetLogTime = 0;
+
+    /** Whether the network telemetry overlay is visible. */
+    bool netOverlayVisible = false;
+
+    /** Text shown by the network telemetry overlay; this is only rebuilt when new metrics are collected. */
+    std::vector<std::string> netOverlayLines;
+
+    /** Replay to which executed commands are recorded, if any. */
+    std::unique_ptr<ReplayWriter> replayWriter;
+
+    /** Replay being played back, if any. */
+    std::shared_ptr<const ReplayReader> replayReader;
+
+    /** Index of the next ReplayTick to be scheduled from the replay. */
+    std::size_t nextReplayTickIndex = 0;
+
+    /** Whether the replay is being played back as fast as possible. */
+    bool fastForwardReplay = false;
+
+    /** Time at which replay playback started, in milliseconds. */
+    Uint32 replayStartTime = 0;
+
     /** The current player input. */
     Input input = {};
 
@@ -145,9 +323,6 @@ private:
      * In a single-player game or when hosting, this is always zero. When joining a net game, this is allocated by the
      * server. */
     int localPlayerId = 0;
-
-    /** Tick number, incremented with each update. */
-    int currentTick = 0;
 };
 
 }  // namespace Rival
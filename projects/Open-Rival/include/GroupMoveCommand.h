@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "GameCommand.h"
+#include "MapUtils.h"
+#include "Pathfinding.h"
+
+namespace Rival {
+
+class MovementComponent;
+
+/**
+ * Command to move a group of units to the same place.
+ *
+ * Only the first unit (the leader) plans a route to the destination. The other units keep their position relative
+ * to the leader, moving along a copy of its route shifted sideways, and end up in formation around the destination.
+ * Units that cannot follow the leader's route (e.g. because they are too far away, or the shifted route is blocked)
+ * instead take the nearest free tile to the destination, and find their own way there.
+ */
+class GroupMoveCommand : public GameCommand
+{
+public:
+    GroupMoveCommand(std::vector<int> entityIds, MapNode destination);
+
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<GroupMoveCommand>
+    deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
+    // Begin GameCommand override
+    void execute(GameCommandContext& context) override;
+    // End GameCommand override
+
+    const std::vector<int>& getEntityIds() const
+    {
+        return entityIds;
+    }
+
+    MapNode getDestination() const
+    {
+        return destination;
+    }
+
+public:
+    /** Maximum number of units in a group.
+     * This ensures that a single command always fits within a packet, whatever the entity IDs. */
+    static constexpr std::size_t maxGroupSize = 64;
+
+    /** Maximum distance from the leader, in rows, at which a unit can follow the leader's route.
+     * Units further away than this would end up too far from the destination. */
+    static constexpr int maxFormationSpread = 4;
+
+private:
+    bool followLeader(
+            const World& world,
+            MovementComponent& follower,
+            MapNode leaderStart,
+            const Pathfinding::Route& leaderRoute,
+            std::unordered_set<MapNode>& claimedTiles) const;
+
+private:
+    std::vector<int> entityIds;
+    MapNode destination;
+};
+
+}  // namespace Rival
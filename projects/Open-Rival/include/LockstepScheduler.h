@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "net/packets/GameCommandPacket.h"
+#include "TimeUtils.h"
+
+namespace Rival {
+
+class GameCommand;
+
+/**
+ * Commands and client readiness for a single scheduled tick.
+ */
+struct ScheduledTick
+{
+    /** Commands due to be executed during this tick. */
+    std::vector<std::shared_ptr<GameCommand>> commands;
+
+    /** Bitmask of clients for whom we have received commands, indexed by client ID. */
+    std::uint32_t clientsReady = 0;
+};
+
+/**
+ * The ticks covered by an outgoing GameCommandPacket.
+ */
+struct SendTick
+{
+    /** Tick for which the packet's commands are scheduled. */
+    int tick = 0;
+
+    /** Tick of the previous packet; the packet promises that there are no commands for any of the ticks between. */
+    int previousTick = 0;
+};
+
+/**
+ * Keeps track of which commands are scheduled for which tick in a lockstep game, and which clients we have heard from.
+ *
+ * Each client sends its commands for a tick in the future, and no client can simulate a tick until it has received the
+ * commands for that tick from every other client. An idle client can cover several ticks with a single packet.
+ *
+ * This knows nothing about the World or how commands are sent, so it can be driven by a headless client just as well
+ * as by the GameState.
+ */
+class LockstepScheduler
+{
+public:
+    /** Adds a client from whom we expect commands each tick. */
+    void addClient(int clientId);
+
+    /** Lets the current tick run ahead of the other clients, so that late commands have to be rolled back.
+     * Local commands must then be sent straight away, so idle ranges are disabled. */
+    void enableRollback();
+
+    bool isRollbackEnabled() const
+    {
+        return rollbackEnabled;
+    }
+
+    /** Sets whether an idle client covers several ticks with a single packet, instead of sending one every tick. */
+    void setIdleRangesEnabled(bool enabled)
+    {
+        idleRangesEnabled = enabled;
+    }
+
+    int getCurrentTick() const
+    {
+        return currentTick;
+    }
+
+    /** Moves on to the next tick. */
+    void advanceTick()
+    {
+        ++currentTick;
+    }
+
+    /** Returns to an earlier tick so that it can be re-simulated, or back to the present afterwards. */
+    void setCurrentTick(int tick)
+    {
+        currentTick = tick;
+    }
+
+    /**
+     * Gets the commands and client readiness for the given tick.
+     *
+     * @throws std::runtime_error if the tick is outside the scheduling window.
+     */
+    ScheduledTick& getScheduledTick(int tick);
+
+    /** Determines if we have received commands from every client for the given tick. */
+    bool isTickConfirmed(int tick);
+
+    /** Gets a bitmask of the clients from whom we are still waiting for commands for the given tick. */
+    std::uint32_t getMissingClients(int tick);
+
+    /** Determines if we have received everything we need to run the current tick without rolling back. */
+    bool isCurrentTickReady();
+
+    void scheduleCommand(std::shared_ptr<GameCommand> command, int tick);
+
+    /** Records that we have received all commands from the given client for every tick in the given range. */
+    void onClientReady(int firstTick, int lastTick, int clientId);
+
+    /**
+     * Determines the tick of a GameCommandPacket received from another client, which is only sent relative to the
+     * previous packet from that client.
+     */
+    int resolveReceivedTick(int clientId, int tickDelta);
+
+    /**
+     * Decides which tick our next GameCommandPacket should be sent for, and records that it has been sent.
+     *
+     * Returns nothing if we have already sent a packet covering the tick that is `commandDelay` ticks away, in which
+     * case any commands have to wait until we catch up.
+     */
+    std::optional<SendTick> takeSendTick(int commandDelay, bool hasCommands);
+
+    /** Clears the tick that has just fallen out of the rollback window, so that its slot can be re-used. */
+    void clearExpiredTick();
+
+public:
+    /** Maximum number of ticks in the future for which commands can be scheduled.
+     * In the worst case, another client can be `maxCommandDelay + maxIdleRangeTicks` ticks ahead of us (if we have
+     * promised to be idle), and it can promise to be idle until `maxCommandDelay + maxIdleRangeTicks` ticks ahead of
+     * that. */
+    static constexpr int maxScheduledTicks = 64;
+
+    /** Minimum command delay chosen by the host, in ticks. */
+    static constexpr int minCommandDelay = 2;
+
+    /** Maximum command delay chosen by the host, in ticks. Beyond this, games will stall. */
+    static constexpr int maxCommandDelay = 15;
+
+    /** Maximum number of ticks that we will promise to be idle for in a single GameCommandPacket.
+     * Any command issued during this time has to wait until the end of the range, so this is a trade-off between
+     * traffic and responsiveness. */
+    static constexpr int maxIdleRangeTicks = 10;
+
+    /** Maximum number of ticks that we can run ahead of the last tick for which all commands are known.
+     * Remote commands can only arrive for a tick within this window, so we only keep this many snapshots. */
+    static constexpr int maxRollbackTicks = TimeUtils::netCommandDelay;
+
+    /** Maximum number of clients, limited by the size of the readiness bitmask. */
+    static constexpr int maxClients = 32;
+
+private:
+    /** Ring buffer of upcoming ticks, indexed by tick number modulo `maxScheduledTicks`.
+     * Commands can only ever be scheduled a bounded number of ticks into the future, so there is no need to allocate
+     * storage per tick. */
+    std::array<ScheduledTick, maxScheduledTicks> scheduledTicks;
+
+    /** Bitmask of all clients from whom we expect commands each tick. */
+    std::uint32_t allClientsMask = 0;
+
+    /** Whether rollback is enabled. */
+    bool rollbackEnabled = false;
+
+    /** Whether an idle client covers several ticks with a single packet. */
+    bool idleRangesEnabled = true;
+
+    /** Tick number, incremented with each update. */
+    int currentTick = 0;
+
+    /** Next tick for which we have not yet sent our commands. */
+    int nextSendTick = TimeUtils::netCommandDelay;
+
+    /** Tick of the last GameCommandPacket we sent; each packet is sent relative to the one before. */
+    int lastSentTick = GameCommandPacket::initialPreviousTick;
+
+    /** Number of ticks for which we have sent no commands since we last sent any. */
+    int numIdleTicks = 0;
+
+    /** Tick of the last GameCommandPacket received from each other client, by client ID. */
+    std::unordered_map<int, int> lastReceivedTicks;
+};
+
+}  // namespace Rival
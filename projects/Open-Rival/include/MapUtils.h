@@ -109,7 +109,7 @@ struct hash<Rival::MapNode>
     {
         // Given that x/y will never exceed 16 bits, this ought to give a
         // totally unique value for each node.
-        return node.x | (node.y << 16);
+        return static_cast<std::size_t>(node.x | (node.y << 16));
     }
 };
 
@@ -1,9 +1,9 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "EntityComponent.h"
-#include "GameCommand.h"
 #include "MovementComponent.h"
 #include "PlayerState.h"
 #include "Rect.h"
@@ -13,7 +13,6 @@ namespace Rival {
 
 class Camera;
 class OwnerComponent;
-class SpriteComponent;
 class VoiceComponent;
 struct MapNode;
 
@@ -30,6 +29,7 @@ public:
     // Begin EntityComponent override
     virtual void onEntitySpawned(World* world) override;
     virtual void onDelete() override;
+    virtual void onStateRestored() override;
     // End EntityComponent override
 
     // Begin MovementComponent override
@@ -54,9 +54,11 @@ public:
 
     /**
      * Called when a tile is clicked, with this Entity selected.
+     *
+     * Returns true if this Entity should move to the tile. Selected entities are moved together, so it is up to the
+     * caller to issue the command.
      */
-    void onTileClicked(
-            GameCommandInvoker& cmdInvoker, const PlayerStore& playerStore, const MapNode& tilePos, bool isLeader);
+    bool onTileClicked(const PlayerStore& playerStore, bool isLeader);
 
 private:
     const Rect createHitbox() const;
@@ -76,7 +78,6 @@ private:
 
     std::weak_ptr<MovementComponent> weakMovementComponent;
     std::weak_ptr<OwnerComponent> weakOwnerComponent;
-    std::weak_ptr<SpriteComponent> weakSpriteComponent;
     std::weak_ptr<VoiceComponent> weakVoiceComponent;
 
     mutable Rect hitbox;
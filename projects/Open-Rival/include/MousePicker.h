@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "EntityUtils.h"
 #include "MapUtils.h"
@@ -58,6 +59,7 @@ private:
 
     void selectEntities(WeakMutableEntityList& entities);
     void tileSelected();
+    void moveEntities(const std::vector<int>& entityIds, const MapNode& tile);
     void deselect();
 
     void processDragSelectArea();
@@ -1,11 +1,11 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <vector>
 
 #include "GameCommand.h"
-
-class MapNode;
+#include "MapUtils.h"
 
 namespace Rival {
 
@@ -15,7 +15,7 @@ public:
     MoveCommand(int entityId, MapNode destination);
 
     void serialize(std::vector<char>& buffer) const override;
-    static std::shared_ptr<MoveCommand> deserialize(std::vector<char> buffer, size_t& offset);
+    static std::shared_ptr<MoveCommand> deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset);
 
     // Begin GameCommand override
     void execute(GameCommandContext& context) override;
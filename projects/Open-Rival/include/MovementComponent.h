@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "EntityComponent.h"
 #include "Pathfinding.h"
@@ -56,6 +58,8 @@ public:
 
     // Begin EntityComponent override
     void update() override;
+    void saveState(std::vector<char>& buffer) const override;
+    void restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset) override;
     // End EntityComponent override
 
     void addListener(MovementListener* listener);
@@ -63,6 +67,18 @@ public:
 
     void moveTo(MapNode node);
 
+    /**
+     * Follows a route that has already been planned, instead of finding one.
+     *
+     * The route must start from a neighbor of `getStartPosForNextMovement()`.
+     */
+    void setRoute(Pathfinding::Route route);
+
+    /**
+     * Gets the tile from which the next route should start.
+     */
+    MapNode getStartPosForNextMovement() const;
+
     /**
      * Gets the movement that's currently in progress.
      */
@@ -71,9 +87,23 @@ public:
         return movement;
     }
 
+    /**
+     * Gets the route that is currently being followed.
+     */
+    const Pathfinding::Route& getRoute() const
+    {
+        return route;
+    }
+
+    /**
+     * Gets the object used to determine which tiles this unit can pass through.
+     */
+    const Pathfinding::PassabilityChecker& getPassabilityChecker() const
+    {
+        return passabilityChecker;
+    }
+
 private:
-    MapNode getStartPosForNextMovement() const;
-    void setRoute(Pathfinding::Route route);
     void updateMovement();
     bool prepareNextMovement();
     void completeMovement();
@@ -59,6 +59,14 @@ public:
         return destination;
     }
 
+    /**
+     * Gets the remaining path.
+     */
+    const std::deque<MapNode>& getPath() const
+    {
+        return path;
+    }
+
     /**
      * Removes the next MapNode from the path and returns it.
      */
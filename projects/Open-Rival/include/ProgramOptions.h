@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <string>
 
+#include "replay/ReplaySettings.h"
+
 namespace Rival {
 
 class ProgramOptions
@@ -42,6 +44,33 @@ public:
         return port;
     }
 
+    int getRoomId() const
+    {
+        return roomId;
+    }
+
+    /** Whether to communicate with the server using UDP instead of TCP. */
+    bool isUdp() const
+    {
+        return udp;
+    }
+
+    /** Percentage of outgoing datagrams to drop, for testing. */
+    int getPacketLossPercent() const
+    {
+        return packetLossPercent;
+    }
+
+    const ReplaySettings& getReplaySettings() const
+    {
+        return replaySettings;
+    }
+
+    bool isRollbackEnabled() const
+    {
+        return rollback;
+    }
+
 private:
     const std::string parseArgs(int argc, char* argv[]);
     int parseInt(int argc, char* argv[], int index, int min, int max) const;
@@ -55,6 +84,11 @@ private:
     bool host = false;
     std::string hostAddress;
     uint16_t port = 25565;
+    int roomId = 0;
+    bool udp = false;
+    int packetLossPercent = 0;
+    ReplaySettings replaySettings;
+    bool rollback = false;
 };
 
 }  // namespace Rival
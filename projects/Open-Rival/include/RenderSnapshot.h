@@ -0,0 +1,67 @@
+#pragma once
+
+#include "SDLWrapper.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Camera.h"
+#include "MapUtils.h"
+#include "MovementComponent.h"
+#include "Rect.h"
+#include "Tile.h"
+
+namespace Rival {
+
+class Spritesheet;
+
+/**
+ * Everything needed to render a single Entity, copied out of the World at the end of a tick.
+ */
+struct EntityRenderState
+{
+    MapNode pos;
+
+    /** Spritesheet to render from. This belongs to the Resources, so it outlives any Entity. */
+    const Spritesheet* spritesheet = nullptr;
+
+    int txIndex = 0;
+
+    int paletteIndex = 0;
+
+    /** Movement in progress, used to interpolate the Entity's position between ticks. */
+    Movement movement;
+
+    /** Whether the Entity is under the mouse, in which case its hitbox should be drawn. */
+    bool underMouse = false;
+
+    /** Hitbox to draw, in pixels. Only set if the Entity is under the mouse. */
+    Rect hitbox;
+};
+
+/**
+ * Compact copy of the visible game state, published by the simulation for the renderer.
+ *
+ * This contains only plain data, so it can be read on the render thread while the next tick is simulated.
+ */
+struct RenderSnapshot
+{
+    /** Time at which this snapshot was published, in milliseconds. */
+    Uint32 time = 0;
+
+    /** The camera at the time of this snapshot.
+     * This is optional only because Cameras cannot be default-constructed. */
+    std::optional<Camera> camera;
+
+    std::vector<EntityRenderState> entities;
+
+    /** Copy of the World's tiles.
+     * This is only copied again when the World's tiles version changes, which is rare. */
+    std::vector<Tile> tiles;
+
+    /** Version of the World's tiles that were copied into this snapshot. */
+    std::uint32_t tilesVersion = 0;
+};
+
+}  // namespace Rival
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+
+#include "RenderSnapshot.h"
+
+namespace Rival {
+
+/**
+ * Passes RenderSnapshots from the simulation thread to the render thread.
+ *
+ * This is double-buffered: the simulation writes the next snapshot while the renderer reads the latest one. A third
+ * slot holds a finished snapshot that the renderer has not yet picked up, so neither thread ever has to wait for the
+ * other to finish with a snapshot; the mutex is only held long enough to swap 2 indices.
+ *
+ * Snapshots are recycled rather than reallocated, so the entity list only needs to grow until it is large enough.
+ */
+class RenderSnapshotBuffer
+{
+public:
+    /**
+     * Gets the snapshot that should be filled in by the simulation.
+     *
+     * The contents are left over from an older snapshot and should be overwritten.
+     */
+    RenderSnapshot& getWriteSnapshot();
+
+    /**
+     * Makes the snapshot returned by getWriteSnapshot available to the renderer.
+     */
+    void publish();
+
+    /**
+     * Gets the most recently published snapshot.
+     *
+     * The returned snapshot remains valid until the next call to this method.
+     */
+    const RenderSnapshot& getLatest();
+
+private:
+    static constexpr int numSnapshots = 3;
+
+    std::array<RenderSnapshot, numSnapshots> snapshots;
+
+    /** Index of the snapshot being written by the simulation. */
+    int writeIndex = 0;
+
+    /** Index of the most recently published snapshot that has not yet been picked up by the renderer. */
+    int pendingIndex = 1;
+
+    /** Index of the snapshot being read by the renderer. */
+    int readIndex = 2;
+
+    /** Whether the pending snapshot is newer than the one being read. */
+    bool pendingIsNew = false;
+
+    /** Guards pendingIndex and pendingIsNew. */
+    std::mutex mutex;
+};
+
+}  // namespace Rival
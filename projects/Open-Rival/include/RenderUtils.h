@@ -42,8 +42,10 @@ static constexpr int cursorHeightPx = 32;
 static constexpr int menuHeight = 600;
 
 // Render limits.
-// These define the maximum number of tiles that can ever be rendered
-// at one time, and, by extension, the limits of our camera.
+// These define the maximum number of tiles that can ever be visible at
+// one time, and, by extension, the limits of our camera. They determine
+// the size of the framebuffer and the range of depth values used for
+// entities; tiles themselves can be rendered for a map of any size.
 // For now, this is set to the maximum map size in the original game.
 static constexpr int maxTilesX = 210;
 static constexpr int maxTilesY = 134;
@@ -16,6 +16,7 @@ class ScenarioReader
 
 public:
     ScenarioReader(const std::string filename);
+    ScenarioReader(std::vector<unsigned char> data);
 
     ScenarioData readScenario();
 
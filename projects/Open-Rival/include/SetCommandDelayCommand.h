@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <memory>
+#include <vector>
+
+#include "GameCommand.h"
+
+namespace Rival {
+
+/**
+ * Command issued by the host to change the command delay used in a net game.
+ *
+ * Since this is executed by every client during the same tick, all clients change their command delay at the same
+ * point in the game.
+ */
+class SetCommandDelayCommand : public GameCommand
+{
+public:
+    SetCommandDelayCommand(int commandDelay);
+
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<SetCommandDelayCommand>
+    deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
+    // Begin GameCommand override
+    void execute(GameCommandContext& context) override;
+    // End GameCommand override
+
+private:
+    int commandDelay;
+};
+
+}  // namespace Rival
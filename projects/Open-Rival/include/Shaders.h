@@ -61,6 +61,45 @@ public:
 
 extern IndexedTextureShader indexedTextureShader;
 
+///////////////////////////////////////////////////////////////////////////
+// TilemapShader:
+// Renders the tiles of the map from a texture containing the texture
+// index of every tile, using the tile spritesheet and an accompanying
+// palette texture for color lookups.
+///////////////////////////////////////////////////////////////////////////
+
+class TilemapShader : public Shader
+{
+public:
+    // Vertex shader uniform locations
+    GLint viewProjMatrixUniformLoc = -1;
+
+    // Vertex shader attribute locations
+    GLint vertexAttribLoc = -1;
+
+    // Fragment shader uniform locations
+    GLint texUnitUniformLoc = -1;
+    GLint spritesheetColumnsUniformLoc = -1;
+    GLint spriteSizeUniformLoc = -1;
+    GLint spritePaddingUniformLoc = -1;
+    GLint paletteTexUnitUniformLoc = -1;
+    GLint paletteTxYUnitUniformLoc = -1;
+    GLint tileIndicesTexUnitUniformLoc = -1;
+    GLint columnWidthUniformLoc = -1;
+    GLint rowHeightUniformLoc = -1;
+
+    static void init();
+
+    bool isValid() const;
+
+    std::string getName() const override
+    {
+        return "TilemapShader";
+    }
+};
+
+extern TilemapShader tilemapShader;
+
 ///////////////////////////////////////////////////////////////////////////
 // FontShader:
 // Renders a single-channel font texture in a custom color.
@@ -1,20 +1,20 @@
 #pragma once
 
-#include <glm/vec2.hpp>
-
 #include <map>
 #include <string>
 
 #include "EntityComponent.h"
-#include "SpriteRenderable.h"
 #include "Unit.h"
 
 namespace Rival {
 
+class Spritesheet;
+
 /**
- * Component that links an Entity to a Renderable.
+ * Component that links an Entity to a Spritesheet.
  *
- * This ensures that all graphical resources are released automatically when an Entity is destroyed.
+ * This holds no graphical resources of its own, since Entities are updated on the simulation thread; the
+ * EntityRenderer owns the buffers used to draw them.
  *
  * Note that this does not contain any logic to set the txIndex; that must be handled elsewhere.
  */
@@ -23,7 +23,7 @@ class SpriteComponent : public EntityComponent
 public:
     SpriteComponent(const Spritesheet& spritesheet);
 
-    const SpriteRenderable& getRenderable() const;
+    const Spritesheet& getSpritesheet() const;
 
     int getTxIndex() const;
 
@@ -32,11 +32,8 @@ public:
 public:
     static const std::string key;
 
-    mutable bool dirty = true;
-    mutable glm::vec2 lastLerpOffset = { 0, 0 };
-
 private:
-    const SpriteRenderable renderable;
+    const Spritesheet& spritesheet;
 
     int txIndex = 0;
 };
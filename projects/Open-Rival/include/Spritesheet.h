@@ -20,6 +20,14 @@ public:
 
     const std::vector<GLfloat> getTexCoords(int index) const;
 
+    int getWidth() const;
+
+    int getHeight() const;
+
+    int getPadding() const;
+
+    int getColumns() const;
+
 public:
     std::shared_ptr<const Texture> texture;
 
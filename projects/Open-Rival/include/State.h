@@ -60,6 +60,17 @@ public:
      */
     virtual void render(int delta) = 0;
 
+    /**
+     * Determines whether update() can run on a separate thread to render().
+     *
+     * If so, update() and all input handlers are called while holding the Application's state mutex, but render() is
+     * not; it must either read state that was published for rendering, or take the mutex itself.
+     */
+    virtual bool supportsSimulationThread() const
+    {
+        return false;
+    }
+
 protected:
     Application& app;
     Window* window;
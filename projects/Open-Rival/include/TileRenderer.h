@@ -2,43 +2,69 @@
 
 #include <gl/glew.h>
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "RenderUtils.h"
 #include "SpriteRenderable.h"
+#include "Texture.h"
 #include "Tile.h"
 
 namespace Rival {
 
-class Camera;
-class Texture;
 class Spritesheet;
 
 /**
  * Class responsible for rendering Tiles.
  *
- * It renders all Tiles in a single draw operation.
+ * The texture index of every tile is stored in a texture, which is uploaded to the GPU when the renderer is created.
+ * The whole map is then rendered as a single quad, and the TilemapShader works out which part of which tile sprite
+ * belongs at each pixel. This means that the cost of rendering tiles depends only on the number of pixels drawn, and
+ * not on the size of the map.
+ *
+ * The tiles are expected to come from a RenderSnapshot, along with the World's tiles version. The texture is only
+ * checked for changes when this version changes, and then only the rows that have changed are uploaded again.
  */
 class TileRenderer
 {
 
 public:
-    // The maximum number of tiles we can render at once
-    static constexpr int maxTilesToRender = RenderUtils::maxTilesX * RenderUtils::maxTilesY;
+    // Texture unit used for the tile indices
+    static constexpr int tileIndicesTexUnit = 2;
 
-    TileRenderer(const Spritesheet& spritesheet, std::shared_ptr<const Texture> paletteTexture);
+    TileRenderer(
+            const Spritesheet& spritesheet,
+            std::shared_ptr<const Texture> paletteTexture,
+            const std::vector<Tile>& tiles,
+            std::uint32_t tilesVersion,
+            int mapWidth,
+            int mapHeight);
 
-    void render(const Camera& camera, const std::vector<Tile>& tiles, int mapWidth, int mapHeight) const;
+    void render(const std::vector<Tile>& tiles, std::uint32_t tilesVersion) const;
 
 private:
-    SpriteRenderable renderable;
+    static Texture createTileIndicesTexture(const std::vector<std::uint8_t>& txIndices, int mapWidth, int mapHeight);
+    static std::vector<std::uint8_t> getTxIndices(const std::vector<Tile>& tiles);
+
+    void sendChangedRowsToGpu(const std::vector<Tile>& tiles) const;
+
+private:
+    int mapWidth;
+    int mapHeight;
 
     std::shared_ptr<const Texture> paletteTexture;
 
-    bool TileRenderer::needsUpdate() const;
+    // A single quad covering the whole map
+    SpriteRenderable renderable;
+
+    // Texture index of every tile, as last sent to the GPU
+    mutable std::vector<std::uint8_t> uploadedTxIndices;
+
+    // Version of the tiles that were last sent to the GPU
+    mutable std::uint32_t uploadedTilesVersion;
 
-    void sendDataToGpu(const Camera& camera, const std::vector<Tile>& tiles, int mapWidth, int mapHeight) const;
+    Texture tileIndicesTexture;
 };
 
 }  // namespace Rival
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "SDLWrapper.h"
+#include <cstdint>
 
 namespace Rival { namespace TimeUtils {
 
@@ -18,9 +18,18 @@ static constexpr int timeStepMs = 1000 / fps;
  */
 static constexpr int minSleepTime = 2;
 
-/** Number of ticks in the future that commands are scheduled for in a network game. */
+/** Number of ticks in the future that commands are scheduled for in a network game.
+ * This is only the initial value; the command delay is adjusted during the game based on the measured latency. */
 static constexpr int netCommandDelay = 10;
 
+/**
+ * Gets a monotonic timestamp, in milliseconds, used for measuring network timings.
+ *
+ * Only the difference between 2 timestamps taken on the same machine is meaningful. Unsigned arithmetic means that
+ * differences remain correct even when the timestamp wraps around.
+ */
+std::uint32_t getNetTimestamp();
+
 /**
  * Allows for high-precision sleep timers.
  *
@@ -34,7 +43,7 @@ public:
     ~PrecisionTimer();
 
     /** Waits for some time (seconds) using the most appropriate mechanism available. */
-    void wait(Uint32 waitTimeMs);
+    void wait(std::uint32_t waitTimeMs);
 
 private:
     /** Sleeps for the given number of nanoseconds. */
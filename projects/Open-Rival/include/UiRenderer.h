@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "ui/CursorRenderer.h"
 #include "AtlasRenderable.h"
 #include "GameInterface.h"
@@ -29,7 +32,14 @@ public:
             const PlayerContext& playerContext);
 
     void renderUi();
-    void renderText();
+
+    /**
+     * Renders all UI text.
+     *
+     * @param overlayLines Lines of diagnostic text to show in the corner of the screen, if any.
+     */
+    void renderText(const std::vector<std::string>& overlayLines);
+
     void renderCursor(int delta);
 
 private:
@@ -55,6 +65,15 @@ private:
     // TMP: Portrait to show when multiple units are selected
     static constexpr int multiSelectionPortraitId = 108;
 
+    // Maximum number of lines of overlay text, and the maximum length of each
+    static constexpr int maxOverlayLines = 4;
+    static constexpr int maxOverlayLineLength = 96;
+
+    // Position of the first line of overlay text, and the spacing between lines (menu co-ordinates)
+    static constexpr float overlayX = 8.f;
+    static constexpr float overlayY = 24.f;
+    static constexpr float overlayRowHeight = 20.f;
+
     const PlayerStore& playerStore;
     const TextureStore& textureStore;
     const Window* window;
@@ -77,6 +96,9 @@ private:
     // Text
     TextProperties nameProperties;
     TextRenderable nameRenderable;
+    TextProperties overlayProperties;
+    std::vector<std::string> overlayText;
+    std::vector<TextRenderable> overlayRenderables;
     MenuTextRenderer textRenderer;
 
     // Cursor
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "EntityComponent.h"
 #include "FacingComponent.h"
@@ -29,6 +31,9 @@ public:
     virtual void onEntitySpawned(World* world) override;
     virtual void onDelete() override;
     virtual void update() override;
+    virtual void saveState(std::vector<char>& buffer) const override;
+    virtual void restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset) override;
+    virtual void onStateRestored() override;
     // End EntityComponent override
 
     // Begin UnitStateListener override
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <cstdint>  // uint8_t
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "EntityComponent.h"
 #include "MovementComponent.h"
@@ -43,6 +45,8 @@ public:
     // Begin EntityComponent override
     virtual void onEntitySpawned(World* scenario) override;
     virtual void onDelete() override;
+    virtual void saveState(std::vector<char>& buffer) const override;
+    virtual void restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset) override;
     // End EntityComponent override
 
     // Begin MovementListener override
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -48,6 +49,9 @@ struct PendingEntity
  */
 class World : public WritablePathfindingMap
 {
+
+    friend class WorldSnapshot;
+
 public:
     World(int width, int height, bool wilderness);
     World(int width, int height, bool wilderness, std::vector<Tile> tiles);
@@ -64,6 +68,16 @@ public:
         return tiles;
     }
 
+    /**
+     * Gets a number that changes whenever any of the tiles change.
+     *
+     * This allows observers to detect changes without comparing every tile.
+     */
+    std::uint32_t getTilesVersion() const
+    {
+        return tilesVersion;
+    }
+
     Tile getTile(int x, int y) const;
 
     bool isWilderness() const
@@ -158,6 +172,7 @@ private:
     const int height;
     bool wilderness;
     std::vector<Tile> tiles;
+    std::uint32_t tilesVersion = 0;
     std::vector<TilePassability> tilePassability;
 
     int nextId;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EntityUtils.h"
+
+namespace Rival {
+
+class World;
+
+/**
+ * Saves and restores the mutable state of a World in a compact binary format.
+ *
+ * A snapshot consists of:
+ *
+ *  - A header containing the format version, map dimensions and entity count.
+ *  - The raw tile and passability arrays, which are copied in bulk.
+ *  - A record for each Entity, containing its ID and the state of its EntityComponents.
+ *
+ * Snapshots are restored in-place into a World containing the same Entities as the World that was saved (for example,
+ * a World freshly created from the same scenario). This avoids having to recreate every Entity and its graphical
+ * resources, and means that restoring is little more than a memcpy.
+ *
+ * When rolling back, the World's Entities may have changed since the snapshot was taken. Entities spawned since then
+ * are deleted, and Entities removed since then can be brought back, as long as they are supplied to `restore` with
+ * their EntityComponents still attached.
+ *
+ * Snapshots should only be taken between ticks.
+ */
+class WorldSnapshot
+{
+public:
+    /** Writes a snapshot of the given World to the buffer, replacing its contents.
+     * The buffer's capacity is retained so it can be re-used for subsequent snapshots. */
+    static void save(const World& world, std::vector<char>& buffer);
+
+    /** Restores a snapshot previously written by `save`.
+     * removedEntities should contain any Entities that have been removed from the World since the snapshot was
+     * taken, without having been deleted.
+     * The snapshot is checked against the World before anything is restored, so if it is rejected, the World is left
+     * unchanged. */
+    static void restore(
+            World& world, const char* data, std::size_t size, const SharedMutableEntityList& removedEntities = {});
+
+    /** Writes a snapshot of the given World to a file. */
+    static void saveToFile(const World& world, const std::string& filename);
+
+    /** Restores a snapshot from a file, which is mapped into memory rather than read. */
+    static void restoreFromFile(World& world, const std::string& filename);
+
+public:
+    /** Identifier written at the start of every snapshot. */
+    static constexpr char magic[4] = { 'O', 'R', 'S', 'V' };
+
+    /** Snapshot format version. Should be incremented whenever the format or any saved component state changes. */
+    static constexpr std::uint32_t version = 1;
+};
+
+}  // namespace Rival
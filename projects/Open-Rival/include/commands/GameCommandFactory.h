@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <vector>
 
@@ -13,11 +14,11 @@ namespace Rival {
 class GameCommandFactory
 {
 public:
-    std::shared_ptr<GameCommand> deserialize(const std::vector<char>& buffer, size_t& offset) const;
+    std::shared_ptr<GameCommand> deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset) const;
 
 private:
-    std::shared_ptr<GameCommand>
-    deserializeFromType(const std::vector<char>& buffer, GameCommandType type, size_t& offset) const;
+    std::shared_ptr<GameCommand> deserializeFromType(
+            const char* buffer, std::size_t bufferSize, GameCommandType type, std::size_t& offset) const;
 };
 
 }  // namespace Rival
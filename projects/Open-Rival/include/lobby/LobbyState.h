@@ -2,12 +2,17 @@
 
 #include "SDLWrapper.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "net/ClientInfo.h"
+#include "net/ScenarioTransfer.h"
 #include "net/packets/Packet.h"
+#include "replay/ReplaySettings.h"
 #include "ui/MenuRenderer.h"
 #include "MenuTextRenderer.h"
 #include "PlayerState.h"
@@ -18,6 +23,7 @@ namespace Rival {
 
 class Application;
 class PacketHandler;
+class ReplayReader;
 
 /**
  * Application state active when in-game.
@@ -26,7 +32,12 @@ class LobbyState : public State
 {
 
 public:
-    LobbyState(Application& app, std::string playerName, bool host);
+    LobbyState(
+            Application& app,
+            std::string playerName,
+            bool host,
+            ReplaySettings replaySettings = {},
+            bool rollback = false);
 
     // Begin State override
     void onLoad() override;
@@ -40,6 +51,15 @@ public:
     void onPlayerRejected(int requestId, const std::string& playerName);
     void onWelcomeReceived(int playerId, std::unordered_map<int, ClientInfo> clients);
     void onPlayerKicked(int playerId);
+    void onStartGameReceived(bool rollbackEnabled);
+    void onScenarioInfoReceived(
+            int playerId,
+            const std::string& filename,
+            std::uint32_t scenarioSize,
+            std::uint32_t compressedSize,
+            std::uint32_t checksum);
+    void onScenarioChunkReceived(int playerId, std::uint32_t chunkIndex, const std::vector<char>& data);
+    void onScenarioAckReceived(int playerId, std::uint32_t chunksReceived);
     void startGame();
 
 private:
@@ -47,6 +67,9 @@ private:
     void pollNetwork();
     int requestPlayerId();
     void loadLevel(const std::string& filename);
+    void setScenario(std::vector<std::uint8_t> data);
+    void sendScenarioChunks();
+    bool isScenarioReceivedByAll() const;
     void requestStartGame();
     std::unique_ptr<State> createGameState() const;
     bool isNetGame() const;
@@ -59,9 +82,37 @@ private:
     int localPlayerId = -1;
     std::string localPlayerName;
 
+    /** Name of the selected scenario file, relative to the maps directory. */
+    std::string scenarioFilename;
+
+    /** Raw contents of the selected scenario file.
+     * This is empty until a client has received the scenario from the host. */
+    std::vector<std::uint8_t> scenarioFileData;
+
     /** The selected scenario. */
     ScenarioData scenarioData;
 
+    /** The selected scenario, compressed, ready to send to players who don't have it.
+     * Only populated for the host. */
+    std::shared_ptr<const std::vector<char>> compressedScenario;
+
+    /** Scenario being sent to each joining player, by player ID.
+     * Only populated for the host. */
+    std::unordered_map<int, ScenarioUpload> scenarioUploads;
+
+    /** Scenario being received from the host, if we didn't already have it. */
+    std::optional<ScenarioDownload> scenarioDownload;
+
+    /** Settings controlling replay recording and playback. */
+    ReplaySettings replaySettings;
+
+    /** The replay being watched, if any. */
+    std::shared_ptr<const ReplayReader> replayReader;
+
+    /** Whether a net game should use rollback instead of a fixed command delay.
+     * This is chosen by the host and sent to clients when the game starts. */
+    bool rollback;
+
     /** Map of client ID -> ClientInfo.
      * Does not include an entry for the local player. */
     std::unordered_map<int, ClientInfo> clients;
@@ -1,83 +1,240 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>  // std::size_t
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <random>
 #include <thread>
 #include <vector>
 
+#include "net/LoopbackLink.h"
 #include "net/PacketFactory.h"
+#include "net/ReliableChannel.h"
 #include "net/Socket.h"
 #include "net/packets/Packet.h"
+#include "utils/SpscQueue.h"
 
 namespace Rival {
 
-class Connection;
+/**
+ * Running totals of the traffic on a Connection.
+ */
+struct ConnectionStats
+{
+    std::uint64_t packetsSent = 0;
+    std::uint64_t bytesSent = 0;
+
+    /** Number of writes to the socket; each write may contain many packets. */
+    std::uint64_t socketWrites = 0;
+
+    std::uint64_t packetsReceived = 0;
+    std::uint64_t bytesReceived = 0;
+
+    /** Number of received packets waiting to be collected. */
+    std::size_t receiveQueueDepth = 0;
+
+    /** Highest number of received packets that have ever been waiting to be collected at once. */
+    std::size_t maxReceiveQueueDepth = 0;
+
+    /** Number of flushed blocks of packets waiting to be written. */
+    std::size_t sendQueueDepth = 0;
+
+    /** Highest number of flushed blocks of packets that have ever been waiting to be written at once. */
+    std::size_t maxSendQueueDepth = 0;
+};
 
 /**
- * Interface that provides a callback for when a connection receives a new packet.
+ * Transport used to communicate with the relay server.
  */
-class ConnectionListener
+enum class Transport : std::uint8_t
 {
-public:
-    virtual void onPacketReceived(Connection& connection, std::shared_ptr<const Packet> packet) = 0;
+    /**
+     * A TCP stream; simple, but a single lost segment holds up everything sent after it.
+     *
+     * Writes to the socket may block, so they are performed by a dedicated writer thread.
+     */
+    Tcp,
+
+    /**
+     * UDP datagrams, made reliable by a ReliableChannel.
+     *
+     * Every datagram repeats all unacknowledged data, so a lost datagram only delays the data by a single tick.
+     */
+    Udp,
+
+    /**
+     * A LoopbackLink to a relay server in the same process.
+     *
+     * No sockets or receive thread are involved; received packets are deserialized by whichever thread collects them.
+     */
+    Loopback
 };
 
 /**
- * Manages a connection to a socket and provides operations to read and write game-specific packets.
+ * Manages a client's connection to the relay server and provides operations to read and write game-specific packets.
+ *
+ * Neither sending nor receiving ever blocks the caller. Received packets are queued by a receive thread until they are
+ * collected, and when using TCP, flushed packets are queued for a writer thread. Both queues are bounded; packets can
+ * never be dropped, so if the game stops collecting packets the receive thread waits for it, and if the socket cannot
+ * keep up with the packets being sent, the connection is closed.
  */
 class Connection
 {
 public:
-    Connection(
-            Socket destination,
-            std::shared_ptr<PacketFactory> packetFactory,
-            int remotePlayerId = -1,
-            ConnectionListener* listener = nullptr);
+    Connection(Socket destination, std::shared_ptr<PacketFactory> packetFactory, Transport transport = Transport::Tcp);
+
+    /** Creates a connection to a relay server in the same process, using a link obtained from that server. */
+    Connection(std::shared_ptr<LoopbackLink> link, std::shared_ptr<PacketFactory> packetFactory);
     ~Connection();
 
-    bool Connection::operator==(const Connection& other) const;
-    bool Connection::operator!=(const Connection& other) const;
+    bool operator==(const Connection& other) const;
+    bool operator!=(const Connection& other) const;
 
     /** Closes this connection. */
     void close() noexcept;
 
     bool isOpen() const;
 
-    /** Sends a packet on this connection. */
+    /**
+     * Queues a packet to be sent on this connection.
+     *
+     * Packets are not sent until the next call to `flush`, so that all the packets produced during a tick can be
+     * sent in a single write.
+     */
     void send(const Packet& packet);
 
     /**
-     * Gets all packets received since the last call to this method.
+     * Sends all queued packets.
      *
-     * If this Connection has a listener, the packets will be sent there instead.
+     * When using TCP, the packets are handed to the writer thread, so this never waits for the socket.
+     *
+     * When using UDP, this should be called regularly even if nothing has been sent, since each call sends any
+     * acknowledgements that are owed and repeats any data that has not been acknowledged.
+     */
+    void flush();
+
+    /**
+     * Drops a proportion of outgoing datagrams at random, for testing.
+     *
+     * Only applies when using UDP.
      */
-    std::vector<std::shared_ptr<const Packet>> getReceivedPackets();
+    void setSimulatedPacketLoss(float lossChance);
+
+    ConnectionStats getStats() const;
+
+    /**
+     * Gets all packets received since the last call to this method, replacing the contents of the given vector.
+     *
+     * This never waits for the receive thread. Passing the same vector each time allows its storage to be reused, so
+     * that no memory needs to be allocated.
+     */
+    void getReceivedPackets(std::vector<std::shared_ptr<const Packet>>& packets);
+
+public:
+    /** Maximum buffer size when receiving data. Packets should never exceed this size. */
+    static constexpr std::size_t maxBufferSize = 512;
+
+    /**
+     * Maximum time to wait for a datagram before resending unacknowledged data.
+     *
+     * Data is normally resent whenever the connection is flushed; this just ensures that the data still arrives
+     * if the connection is not being flushed regularly.
+     */
+    static constexpr int datagramResendIntervalMs = 100;
+
+    /** Time after which the connection is closed if no datagrams have been received. */
+    static constexpr std::uint32_t datagramTimeoutMs = 10000;
+
+    /**
+     * Maximum number of received packets waiting to be collected.
+     *
+     * Every other player sends a few packets per tick, so this only fills up if the game stops collecting packets.
+     */
+    static constexpr std::size_t maxQueuedPackets = 1024;
+
+    /** Time to wait before trying again when the queue of received packets is full. */
+    static constexpr int queueFullWaitMs = 1;
+
+    /**
+     * Maximum number of flushed blocks of packets waiting to be written.
+     *
+     * The game flushes at most once per tick, so this is several seconds' worth; a socket that falls this far behind
+     * is never going to catch up.
+     */
+    static constexpr std::size_t maxQueuedWrites = 256;
 
 private:
     void receiveThreadLoop();
+    void receiveDatagramsLoop();
+    void writeThreadLoop();
+    void wakeWriteThread();
+    void recordSendQueueDepth(std::size_t queueDepth);
     bool readFromSocket(std::size_t numBytes);
+    void extractPacketsFromStream();
+    void onPacketReceived(const char* data, std::size_t size);
+    std::shared_ptr<Packet> deserializePacket(const char* data, std::size_t size);
+    void flushLoopback();
+    void receiveFromLoopback(std::vector<std::shared_ptr<const Packet>>& packets);
+    void sendDatagram();
+    bool isKeepAliveDue() const;
 
 private:
-    /** Maximum buffer size when receiving data. Packets should never exceed this size. */
-    static constexpr std::size_t maxBufferSize = 512;
-
     Socket socket;
     std::shared_ptr<PacketFactory> packetFactory;
+    Transport transport;
+
+    /** Link to the relay server, when using the loopback transport. */
+    std::shared_ptr<LoopbackLink> loopbackLink;
+
+    /** Reliability layer used when communicating over UDP. */
+    ReliableChannel channel;
+    std::mutex channelMutex;
 
+    /** Buffer used to send a single datagram. */
+    std::vector<char> datagramSendBuffer;
+    std::uint32_t lastDatagramSendTime = 0;
+
+    /** Data delivered by the ReliableChannel that has not yet been split into packets. */
+    std::vector<char> receivedStream;
+
+    /** Chance of dropping each outgoing datagram. */
+    float simulatedLossChance = 0.f;
+    std::mt19937 lossRandom;
+
+    /** Buffer used to serialize a single packet. */
     std::vector<char> sendBuffer;
+
+    /** Serialized packets waiting to be sent. */
+    std::vector<char> pendingSends;
+    std::mutex sendMutex;
+
     std::vector<char> recvBuffer;
 
     std::thread receiveThread;
-    std::vector<std::shared_ptr<const Packet>> receivedPackets;
-    std::mutex receivedPacketsMutex;
 
-    ConnectionListener* listener;
+    /** Packets passed from the receive thread to whichever thread collects them. */
+    SpscQueue<std::shared_ptr<const Packet>, maxQueuedPackets> receivedPackets;
+
+    /** Blocks of packets passed from `flush` to the writer thread. */
+    SpscQueue<std::shared_ptr<const std::vector<char>>, maxQueuedWrites> queuedWrites;
+
+    /** Used to wake the writer thread when there is something to write; never held while writing. */
+    std::mutex writeWakeMutex;
+    std::condition_variable writeWakeCondition;
+
+    std::thread writeThread;
 
-    /** Client ID of the player at the remote end of the connection.
-     * On clients this will always be -1 since the server has no client ID. */
-    int remoteClientId = -1;
+    std::atomic<std::uint64_t> packetsSent = 0;
+    std::atomic<std::uint64_t> bytesSent = 0;
+    std::atomic<std::uint64_t> socketWrites = 0;
+    std::atomic<std::uint64_t> packetsReceived = 0;
+    std::atomic<std::uint64_t> bytesReceived = 0;
+    std::atomic<std::size_t> maxReceiveQueueDepth = 0;
+    std::atomic<std::size_t> maxSendQueueDepth = 0;
 };
 
 }  // namespace Rival
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Rival {
+
+/**
+ * Keeps running estimates of the network latency between this client and the relay server.
+ *
+ * The round-trip time is smoothed in the same way as TCP's retransmission timer (RFC 6298), and jitter is estimated
+ * from the variation in transit time of packets stamped by the relay server (RFC 3550). Neither requires the clocks of
+ * the client and server to be synchronized.
+ */
+class LatencyTracker
+{
+public:
+    /** Adds a round-trip time measurement, in milliseconds. */
+    void addRttSample(std::uint32_t rttMs);
+
+    /** Adds a packet arrival, given the relay server's timestamp and the local time at which it arrived. */
+    void addArrival(std::uint32_t relayTime, std::uint32_t receiveTime);
+
+    /** Determines if any round-trip time measurements have been made yet. */
+    bool hasRtt() const
+    {
+        return rttSampled;
+    }
+
+    /** Gets the smoothed round-trip time, in milliseconds. */
+    std::uint32_t getRtt() const
+    {
+        return static_cast<std::uint32_t>(smoothedRtt);
+    }
+
+    /** Gets the estimated jitter of incoming packets, in milliseconds. */
+    std::uint32_t getJitter() const
+    {
+        return static_cast<std::uint32_t>(jitter);
+    }
+
+private:
+    bool rttSampled = false;
+    float smoothedRtt = 0;
+    float rttVariation = 0;
+
+    bool arrivalSampled = false;
+    std::uint32_t lastRelayTime = 0;
+    std::uint32_t lastReceiveTime = 0;
+    float jitter = 0;
+};
+
+}  // namespace Rival
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>  // std::size_t
+#include <memory>
+#include <vector>
+
+#include "utils/SpscQueue.h"
+
+namespace Rival {
+
+/**
+ * In-memory link between a Connection and a relay Server running in the same process.
+ *
+ * Data is passed in each direction through a lock-free queue, so no sockets are involved and neither side ever
+ * blocks the other. Each item is a block of complete packets, each prefixed by its size, exactly as they would be
+ * written to a TCP stream. Items are shared rather than copied, so the relay can pass on the very same buffer that
+ * it sends to every other client in the room.
+ *
+ * The Connection is the only producer for `toServer` and the only consumer for `toClient`; the Server's event loop
+ * is the other side of each queue.
+ */
+struct LoopbackLink
+{
+    /** Maximum number of blocks waiting in each direction. */
+    static constexpr std::size_t capacity = 1024;
+
+    using Block = std::shared_ptr<const std::vector<char>>;
+
+    /** Data sent by the client, waiting to be read by the server. */
+    SpscQueue<Block, capacity> toServer;
+
+    /** Data relayed to the client, waiting to be read by the client. */
+    SpscQueue<Block, capacity> toClient;
+
+    /** Set by either side to close the link; the other side notices the next time it checks. */
+    std::atomic<bool> closed = false;
+};
+
+}  // namespace Rival
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <string>
+
+#include "net/Connection.h"
+
+namespace Rival {
+
+/**
+ * Network performance of a net game, measured over the last telemetry interval.
+ */
+struct NetMetrics
+{
+    /** Traffic on our connection to the relay server. */
+    float packetsInPerSecond = 0;
+    float bytesInPerSecond = 0;
+    float packetsOutPerSecond = 0;
+    float bytesOutPerSecond = 0;
+
+    /** Smoothed round-trip time and jitter, or zero if no measurements have been made. */
+    std::uint32_t rttMs = 0;
+    std::uint32_t jitterMs = 0;
+
+    /** Most recent and highest round-trip times measured during the interval, or zero if there were none. */
+    std::uint32_t lastRttSampleMs = 0;
+    std::uint32_t maxRttSampleMs = 0;
+
+    /** Number of received packets waiting to be collected by the game, at the end of the interval. */
+    std::size_t receiveQueueDepth = 0;
+
+    /** Highest number of received packets ever waiting to be collected. */
+    std::size_t maxReceiveQueueDepth = 0;
+
+    /** Number of flushed blocks of packets waiting to be written, at the end of the interval. */
+    std::size_t sendQueueDepth = 0;
+
+    /** Highest number of flushed blocks of packets ever waiting to be written. */
+    std::size_t maxSendQueueDepth = 0;
+
+    /** Number of updates during which the game could not advance because commands were missing. */
+    int stalledUpdates = 0;
+
+    /** Client that held up the game for the most updates, or -1 if there were no stalls. */
+    int worstClientId = -1;
+
+    /** Number of updates spent waiting for `worstClientId`. */
+    int worstClientStalledUpdates = 0;
+};
+
+/**
+ * Collects telemetry during a net game, so that hitches can be diagnosed.
+ *
+ * Everything here is a plain counter that is updated at most once per update, and the totals are only turned into
+ * rates once per interval, so this is cheap enough to leave running in release builds.
+ */
+class NetTelemetry
+{
+public:
+    /** Adds a round-trip time measurement, in milliseconds. */
+    void addRttSample(std::uint32_t rttMs);
+
+    /** Records an update during which we were waiting for commands from the given clients (a bitmask of IDs). */
+    void addStalledUpdate(std::uint32_t missingClientsMask);
+
+    /**
+     * Calculates the metrics for the interval since the last call, and resets the counters.
+     *
+     * The smoothed round-trip time and jitter should be filled in by the caller.
+     */
+    NetMetrics collectMetrics(std::uint32_t elapsedMs, const ConnectionStats& connectionStats);
+
+    /** Formats the given metrics as a short, human-readable summary of the traffic on the connection. */
+    static std::string formatTraffic(const NetMetrics& metrics);
+
+    /** Formats the given metrics as a short, human-readable summary of the latency of the connection. */
+    static std::string formatLatency(const NetMetrics& metrics);
+
+    /** Formats the given metrics as a short, human-readable summary of the time spent waiting for other clients. */
+    static std::string formatStalls(const NetMetrics& metrics);
+
+public:
+    /** Interval at which the metrics should be collected, in milliseconds. */
+    static constexpr std::uint32_t metricsIntervalMs = 1000;
+
+    /** Interval at which the metrics should be logged, in milliseconds. */
+    static constexpr std::uint32_t logIntervalMs = 10000;
+
+    /** Maximum number of clients that can be tracked; client IDs must be below this. */
+    static constexpr int maxClients = 32;
+
+private:
+    /** Connection totals at the time of the last collection, used to work out what happened since. */
+    ConnectionStats lastConnectionStats;
+
+    std::uint32_t lastRttSampleMs = 0;
+    std::uint32_t maxRttSampleMs = 0;
+
+    int stalledUpdates = 0;
+
+    /** Number of stalled updates attributed to each client, indexed by client ID. */
+    std::array<int, maxClients> stalledUpdatesByClient = {};
+};
+
+}  // namespace Rival
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <vector>
 
@@ -14,10 +15,11 @@ namespace Rival {
 class PacketFactory
 {
 public:
-    std::shared_ptr<Packet> deserialize(const std::vector<char>& buffer) const;
+    /** Deserializes a packet from a buffer of the given size, which is not copied. */
+    std::shared_ptr<Packet> deserialize(const char* buffer, std::size_t bufferSize) const;
 
 private:
-    std::shared_ptr<Packet> deserializeFromType(const std::vector<char>& buffer, PacketType type) const;
+    std::shared_ptr<Packet> deserializeFromType(const char* buffer, std::size_t bufferSize, PacketType type) const;
 
 private:
     GameCommandFactory gameCommandFactory;
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "net/LoopbackLink.h"
+#include "net/ReliableChannel.h"
+#include "net/Socket.h"
+
+namespace Rival {
+
+/**
+ * A client connected to the relay server.
+ *
+ * The server never blocks on a client, so each client has its own buffers to hold partially-received packets and
+ * data that the socket was not yet ready to send.
+ *
+ * Outgoing packets are shared between all of their recipients, so each packet only needs to be serialized once.
+ * The server stops queueing packets for a client that has more than `maxPendingWriteBytes` waiting to be sent.
+ *
+ * Clients may instead communicate using datagrams, in which case they share the server's datagram socket and the
+ * data is sent through a ReliableChannel.
+ *
+ * A client in the same process as the server may instead communicate over a LoopbackLink, in which case no sockets
+ * are involved at all.
+ */
+class RelayClient
+{
+public:
+    /** Creates a client that communicates over its own connected socket. */
+    RelayClient(int token, Socket socket);
+
+    /** Creates a client that communicates using datagrams sent from the server's datagram socket. */
+    RelayClient(int token, Socket& datagramSocket, const SocketAddress& address);
+
+    /** Creates a client that communicates over a LoopbackLink. */
+    RelayClient(int token, std::shared_ptr<LoopbackLink> link);
+
+    ~RelayClient();
+
+    /** Gets the token that uniquely identifies this client's connection to the server. */
+    int getToken() const
+    {
+        return token;
+    }
+
+    /** Determines if this client has joined a room yet. */
+    bool isInRoom() const
+    {
+        return roomId >= 0;
+    }
+
+    int getRoomId() const
+    {
+        return roomId;
+    }
+
+    /** Gets the ID of this client within its room. */
+    int getClientId() const
+    {
+        return clientId;
+    }
+
+    void joinRoom(int newRoomId, int newClientId)
+    {
+        roomId = newRoomId;
+        clientId = newClientId;
+    }
+
+    const Socket& getSocket() const
+    {
+        return socket;
+    }
+
+    /** Determines if this client communicates using datagrams instead of its own socket. */
+    bool isDatagramClient() const
+    {
+        return datagramSocket != nullptr;
+    }
+
+    /** Determines if this client communicates over a LoopbackLink instead of a socket. */
+    bool isLoopbackClient() const
+    {
+        return loopbackLink != nullptr;
+    }
+
+    const SocketAddress& getAddress() const
+    {
+        return address;
+    }
+
+    /** Gets the time at which a datagram was last received from this client. */
+    std::uint32_t getLastReceiveTime() const
+    {
+        return lastReceiveTime;
+    }
+
+    /** Determines if any data sent to this datagram client is still waiting to be acknowledged. */
+    bool hasUnackedData() const
+    {
+        return channel.hasUnackedMessages();
+    }
+
+    /** Determines if the connection to this client has been lost. */
+    bool isConnectionLost() const
+    {
+        return connectionLost || (loopbackLink && loopbackLink->closed);
+    }
+
+    /** Flags this client for disconnection, e.g. because it sent invalid data. */
+    void disconnect()
+    {
+        connectionLost = true;
+    }
+
+    /** Reads all data that is currently available from the socket, returning the number of reads performed. */
+    int readFromSocket();
+
+    /** Reads all data that the client has passed over its LoopbackLink, returning the number of blocks read. */
+    int readFromLoopback();
+
+    /**
+     * Processes a datagram received from this client.
+     *
+     * @throws std::runtime_error if the datagram is malformed.
+     */
+    void receiveDatagram(const char* data, std::size_t size);
+
+    /**
+     * Extracts the next complete packet from the data received so far.
+     *
+     * @param packetData Filled with the packet data, excluding the packet size.
+     * @return True if a packet was extracted; false if the next packet has not been fully received yet.
+     * @throws std::runtime_error if the packet size is invalid.
+     */
+    bool nextPacket(std::vector<char>& packetData);
+
+    /** Queues a packet to be sent to this client. The packet data must not be modified once queued. */
+    void queueSend(std::shared_ptr<const std::vector<char>> data);
+
+    /**
+     * Sends as much queued data as the socket will accept, gathering several packets into each write.
+     *
+     * For datagram clients, all queued data is moved into the ReliableChannel, and a datagram is sent if there is
+     * new data, an acknowledgement is owed, or unacknowledged data is due to be resent.
+     *
+     * For loopback clients, queued packets are passed over the LoopbackLink as they are, without being copied.
+     *
+     * Returns the number of writes performed.
+     */
+    int flush();
+
+    /** Determines if there is queued data that has not yet been sent. */
+    bool hasPendingWrites() const
+    {
+        return !writeQueue.empty();
+    }
+
+    /**
+     * Gets the amount of data that has been queued for this client but not yet delivered, in bytes.
+     *
+     * For datagram clients, this includes any data that has been sent but not yet acknowledged.
+     */
+    std::size_t getPendingWriteBytes() const
+    {
+        return queuedBytes + channel.getUnackedBytes();
+    }
+
+    /** Whether the server is currently waiting for this client's socket to become writable. */
+    bool isWaitingToWrite() const
+    {
+        return waitingToWrite;
+    }
+
+    void setWaitingToWrite(bool waiting)
+    {
+        waitingToWrite = waiting;
+    }
+
+public:
+    /** Interval at which datagram clients are checked for unacknowledged data that is due to be resent. */
+    static constexpr std::uint32_t resendIntervalMs = 16;
+
+    /**
+     * Maximum amount of data that may be waiting to be delivered to a client, in bytes.
+     *
+     * This is several seconds' worth of traffic in a full game; a client that falls this far behind has already
+     * held up everyone else for a long time.
+     */
+    static constexpr std::size_t maxPendingWriteBytes = 64 * 1024;
+
+private:
+    void discardExtractedData();
+    int flushDatagrams();
+    int flushLoopback();
+
+private:
+    /** Number of bytes to read from the socket at a time. */
+    static constexpr std::size_t readChunkSize = 4096;
+
+    int token;
+    int roomId = -1;
+    int clientId = -1;
+    Socket socket;
+    bool connectionLost = false;
+    bool waitingToWrite = false;
+
+    /** Data received from the socket; everything before `readOffset` has already been extracted. */
+    std::vector<char> readBuffer;
+    std::size_t readOffset = 0;
+
+    /** Packets waiting to be sent to the socket.
+     * Everything before `writeOffset` in the first packet has already been sent. */
+    std::deque<std::shared_ptr<const std::vector<char>>> writeQueue;
+    std::size_t writeOffset = 0;
+
+    /** Total size of the packets in `writeQueue`. */
+    std::size_t queuedBytes = 0;
+
+    // Datagram clients only
+    Socket* datagramSocket = nullptr;
+    SocketAddress address;
+    ReliableChannel channel;
+    std::vector<char> pendingMessage;
+    std::vector<char> datagram;
+    std::uint32_t lastReceiveTime = 0;
+    std::uint32_t lastSendTime = 0;
+
+    // Loopback clients only
+    std::shared_ptr<LoopbackLink> loopbackLink;
+};
+
+}  // namespace Rival
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <vector>
+
+namespace Rival {
+
+class RelayClient;
+
+/**
+ * Throughput of a room on the relay server, measured over the last metrics interval.
+ */
+struct RoomMetrics
+{
+    int roomId = -1;
+    int numClients = 0;
+
+    /** Packets received from clients in the room. */
+    float packetsInPerSecond = 0;
+    float bytesInPerSecond = 0;
+
+    /** Packets sent to clients in the room. A single packet may be sent to many clients. */
+    float packetsOutPerSecond = 0;
+    float bytesOutPerSecond = 0;
+
+    /** Socket operations performed for clients in the room. */
+    float readsPerSecond = 0;
+    float writesPerSecond = 0;
+
+    /** Most data left waiting to be sent to any one client in the room after a flush, in bytes. */
+    std::size_t maxPendingWriteBytes = 0;
+
+    /** Packets that were not sent because their recipient had fallen too far behind. */
+    std::size_t packetsDropped = 0;
+
+    /** Clients that were disconnected for falling too far behind. */
+    int slowClientsDisconnected = 0;
+};
+
+/**
+ * A group of clients on the relay server that are playing the same game.
+ *
+ * Packets are only relayed between clients in the same room, and each room hands out its own client IDs.
+ */
+class RelayRoom
+{
+public:
+    RelayRoom(int id, int maxClients);
+
+    int getId() const
+    {
+        return id;
+    }
+
+    const std::vector<RelayClient*>& getClients() const
+    {
+        return clients;
+    }
+
+    bool isFull() const
+    {
+        return clients.size() >= static_cast<std::size_t>(maxClients);
+    }
+
+    bool isEmpty() const
+    {
+        return clients.empty();
+    }
+
+    /** Adds a client to this room and assigns it a client ID. The room must not be full. */
+    void addClient(RelayClient& client);
+
+    void removeClient(const RelayClient& client);
+
+    /** Records a packet received from a client in this room. */
+    void onPacketReceived(std::size_t numBytes)
+    {
+        ++packetsIn;
+        bytesIn += numBytes;
+    }
+
+    /** Records a packet sent to a client in this room. */
+    void onPacketSent(std::size_t numBytes)
+    {
+        ++packetsOut;
+        bytesOut += numBytes;
+    }
+
+    /** Records some socket operations performed for a client in this room. */
+    void onSocketOperations(int numReads, int numWrites)
+    {
+        reads += static_cast<std::size_t>(numReads);
+        writes += static_cast<std::size_t>(numWrites);
+    }
+
+    /** Records the amount of data waiting to be sent to a client in this room after it has been flushed. */
+    void onPendingWrites(std::size_t numBytes)
+    {
+        if (numBytes > maxPendingWriteBytes)
+        {
+            maxPendingWriteBytes = numBytes;
+        }
+    }
+
+    /** Records a packet that was not sent to a client in this room because the client had fallen behind. */
+    void onPacketDropped()
+    {
+        ++packetsDropped;
+    }
+
+    /** Records a client in this room being disconnected because it had fallen behind. */
+    void onSlowClientDisconnected()
+    {
+        ++slowClientsDisconnected;
+    }
+
+    /** Calculates the throughput of this room since the last call, and resets the counters. */
+    RoomMetrics collectMetrics(std::uint32_t elapsedMs);
+
+private:
+    int id;
+    int maxClients;
+
+    /** Client ID to assign to the next client that joins. */
+    int nextClientId = 0;
+
+    std::vector<RelayClient*> clients;
+
+    std::size_t packetsIn = 0;
+    std::size_t bytesIn = 0;
+    std::size_t packetsOut = 0;
+    std::size_t bytesOut = 0;
+    std::size_t reads = 0;
+    std::size_t writes = 0;
+    std::size_t maxPendingWriteBytes = 0;
+    std::size_t packetsDropped = 0;
+    int slowClientsDisconnected = 0;
+};
+
+}  // namespace Rival
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace Rival {
+
+/**
+ * Lightweight reliability layer for sending a stream of bytes over an unreliable datagram transport.
+ *
+ * Data is split into numbered messages. Every datagram starts with the ID of the next message we expect to receive,
+ * which acknowledges everything before it, followed by any unacknowledged messages that are due to be sent.
+ *
+ * Each message is repeated in the first few datagrams after it is queued, so a lost datagram is normally recovered by
+ * the next one without waiting for a timeout to expire. Repeating every unacknowledged message in every datagram
+ * would make the traffic grow with the round-trip time, so after that, a message is only resent if it has not been
+ * acknowledged within the retransmission timeout, which is derived from the measured round-trip time.
+ *
+ * Received data is always delivered in the order it was sent, without gaps or duplicates.
+ *
+ * This class does no I/O of its own, and is not thread-safe.
+ */
+class ReliableChannel
+{
+public:
+    /** Queues some data to be sent reliably. Data that does not fit in a single message is split. */
+    void queueMessage(const char* data, std::size_t size);
+
+    /**
+     * Writes the next datagram to send, replacing the contents of the given buffer.
+     *
+     * `now` is a timestamp in milliseconds, used to decide which messages need to be resent.
+     *
+     * Returns false if there is nothing to send, i.e. no messages due to be sent and no acknowledgement owed, unless
+     * `keepAlive` is set, in which case a datagram is always written.
+     */
+    bool writeDatagram(std::vector<char>& datagram, std::uint32_t now, bool keepAlive = false);
+
+    /**
+     * Processes a received datagram, appending any data that can now be delivered to `received`.
+     *
+     * `now` is a timestamp in milliseconds, used to measure the round-trip time.
+     *
+     * @throws std::runtime_error if the datagram is malformed.
+     */
+    void readDatagram(const char* data, std::size_t size, std::uint32_t now, std::vector<char>& received);
+
+    /** Determines if any sent data is still waiting to be acknowledged. */
+    bool hasUnackedMessages() const
+    {
+        return !unackedMessages.empty();
+    }
+
+    /** Gets the total size of all sent data that is still waiting to be acknowledged. */
+    std::size_t getUnackedBytes() const
+    {
+        return unackedBytes;
+    }
+
+    /** Determines if we have received messages that have not yet been acknowledged to the other side. */
+    bool isAckOwed() const
+    {
+        return ackOwed;
+    }
+
+    /** Gets the time after which an unacknowledged message is resent, in milliseconds. */
+    std::uint32_t getResendTimeoutMs() const
+    {
+        return resendTimeoutMs;
+    }
+
+public:
+    /** Maximum size of a datagram; this is kept small enough to avoid IP fragmentation. */
+    static constexpr std::size_t maxDatagramSize = 1200;
+
+    /** Size of the datagram header: the acknowledgement and the number of messages. */
+    static constexpr std::size_t headerSize = sizeof(std::uint32_t) + sizeof(std::uint8_t);
+
+    /** Size of the header preceding each message: the message ID and size. */
+    static constexpr std::size_t messageHeaderSize = sizeof(std::uint32_t) + sizeof(std::uint16_t);
+
+    /** Maximum amount of data in a single message. */
+    static constexpr std::size_t maxMessageSize = maxDatagramSize - headerSize - messageHeaderSize;
+
+    /**
+     * Maximum time that either side should go without sending a datagram.
+     *
+     * Datagrams give no indication of whether the other side is still there, so a connection that is silent for
+     * long enough is considered lost.
+     */
+    static constexpr std::uint32_t keepAliveIntervalMs = 1000;
+
+    /** Maximum number of out-of-order messages to hold on to; anything further ahead is dropped. */
+    static constexpr std::uint32_t maxMessagesAhead = 1024;
+
+    /** Number of consecutive datagrams that each new message is included in. */
+    static constexpr std::uint8_t redundantSends = 3;
+
+    /** Retransmission timeout used until the round-trip time has been measured. */
+    static constexpr std::uint32_t initialResendTimeoutMs = 250;
+
+    /** Lower bound of the retransmission timeout, so that a little jitter does not cause needless resends. */
+    static constexpr std::uint32_t minResendTimeoutMs = 50;
+
+    /** Upper bound of the retransmission timeout. */
+    static constexpr std::uint32_t maxResendTimeoutMs = keepAliveIntervalMs;
+
+private:
+    struct Message
+    {
+        std::uint32_t id;
+        std::vector<char> data;
+
+        /** Number of datagrams this message has been included in. */
+        std::uint32_t numSends = 0;
+
+        /** Time at which this message was first sent. */
+        std::uint32_t firstSendTime = 0;
+
+        /** Time at which this message was most recently sent. */
+        std::uint32_t lastSendTime = 0;
+    };
+
+    bool isMessageDue(const Message& message, std::uint32_t now) const;
+    bool hasMessagesDue(std::uint32_t now) const;
+    void acknowledge(std::uint32_t ack, std::uint32_t now);
+    void addRoundTripSample(std::uint32_t rttMs);
+    void receiveMessage(std::uint32_t id, const char* data, std::size_t size, std::vector<char>& received);
+
+private:
+    /** Messages that have been sent (at least once) but not acknowledged, oldest first. */
+    std::deque<Message> unackedMessages;
+    std::size_t unackedBytes = 0;
+    std::uint32_t nextOutgoingId = 0;
+
+    /** ID of the next message to be delivered; everything before this has been received. */
+    std::uint32_t nextIncomingId = 0;
+
+    /** Messages received ahead of a gap, waiting to be delivered. */
+    std::unordered_map<std::uint32_t, std::vector<char>> outOfOrderMessages;
+
+    /** Whether we have received messages that the other side does not yet know about. */
+    bool ackOwed = false;
+
+    /** Smoothed round-trip time and its mean deviation, in milliseconds (see RFC 6298). */
+    bool hasRoundTripSample = false;
+    std::uint32_t smoothedRttMs = 0;
+    std::uint32_t rttDeviationMs = 0;
+
+    std::uint32_t resendTimeoutMs = initialResendTimeoutMs;
+};
+
+}  // namespace Rival
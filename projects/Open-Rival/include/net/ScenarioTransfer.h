@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Rival {
+
+class Connection;
+
+/**
+ * Sends the compressed scenario to a single player, a few chunks at a time.
+ *
+ * Chunks are sent in TargetedPackets, so the relay server only delivers them to the player who needs them.
+ *
+ * Only `maxChunksInFlight` chunks may be awaiting acknowledgement at any time. This stops a download from flooding
+ * the connection, or the relay server's queue for that player, so the lobby's other packets are never stuck behind
+ * a large scenario.
+ *
+ * Nothing is sent until the player first acknowledges. A player who already has the scenario acknowledges every
+ * chunk straight away, so they can join without waiting for anything.
+ */
+class ScenarioUpload
+{
+public:
+    ScenarioUpload(int playerId, int clientId, std::shared_ptr<const std::vector<char>> compressedData);
+
+    /** Sends as many chunks as flow control allows. */
+    void sendChunks(Connection& connection);
+
+    /** Processes an acknowledgement from the player. */
+    void onAckReceived(std::uint32_t chunksReceived);
+
+    /** Determines if the player has received the whole scenario. */
+    bool isComplete() const
+    {
+        return chunksAcked == numChunks;
+    }
+
+    /** Gets the number of chunks needed to send compressed data of the given size. */
+    static std::uint32_t getNumChunks(std::size_t compressedSize);
+
+public:
+    /** Maximum number of chunks that may be sent without being acknowledged. */
+    static constexpr std::uint32_t maxChunksInFlight = 16;
+
+    /** Number of chunks a player should receive between acknowledgements.
+     * This is half the window, so the host can keep sending while waiting for the next acknowledgement. */
+    static constexpr std::uint32_t ackInterval = maxChunksInFlight / 2;
+
+private:
+    int playerId;
+
+    /** Relay server client ID of the player. */
+    int clientId;
+
+    std::shared_ptr<const std::vector<char>> compressedData;
+    std::uint32_t numChunks;
+
+    /** Whether the player has acknowledged anything yet. */
+    bool started = false;
+
+    std::uint32_t nextChunk = 0;
+    std::uint32_t chunksAcked = 0;
+};
+
+/**
+ * Reassembles a scenario sent by a ScenarioUpload.
+ */
+class ScenarioDownload
+{
+public:
+    ScenarioDownload(std::uint32_t scenarioSize, std::uint32_t compressedSize, std::uint32_t checksum);
+
+    /**
+     * Adds the next chunk of compressed data.
+     *
+     * @throws std::runtime_error if this is not the next chunk, or there is more data than expected.
+     */
+    void addChunk(std::uint32_t chunkIndex, const std::vector<char>& data);
+
+    std::uint32_t getChunksReceived() const
+    {
+        return chunksReceived;
+    }
+
+    /** Determines if the chunks received so far should be acknowledged. */
+    bool isAckDue() const
+    {
+        return isComplete() || chunksReceived % ScenarioUpload::ackInterval == 0;
+    }
+
+    /** Determines if all of the compressed data has been received. */
+    bool isComplete() const
+    {
+        return compressedData.size() == compressedSize;
+    }
+
+    /**
+     * Decompresses the received data.
+     *
+     * @throws std::runtime_error if the scenario is incomplete, or does not match the expected checksum.
+     */
+    std::vector<std::uint8_t> extract() const;
+
+    /**
+     * Determines if a scenario filename received from the host is safe to look for in our own maps directory.
+     *
+     * The filename must not contain any path separators, or anything that could lead out of the maps directory.
+     */
+    static bool isValidFilename(const std::string& filename);
+
+private:
+    std::uint32_t scenarioSize;
+    std::uint32_t compressedSize;
+    std::uint32_t checksum;
+
+    std::uint32_t chunksReceived = 0;
+    std::vector<char> compressedData;
+};
+
+}  // namespace Rival
@@ -1,43 +1,204 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>  // std::size_t
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
-#include "net/Connection.h"
+#include "net/LoopbackLink.h"
+#include "net/RelayClient.h"
+#include "net/RelayRoom.h"
+#include "net/Socket.h"
+#include "net/SocketPoller.h"
+#include "utils/SpscQueue.h"
 
 namespace Rival {
 
-class Socket;
+/**
+ * What the relay server does with a client that is not accepting data as fast as it is being relayed.
+ */
+enum class SlowClientPolicy : std::uint8_t
+{
+    /** Disconnect the client. Every packet matters in a lockstep game, so this is the default. */
+    Disconnect,
+
+    /** Drop packets for the client until it catches up. The client never receives the packets that were dropped. */
+    DropPackets
+};
 
 /**
- * Relay server that forwards received packets to every other client.
+ * Relay server that forwards received packets to every other client in the same room.
+ *
+ * A packet meant for a single client can be wrapped in a TargetedPacket, in which case the relay server unwraps it
+ * and forwards it to that client only.
+ *
+ * Each client joins a room by sending a JoinRoomPacket as soon as it connects; clients that send any other packet
+ * first are placed in the default room. A room is created when its first client joins, and destroyed when its last
+ * client leaves, so many independent games can share one server.
+ *
+ * Clients may connect over TCP, or communicate using UDP datagrams sent to the same port. Datagram clients are
+ * identified by their address, and their data is made reliable using a ReliableChannel. Since datagrams can arrive
+ * from anywhere, a datagram client must always start by sending a JoinRoomPacket; other datagrams from unknown
+ * addresses are ignored. A client in the same process can skip the sockets entirely and connect over a LoopbackLink.
+ *
+ * All sockets are serviced by a single event loop thread, which waits for sockets to become ready using a
+ * SocketPoller. Since only this thread ever touches the connected clients and rooms, joining, leaving and relaying
+ * require no locking, and disconnected clients are simply removed at the end of an iteration.
+ *
+ * The only state shared with other threads is the room metrics, which are published as immutable snapshots.
+ *
+ * The server never waits for a client. Data for each client is queued until the client is ready for it, but only up
+ * to a limit; a client that falls further behind than that is dealt with according to the SlowClientPolicy.
  */
-class Server : public ConnectionListener
+class Server
 {
 public:
-    Server(std::uint16_t port, int maxClients);
-    ~Server();
+    /**
+     * Creates a server.
+     *
+     * @param port Port on which to accept clients, or `std::nullopt` to only accept loopback clients, in which case no
+     * sockets are opened at all.
+     */
+    Server(std::optional<std::uint16_t> port,
+           int maxClientsPerRoom,
+           int maxRooms = 1,
+           SlowClientPolicy slowClientPolicy = SlowClientPolicy::Disconnect);
 
-    // Begin ConnectionListener override
-    void onPacketReceived(Connection& connection, std::shared_ptr<const Packet> packet) override;
-    // End ConnectionListener override
+    ~Server();
 
-    /** Starts accepting connections in a separate thread. */
+    /** Starts accepting connections and relaying packets in a separate thread. */
     void start();
 
+    /**
+     * Runs a single iteration of the event loop, waiting at most the given time for socket activity.
+     *
+     * This is only for servers that have not been started. It allows the server to be driven from the same thread as
+     * its clients, so that everything happens in a deterministic order.
+     */
+    void poll(int maxWaitMs);
+
+    /**
+     * Connects a client that is running in the same process.
+     *
+     * The returned link should be given to a Connection. The client is registered by the event loop, so this may be
+     * called from another thread, although not from several threads at once.
+     */
+    std::shared_ptr<LoopbackLink> connectLoopback();
+
+    /**
+     * Gets the throughput of each room, as measured over the last metrics interval.
+     *
+     * This may be called from any thread. The snapshot is never modified, and stays valid for as long as the caller
+     * holds onto it.
+     */
+    std::shared_ptr<const std::vector<RoomMetrics>> getRoomMetrics() const;
+
+public:
+    /** Room that clients join if they do not request a specific room. */
+    static constexpr int defaultRoomId = 0;
+
 private:
-    void acceptThreadLoop();
-    int requestClientId();
+    void eventLoop();
+    void acceptClients();
+    void acceptLoopbackClients();
+    bool canAcceptClient() const;
+    void receiveDatagrams();
+    RelayClient* findDatagramClient(const SocketAddress& address, std::size_t size);
+    void receiveFromClient(RelayClient& client);
+    void receiveFromLoopbackClients();
+    void handleReceivedPackets(RelayClient& client, int numReads);
+    void flushClient(RelayClient& client);
+    void handlePacket(RelayClient& client, const std::vector<char>& packetData);
+    bool joinRoom(RelayClient& client, int roomId);
+    void relayPacket(
+            RelayClient& sender,
+            RelayRoom& room,
+            const std::vector<char>& packetData,
+            std::optional<int> recipientId = std::nullopt);
+    void sendToClient(RelayClient& client, RelayRoom& room, const std::shared_ptr<const std::vector<char>>& data);
+    void updateClients();
+    void updateMetrics();
 
 private:
+    /** Token used to identify the server socket within the poller. */
+    static constexpr int listenToken = -1;
+
+    /** Token used to identify the datagram socket within the poller. */
+    static constexpr int datagramToken = -2;
+
+    /** Maximum time to wait for socket activity before checking if the server should stop. */
+    static constexpr int pollTimeoutMs = 100;
+
+    /**
+     * Interval at which data from loopback clients is checked while any are connected.
+     *
+     * Loopback clients have no socket with which to wake the poller, so the event loop has to wake up by itself.
+     */
+    static constexpr int loopbackPollIntervalMs = 1;
+
+    /** Maximum number of loopback clients waiting to be registered by the event loop. */
+    static constexpr std::size_t maxPendingLoopbackClients = 16;
+
+    /** Time after which a datagram client that has sent nothing is considered to have disconnected. */
+    static constexpr std::uint32_t datagramTimeoutMs = 10000;
+
+    /** Interval at which room metrics are calculated. */
+    static constexpr std::uint32_t metricsIntervalMs = 1000;
+
     Socket serverSocket;
-    std::thread acceptThread;
+    Socket datagramSocket;
+    SocketPoller poller;
+    std::thread eventLoopThread;
+    std::atomic<bool> running = false;
+
+    int maxClientsPerRoom;
+    int maxRooms;
+    SlowClientPolicy slowClientPolicy;
+
+    /** Token to assign to the next connection. */
+    int nextToken = 0;
+
+    /** All connected clients, by token. */
+    std::unordered_map<int, std::unique_ptr<RelayClient>> connectedClients;
+
+    /** Tokens of all datagram clients, by address. */
+    std::unordered_map<SocketAddress, int, SocketAddressHash> datagramClientTokens;
+
+    /** Tokens of all loopback clients. */
+    std::vector<int> loopbackClientTokens;
+
+    /** Links passed from `connectLoopback` to the event loop. */
+    SpscQueue<std::shared_ptr<LoopbackLink>, maxPendingLoopbackClients> pendingLoopbackLinks;
+
+    /** Whether any datagram client has data that may need to be resent. */
+    bool hasUnackedDatagrams = false;
+
+    /** All rooms with at least one client, by room ID. */
+    std::unordered_map<int, RelayRoom> rooms;
+
+    /** Events reported by the poller; re-used between iterations of the event loop. */
+    std::vector<SocketEvent> events;
+
+    /** Data of the packet currently being extracted from a client. */
+    std::vector<char> receivedPacketData;
+
+    /** Buffer used to receive a single datagram. */
+    std::vector<char> receivedDatagram;
+
+    std::uint32_t lastMetricsTime = 0;
 
-    int maxClients;
-    int nextClientId = 0;
-    std::unordered_map<int, std::unique_ptr<Connection>> connectedClients;
+    /**
+     * Latest room metrics.
+     *
+     * Rather than being updated in place, this is replaced with a new snapshot each interval, so readers never need
+     * to copy the metrics or hold up the event loop. It must only be accessed using `std::atomic_load` and
+     * `std::atomic_store`.
+     */
+    std::shared_ptr<const std::vector<RoomMetrics>> roomMetrics;
 };
 
 }  // namespace Rival
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <cstdint>
+#include <functional>  // std::hash
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,14 +13,55 @@
 #include <winsock2.h>
 #else
 typedef int SOCKET;
+static constexpr SOCKET INVALID_SOCKET = -1;
 #endif
 
 namespace Rival {
 
+/**
+ * A block of data to be sent as part of a gathered write.
+ */
+struct SendBuffer
+{
+    const char* data = nullptr;
+    std::size_t size = 0;
+};
+
+/**
+ * IPv4 address and port of a remote socket, as used by datagram sockets.
+ *
+ * Both values are stored in network byte order.
+ */
+struct SocketAddress
+{
+    std::uint32_t host = 0;
+    std::uint16_t port = 0;
+
+    bool operator==(const SocketAddress& other) const
+    {
+        return host == other.host && port == other.port;
+    }
+
+    bool operator!=(const SocketAddress& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/** Hash function allowing SocketAddresses to be used as keys in unordered containers. */
+struct SocketAddressHash
+{
+    std::size_t operator()(const SocketAddress& address) const
+    {
+        return std::hash<std::uint64_t>()((static_cast<std::uint64_t>(address.host) << 16) | address.port);
+    }
+};
+
 /**
  * Wrapper class for a native socket.
  *
- * Implementation details are platform-specific.
+ * Implementation details are platform-specific. The API is blocking, but the POSIX implementation uses non-blocking
+ * sockets internally and waits for readiness, so that blocked calls can be woken reliably when a socket is closed.
  */
 class Socket
 {
@@ -29,12 +72,18 @@ public:
     /** Creates a socket and attempts to connect it to the given address and port. */
     static Socket createClient(const std::string& address, std::uint16_t port);
 
+    /** Creates a non-blocking datagram socket that receives from any address on the given port. */
+    static Socket createUdpServer(std::uint16_t port);
+
+    /** Creates a datagram socket that sends to, and only receives from, the given address and port. */
+    static Socket createUdpClient(const std::string& address, std::uint16_t port);
+
     Socket();
     Socket(SOCKET handle);
     ~Socket();
 
-    bool Socket::operator==(const Socket& other) const;
-    bool Socket::operator!=(const Socket& other) const;
+    bool operator==(const Socket& other) const;
+    bool operator!=(const Socket& other) const;
 
     // Allow moving but prevent copying
     Socket(const Socket& other) = delete;
@@ -57,12 +106,71 @@ public:
     /** Blocking call that waits for data to arrive and adds it to the given buffer. */
     void receive(std::vector<char>& buffer);
 
+    /**
+     * Puts this socket into non-blocking mode, for use with the `try` methods.
+     *
+     * The blocking methods should not be used afterwards.
+     */
+    void setNonBlocking();
+
+    /** Accepts a pending connection, if there is one, without blocking. */
+    Socket tryAccept();
+
+    /**
+     * Sends as much data as possible without blocking.
+     *
+     * Returns the number of bytes sent (possibly zero), or -1 if the connection has been lost. The socket is not
+     * closed automatically, so that it can be removed from a SocketPoller first.
+     */
+    int trySend(const char* data, std::size_t size);
+
+    /**
+     * Sends as much data as possible from several buffers, in order, using a single system call.
+     *
+     * At most `maxSendBuffers` buffers are sent; any beyond that are ignored. Returns the total number of bytes sent
+     * (possibly zero), or -1 if the connection has been lost.
+     */
+    int trySend(const SendBuffer* buffers, std::size_t numBuffers);
+
+    /**
+     * Receives as much data as is available, up to the given size, without blocking.
+     *
+     * Returns the number of bytes received (possibly zero), or -1 if the connection has been lost or closed by the
+     * other side. The socket is not closed automatically, so that it can be removed from a SocketPoller first.
+     */
+    int tryReceive(char* data, std::size_t size);
+
+    /** Sends a single datagram to the given address, without blocking. Returns false if it could not be sent. */
+    bool trySendTo(const char* data, std::size_t size, const SocketAddress& address);
+
+    /**
+     * Receives a single datagram, if one is available, without blocking.
+     *
+     * Returns the size of the datagram, zero if none is available, or -1 if the socket has failed. Datagrams larger
+     * than the given size are truncated.
+     */
+    int tryReceiveFrom(char* data, std::size_t size, SocketAddress& address);
+
+    /**
+     * Blocking call that waits for a single datagram to arrive.
+     *
+     * Returns the size of the datagram, zero if the timeout expires first, or -1 if the socket has been closed.
+     */
+    int receiveDatagram(char* data, std::size_t size, int timeoutMs);
+
+public:
+    /** Maximum number of buffers that can be sent in a single gathered write. */
+    static constexpr std::size_t maxSendBuffers = 16;
+
 private:
     Socket(int domain, int type, int protocol);
 
     void init();
 
 private:
+    // Allow the poller to access the native handle
+    friend class SocketPoller;
+
     SOCKET handle;
 };
 
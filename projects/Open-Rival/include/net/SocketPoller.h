@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include "net/Socket.h"
+
+namespace Rival {
+
+/**
+ * Readiness of a socket, as reported by a SocketPoller.
+ */
+struct SocketEvent
+{
+    /** Token given when the socket was added to the poller. */
+    int token = 0;
+
+    /** Data (or a new connection) is waiting to be read. */
+    bool readable = false;
+
+    /** Data can be sent without blocking. */
+    bool writable = false;
+
+    /** The connection has been closed by the other side, or has failed. */
+    bool closed = false;
+};
+
+/**
+ * Waits for any of a set of sockets to become ready for I/O.
+ *
+ * Sockets are identified by a token chosen by the caller. Sockets must be non-blocking.
+ *
+ * Implementation details are platform-specific: epoll on Linux, WSAPoll on Windows.
+ */
+class SocketPoller
+{
+public:
+    SocketPoller();
+    ~SocketPoller();
+
+    // Prevent copying
+    SocketPoller(const SocketPoller&) = delete;
+    SocketPoller& operator=(const SocketPoller&) = delete;
+
+    /** Starts waiting for a socket to become readable. */
+    void add(const Socket& socket, int token);
+
+    /**
+     * Sets whether to also wait for a socket to become writable.
+     *
+     * This should only be enabled while there is data waiting to be sent, otherwise the socket will be reported as
+     * ready continuously.
+     */
+    void setWriteInterest(const Socket& socket, int token, bool interested);
+
+    /** Stops waiting for a socket. This must be called before the socket is closed. */
+    void remove(const Socket& socket);
+
+    /**
+     * Waits until at least one socket is ready, or the timeout expires.
+     *
+     * @param events Filled with the sockets that are ready; any previous contents are discarded.
+     * @param timeoutMs Maximum time to wait, in milliseconds.
+     */
+    void wait(std::vector<SocketEvent>& events, int timeoutMs);
+
+private:
+#ifdef _WIN32
+    /** Sockets being polled, with their tokens in the corresponding indices of `tokens`. */
+    std::vector<WSAPOLLFD> pollFds;
+    std::vector<int> tokens;
+#else
+    int epollHandle;
+#endif
+};
+
+}  // namespace Rival
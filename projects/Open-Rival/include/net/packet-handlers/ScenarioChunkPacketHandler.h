@@ -0,0 +1,15 @@
+#pragma once
+
+#include <memory>
+
+#include "net/packet-handlers/PacketHandler.h"
+
+namespace Rival {
+
+class ScenarioChunkPacketHandler : public PacketHandler
+{
+public:
+    void onPacketReceived(std::shared_ptr<const Packet> packet, State& state) override;
+};
+
+}  // namespace Rival
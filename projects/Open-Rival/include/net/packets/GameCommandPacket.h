@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <vector>
 
 #include "net/packets/Packet.h"
+#include "utils/ObjectPool.h"
 
 namespace Rival {
 
@@ -12,29 +14,49 @@ class GameCommandFactory;
 
 /**
  * Packet containing all the commands a player has issued for a given tick.
+ *
+ * A packet also signifies that the sender has no commands for any of the ticks since its previous GameCommandPacket.
+ * This allows an idle player to cover several ticks with a single empty packet, instead of sending one every tick.
+ *
+ * To keep packets small, the tick is sent relative to the tick of the sender's previous GameCommandPacket, so this
+ * almost always fits in a single byte. It is up to the recipient to keep track of the last tick received from each
+ * sender; this relies on packets being delivered reliably and in order.
+ *
+ * Every player can receive one of these from every other player each tick, so received packets are taken from an
+ * ObjectPool rather than allocated individually.
  */
 class GameCommandPacket : public Packet
 {
 public:
-    GameCommandPacket(std::vector<std::shared_ptr<GameCommand>> commands, int tick);
+    /** Tick to use as the previous tick when sending the first packet of a game. */
+    static constexpr int initialPreviousTick = -1;
+
+    GameCommandPacket(std::vector<std::shared_ptr<GameCommand>> commands, int tick, int previousTick);
 
     void serialize(std::vector<char>& buffer) const override;
     static std::shared_ptr<GameCommandPacket>
-    deserialize(const std::vector<char> buffer, const GameCommandFactory& commandFactory);
+    deserialize(const char* buffer, std::size_t bufferSize, const GameCommandFactory& commandFactory);
 
-    std::vector<std::shared_ptr<GameCommand>> getCommands() const
+    const std::vector<std::shared_ptr<GameCommand>>& getCommands() const
     {
         return commands;
     }
 
-    int getTick() const
+    /** Gets the number of ticks between the sender's previous GameCommandPacket and this one. */
+    int getTickDelta() const
     {
-        return tick;
+        return tickDelta;
     }
 
+private:
+    // Allow received packets to be pooled
+    friend class ObjectPool<GameCommandPacket>;
+    GameCommandPacket();
+    void reset();
+
 private:
     std::vector<std::shared_ptr<GameCommand>> commands;
-    int tick;
+    int tickDelta;
 };
 
 }  // namespace Rival
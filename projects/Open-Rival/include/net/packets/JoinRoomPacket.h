@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "net/packets/Packet.h"
+
+namespace Rival {
+
+/**
+ * Packet sent by a client to choose which room to join on the relay server.
+ *
+ * This must be the first packet sent after connecting. The relay server consumes this packet itself; it is never
+ * forwarded to other clients.
+ */
+class JoinRoomPacket : public Packet
+{
+public:
+    JoinRoomPacket(int roomId);
+
+    void serialize(std::vector<char>& buffer) const override;
+
+    /** Reads the room ID from the raw packet data received by the relay server. */
+    static int readRoomId(const std::vector<char>& packetData);
+
+    int getRoomId() const
+    {
+        return roomId;
+    }
+
+private:
+    int roomId;
+};
+
+}  // namespace Rival
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "net/packets/Packet.h"
+
+namespace Rival {
+
+/**
+ * Packet sent periodically by each client to share its measured network latency.
+ *
+ * The host uses these to decide on the command delay.
+ */
+class LatencyReportPacket : public Packet
+{
+public:
+    LatencyReportPacket(std::uint32_t rttMs, std::uint32_t jitterMs);
+
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<LatencyReportPacket> deserialize(const char* buffer, std::size_t bufferSize);
+
+    /** Gets the sender's smoothed round-trip time to the relay server, in milliseconds. */
+    std::uint32_t getRtt() const
+    {
+        return rttMs;
+    }
+
+    /** Gets the jitter of packets arriving at the sender from the relay server, in milliseconds. */
+    std::uint32_t getJitter() const
+    {
+        return jitterMs;
+    }
+
+private:
+    std::uint32_t rttMs;
+    std::uint32_t jitterMs;
+};
+
+}  // namespace Rival
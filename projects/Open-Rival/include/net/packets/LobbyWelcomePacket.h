@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -19,7 +20,7 @@ public:
     LobbyWelcomePacket(int playerId, std::unordered_map<int, ClientInfo> clients);
 
     void serialize(std::vector<char>& buffer) const override;
-    static std::shared_ptr<LobbyWelcomePacket> deserialize(const std::vector<char> buffer);
+    static std::shared_ptr<LobbyWelcomePacket> deserialize(const char* buffer, std::size_t bufferSize);
 
     int getPlayerId() const
     {
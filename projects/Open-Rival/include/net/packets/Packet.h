@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <cstdint>
 #include <vector>
 
@@ -15,7 +16,14 @@ enum class PacketType : std::uint8_t
     LobbyWelcome,
     KickPlayer,
     StartGame,
-    GameCommand
+    GameCommand,
+    Ping,
+    LatencyReport,
+    JoinRoom,
+    ScenarioInfo,
+    ScenarioChunk,
+    ScenarioAck,
+    Targeted
 };
 
 /**
@@ -48,18 +56,55 @@ public:
         return clientId;
     }
 
+    void setRelayTime(std::uint32_t newRelayTime)
+    {
+        relayTime = newRelayTime;
+    }
+
+    /** Gets the time at which the relay server received this packet, according to the server's clock. */
+    std::uint32_t getRelayTime() const
+    {
+        return relayTime;
+    }
+
+    void setReceiveTime(std::uint32_t newReceiveTime)
+    {
+        receiveTime = newReceiveTime;
+    }
+
+    /** Gets the time at which this packet was received, according to the local clock. */
+    std::uint32_t getReceiveTime() const
+    {
+        return receiveTime;
+    }
+
+    /**
+     * Reads the packet size sent before a packet, from a raw buffer of the given size, at some offset.
+     *
+     * The offset is increased by `sizeBytes`.
+     */
+    static std::size_t readSize(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
 public:
-    /** Size, in bytes, of the packet size sent before a packet. */
-    static constexpr size_t sizeBytes = sizeof(int);
+    /** Size, in bytes, of the packet size sent before a packet.
+     * Packet sizes are always sent in little-endian byte order. */
+    static constexpr std::size_t sizeBytes = sizeof(std::uint16_t);
 
 protected:
     /** Size of the packet header, in bytes, of a packet received from the relay server.
      * This excludes the packet size, which is read separately before the packet data. */
-    static constexpr size_t relayedPacketHeaderSize = sizeof(PacketType) + sizeof(int) /* client ID */;
+    static constexpr std::size_t relayedPacketHeaderSize =
+            sizeof(PacketType) + sizeof(int) /* client ID */ + sizeof(std::uint32_t) /* relay time */;
 
     /** Client ID of the sender, will be populated on all packets received from the relay server. */
     int clientId = -1;
 
+    /** Relay server timestamp, will be populated on all packets received from the relay server. */
+    std::uint32_t relayTime = 0;
+
+    /** Local timestamp, populated when the packet is received. */
+    std::uint32_t receiveTime = 0;
+
 private:
     PacketType type;
 };
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "net/packets/Packet.h"
+
+namespace Rival {
+
+/**
+ * Packet sent by a client to measure its round-trip time to the relay server.
+ *
+ * The relay server returns this packet to the sender, rather than forwarding it to other clients.
+ */
+class PingPacket : public Packet
+{
+public:
+    PingPacket(std::uint32_t sendTime);
+
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<PingPacket> deserialize(const char* buffer, std::size_t bufferSize);
+
+    /** Gets the time at which the packet was sent, according to the sender's clock. */
+    std::uint32_t getSendTime() const
+    {
+        return sendTime;
+    }
+
+private:
+    std::uint32_t sendTime;
+};
+
+}  // namespace Rival
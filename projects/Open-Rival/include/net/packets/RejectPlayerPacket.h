@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,7 +18,7 @@ public:
     RejectPlayerPacket(int requestId, std::string playerName);
 
     void serialize(std::vector<char>& buffer) const override;
-    static std::shared_ptr<RejectPlayerPacket> deserialize(const std::vector<char> buffer);
+    static std::shared_ptr<RejectPlayerPacket> deserialize(const char* buffer, std::size_t bufferSize);
 
     std::string getPlayerName() const
     {
@@ -9,7 +9,9 @@ namespace Rival {
 /**
  * Packet that wraps a received packet, for forwarding by the relay server.
  *
- * The original packet data is not important for the server, and is never inspected.
+ * The original packet data is not important for the server, and is never inspected beyond the packet type.
+ *
+ * When forwarded, the packet is stamped with the sender's client ID and the time at which the relay received it.
  */
 class RelayedPacket : public Packet
 {
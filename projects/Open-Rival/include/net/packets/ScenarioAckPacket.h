@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "net/packets/Packet.h"
+
+namespace Rival {
+
+/**
+ * Packet sent by a joining player to tell the host how much of the scenario they have received.
+ *
+ * A player who already has the scenario acknowledges every chunk straight away, so nothing needs to be sent.
+ */
+class ScenarioAckPacket : public Packet
+{
+public:
+    ScenarioAckPacket(int playerId, std::uint32_t chunksReceived);
+
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<ScenarioAckPacket> deserialize(const char* buffer, std::size_t bufferSize);
+
+    /** Gets the ID of the player who sent this packet. */
+    int getPlayerId() const
+    {
+        return playerId;
+    }
+
+    /** Gets the number of chunks the player has received, from the start of the scenario. */
+    std::uint32_t getChunksReceived() const
+    {
+        return chunksReceived;
+    }
+
+private:
+    int playerId;
+    std::uint32_t chunksReceived;
+};
+
+}  // namespace Rival
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "net/packets/Packet.h"
+
+namespace Rival {
+
+/**
+ * Packet sent by the host containing part of the compressed scenario, for a player who does not have it.
+ */
+class ScenarioChunkPacket : public Packet
+{
+public:
+    ScenarioChunkPacket(int playerId, std::uint32_t chunkIndex, std::vector<char> data);
+
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<ScenarioChunkPacket> deserialize(const char* buffer, std::size_t bufferSize);
+
+    /** Gets the ID of the player for whom this packet is intended. */
+    int getPlayerId() const
+    {
+        return playerId;
+    }
+
+    /** Gets the position of this chunk within the compressed scenario. */
+    std::uint32_t getChunkIndex() const
+    {
+        return chunkIndex;
+    }
+
+    const std::vector<char>& getData() const
+    {
+        return data;
+    }
+
+public:
+    /** Maximum amount of data in a single chunk.
+     * This leaves room for the packet headers within `Connection::maxBufferSize`, even once relayed. */
+    static constexpr std::size_t maxDataSize = 448;
+
+private:
+    int playerId;
+    std::uint32_t chunkIndex;
+    std::vector<char> data;
+};
+
+}  // namespace Rival
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "net/packets/Packet.h"
+
+namespace Rival {
+
+/**
+ * Packet sent by the host to a player who has joined the lobby, describing the selected scenario.
+ *
+ * The player responds with a ScenarioAckPacket; if they do not already have the scenario, it is then sent to them
+ * in ScenarioChunkPackets.
+ */
+class ScenarioInfoPacket : public Packet
+{
+public:
+    ScenarioInfoPacket(
+            int playerId,
+            std::string filename,
+            std::uint32_t scenarioSize,
+            std::uint32_t compressedSize,
+            std::uint32_t checksum);
+
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<ScenarioInfoPacket> deserialize(const char* buffer, std::size_t bufferSize);
+
+    /** Gets the ID of the player for whom this packet is intended. */
+    int getPlayerId() const
+    {
+        return playerId;
+    }
+
+    /** Gets the name of the scenario file, relative to the maps directory. */
+    const std::string& getFilename() const
+    {
+        return filename;
+    }
+
+    /** Gets the size of the scenario file, in bytes. */
+    std::uint32_t getScenarioSize() const
+    {
+        return scenarioSize;
+    }
+
+    /** Gets the size of the scenario file once compressed, in bytes. */
+    std::uint32_t getCompressedSize() const
+    {
+        return compressedSize;
+    }
+
+    /** Gets the CRC-32 of the scenario file. */
+    std::uint32_t getChecksum() const
+    {
+        return checksum;
+    }
+
+private:
+    int playerId;
+    std::string filename;
+    std::uint32_t scenarioSize;
+    std::uint32_t compressedSize;
+    std::uint32_t checksum;
+};
+
+}  // namespace Rival
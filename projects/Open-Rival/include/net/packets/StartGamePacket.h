@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>  // std::size_t
 #include <memory>
 #include <vector>
 
@@ -13,9 +14,19 @@ namespace Rival {
 class StartGamePacket : public Packet
 {
 public:
-    StartGamePacket();
+    StartGamePacket(bool rollback);
 
-    static std::shared_ptr<StartGamePacket> deserialize(const std::vector<char> buffer);
+    void serialize(std::vector<char>& buffer) const override;
+    static std::shared_ptr<StartGamePacket> deserialize(const char* buffer, std::size_t bufferSize);
+
+    bool isRollbackEnabled() const
+    {
+        return rollback;
+    }
+
+private:
+    /** Whether the game should use rollback instead of a fixed command delay. */
+    bool rollback;
 };
 
 }  // namespace Rival
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <vector>
+
+#include "net/packets/Packet.h"
+
+namespace Rival {
+
+/**
+ * Packet that wraps another packet, asking the relay server to deliver it to a single client.
+ *
+ * The relay server consumes the wrapper itself. The recipient receives the wrapped packet exactly as if it had been
+ * sent to the whole room, so no other client has to spend any bandwidth on a packet that is not meant for it.
+ *
+ * The wrapped packet is only referenced, so this should be sent straight away.
+ */
+class TargetedPacket : public Packet
+{
+public:
+    TargetedPacket(int recipientId, const Packet& packet);
+
+    void serialize(std::vector<char>& buffer) const override;
+
+    /** Reads the recipient's client ID from the raw packet data received by the relay server. */
+    static int readRecipientId(const std::vector<char>& packetData);
+
+    /**
+     * Reads the wrapped packet from the raw packet data received by the relay server.
+     *
+     * The result can be relayed just like any other packet data.
+     *
+     * @throws std::runtime_error if there is no wrapped packet.
+     */
+    static std::vector<char> readPacketData(const std::vector<char>& packetData);
+
+    int getRecipientId() const
+    {
+        return recipientId;
+    }
+
+private:
+    /** Offset of the wrapped packet within the raw packet data received by the relay server. */
+    static constexpr std::size_t packetDataOffset = sizeof(PacketType) + sizeof(int) /* recipient ID */;
+
+    int recipientId;
+    const Packet& packet;
+};
+
+}  // namespace Rival
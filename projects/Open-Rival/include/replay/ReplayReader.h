@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Rival {
+
+class GameCommand;
+
+/**
+ * Commands executed during a single tick of a replay.
+ */
+struct ReplayTick
+{
+    int tick = 0;
+    std::vector<std::shared_ptr<GameCommand>> commands;
+};
+
+/**
+ * Reads a replay file written by a ReplayWriter.
+ */
+class ReplayReader
+{
+public:
+    ReplayReader(const std::string& filename);
+
+    /** Gets the raw contents of the scenario file on which the replay is based. */
+    const std::vector<unsigned char>& getScenarioData() const
+    {
+        return scenarioData;
+    }
+
+    /** Gets all ticks during which commands were executed, in order. */
+    const std::vector<ReplayTick>& getTicks() const
+    {
+        return ticks;
+    }
+
+    /** Gets the last tick of the recorded game. */
+    int getFinalTick() const
+    {
+        return finalTick;
+    }
+
+private:
+    std::vector<unsigned char> scenarioData;
+    std::vector<ReplayTick> ticks;
+    int finalTick = 0;
+};
+
+}  // namespace Rival
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+namespace Rival {
+
+/**
+ * Settings controlling replay recording and playback.
+ */
+struct ReplaySettings
+{
+    /** File to which the game should be recorded; empty if the game should not be recorded. */
+    std::string recordFilename;
+
+    /** Replay file to play back; empty if we are not watching a replay. */
+    std::string playbackFilename;
+
+    /** Whether a replay should be played back as fast as possible, without rendering. */
+    bool fastForward = false;
+
+    bool isRecording() const
+    {
+        return !recordFilename.empty();
+    }
+
+    bool isPlayback() const
+    {
+        return !playbackFilename.empty();
+    }
+};
+
+}  // namespace Rival
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Rival {
+
+class GameCommand;
+
+/**
+ * Records every executed GameCommand to a replay file.
+ *
+ * A replay file consists of:
+ *
+ *  - A header containing the file version.
+ *  - The raw contents of the scenario file, so that replays are self-contained.
+ *  - A record for each tick during which commands were executed, containing the tick number and the serialized
+ *    commands.
+ *  - A final, empty record denoting the last tick of the game.
+ */
+class ReplayWriter
+{
+public:
+    /** Creates a replay file for a game played on the scenario with the given raw contents. */
+    ReplayWriter(const std::string& filename, const std::vector<std::uint8_t>& scenarioData);
+    ~ReplayWriter();
+
+    /** Records the commands executed during the given tick. */
+    void recordCommands(int tick, const std::vector<std::shared_ptr<GameCommand>>& commands);
+
+    /** Writes the final record and closes the file. */
+    void close(int finalTick);
+
+public:
+    /** Identifier written at the start of every replay file. */
+    static constexpr char magic[4] = { 'O', 'R', 'R', 'P' };
+
+    /** Replay format version. Should be incremented whenever the format or any GameCommand changes. */
+    static constexpr std::uint32_t version = 2;
+
+    /** Maximum size of a single tick's record, in bytes. */
+    static constexpr std::size_t maxRecordSize = 4096;
+
+private:
+    void writeRecord(int tick, const std::vector<std::shared_ptr<GameCommand>>& commands);
+
+private:
+    std::ofstream os;
+
+    /** Buffer re-used for each record. */
+    std::vector<char> recordBuffer;
+
+    /** Last tick for which commands were recorded. */
+    int lastTick = 0;
+};
+
+}  // namespace Rival
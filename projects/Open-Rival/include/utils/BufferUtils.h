@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>  // std::size_t
+#include <cstdint>
 #include <cstring>  // std::memcpy
 #include <stdexcept>
 #include <string>
@@ -30,20 +31,72 @@ void addToBuffer(std::vector<char>& buffer, const T& val)
     std::memcpy(destPtr, &val, sizeof(val));
 }
 
-/** Reads a value from the given buffer, at some offset.
+/** Reads a value from a raw buffer of the given size, at some offset.
  * The value is stored in dest, and the offset is increased by the size of the value. */
 template <typename T>
-void readFromBuffer(const std::vector<char>& buffer, std::size_t& offset, T& dest)
+void readFromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset, T& dest)
 {
-    if (offset + sizeof(dest) > buffer.size())
+    if (offset + sizeof(dest) > bufferSize)
     {
         throw std::runtime_error("Trying to read past end of buffer");
     }
 
-    std::memcpy(&dest, buffer.data() + offset, sizeof(dest));
+    std::memcpy(&dest, buffer + offset, sizeof(dest));
     offset += sizeof(dest);
 }
 
+/** Reads a value from the given buffer, at some offset.
+ * The value is stored in dest, and the offset is increased by the size of the value. */
+template <typename T>
+void readFromBuffer(const std::vector<char>& buffer, std::size_t& offset, T& dest)
+{
+    readFromBuffer(buffer.data(), buffer.size(), offset, dest);
+}
+
+/** Maximum number of bytes used by a variable-length 32-bit integer. */
+static constexpr std::size_t maxVarIntBytes = 5;
+
+/** Adds a 16-bit value to the end of the given buffer.
+ * Unlike `addToBuffer`, this always uses little-endian byte order, regardless of the platform. */
+void addUint16ToBuffer(std::vector<char>& buffer, std::uint16_t val);
+
+/** Reads a 16-bit value written by `addUint16ToBuffer` from a raw buffer of the given size, at some offset.
+ * The offset is increased by the size of the data read. */
+std::uint16_t readUint16FromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
+/** Reads a 16-bit value written by `addUint16ToBuffer` from the given buffer, at some offset.
+ * The offset is increased by the size of the data read. */
+std::uint16_t readUint16FromBuffer(const std::vector<char>& buffer, std::size_t& offset);
+
+/** Adds an unsigned value to the end of the given buffer using a variable-length encoding.
+ * The value is written 7 bits at a time, least significant first, with the top bit of each byte set if more bytes
+ * follow. Small values therefore take fewer bytes, and the result does not depend on the platform's endianness. */
+void addVarUintToBuffer(std::vector<char>& buffer, std::uint32_t val);
+
+/** Reads a value written by `addVarUintToBuffer` from a raw buffer of the given size, at some offset.
+ * The offset is increased by the size of the data read. */
+std::uint32_t readVarUintFromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
+/** Reads a value written by `addVarUintToBuffer` from the given buffer, at some offset.
+ * The offset is increased by the size of the data read. */
+std::uint32_t readVarUintFromBuffer(const std::vector<char>& buffer, std::size_t& offset);
+
+/** Adds a signed value to the end of the given buffer using a variable-length encoding.
+ * The value is zigzag-encoded first (0, -1, 1, -2, ...), so that small negative values are also small. */
+void addVarIntToBuffer(std::vector<char>& buffer, std::int32_t val);
+
+/** Reads a value written by `addVarIntToBuffer` from a raw buffer of the given size, at some offset.
+ * The offset is increased by the size of the data read. */
+std::int32_t readVarIntFromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
+/** Reads a value written by `addVarIntToBuffer` from the given buffer, at some offset.
+ * The offset is increased by the size of the data read. */
+std::int32_t readVarIntFromBuffer(const std::vector<char>& buffer, std::size_t& offset);
+
+/** Ensures that the given buffer has room for at least `numBytes` more bytes, growing it if necessary.
+ * This is intended for buffers whose final size cannot be known in advance. */
+void reserveInBuffer(std::vector<char>& buffer, std::size_t numBytes);
+
 /** Adds a string to the end of the given buffer. */
 void addStringToBuffer(std::vector<char>& buffer, const std::string& s);
 
@@ -51,4 +104,8 @@ void addStringToBuffer(std::vector<char>& buffer, const std::string& s);
  * The offset is increased by the size of the data read. */
 std::string readStringFromBuffer(const std::vector<char>& buffer, std::size_t& offset);
 
+/** Reads a string from a raw buffer of the given size, at some offset.
+ * The offset is increased by the size of the data read. */
+std::string readStringFromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset);
+
 }}  // namespace Rival::BufferUtils
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <vector>
+
+namespace Rival { namespace ChecksumUtils {
+
+/** Computes the CRC-32 (as used by zip files) of the given data. */
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size);
+
+/** Computes the CRC-32 (as used by zip files) of the given data. */
+std::uint32_t crc32(const std::vector<std::uint8_t>& data);
+
+}}  // namespace Rival::ChecksumUtils
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <vector>
+
+namespace Rival { namespace CompressionUtils {
+
+/*
+ * A simple LZ77-style compression scheme, intended for scenario files.
+ *
+ * Scenario files consist mostly of tile definitions, which repeat the same few bytes over and over. The compressed
+ * data is a sequence of tokens, each beginning with a control byte:
+ *
+ *  - 0x00-0x7f: a literal run; the next (c + 1) bytes are copied to the output as-is.
+ *  - 0x80-0xff: a match; a variable-length distance follows, and (c - 0x80 + minMatchLength) bytes are copied from
+ *    that far back in the output. Matches may overlap the bytes they produce, so a distance of 1 repeats a single
+ *    byte, and a distance of 1 tile definition repeats a whole tile.
+ */
+
+/** Shortest sequence of bytes that is worth encoding as a match. */
+static constexpr std::size_t minMatchLength = 3;
+
+/** Longest sequence of bytes that can be encoded as a single match. */
+static constexpr std::size_t maxMatchLength = 0x7f + minMatchLength;
+
+/** Longest sequence of bytes that can be encoded as a single literal run. */
+static constexpr std::size_t maxLiteralLength = 0x80;
+
+/** Furthest distance back that a match may refer to. */
+static constexpr std::size_t maxMatchDistance = 64 * 1024;
+
+/** Compresses the given data. */
+std::vector<char> compress(const std::vector<std::uint8_t>& data);
+
+/**
+ * Decompresses data produced by `compress`.
+ *
+ * @throws std::runtime_error if the data is malformed, or does not decompress to exactly `decompressedSize` bytes.
+ */
+std::vector<std::uint8_t> decompress(const std::vector<char>& data, std::size_t decompressedSize);
+
+}}  // namespace Rival::CompressionUtils
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <string>
+
+namespace Rival {
+
+/**
+ * A read-only view of a file that has been mapped into memory.
+ *
+ * This allows large files to be read without first copying them into a buffer; pages are loaded by the OS on demand.
+ *
+ * Implementation details are platform-specific.
+ */
+class MappedFile
+{
+public:
+    /** Maps the given file into memory. Throws if the file cannot be mapped. */
+    MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    // Prevent copying
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    /** Gets a pointer to the start of the file contents. May be null if the file is empty. */
+    const char* getData() const
+    {
+        return data;
+    }
+
+    /** Gets the size of the file, in bytes. */
+    std::size_t getSize() const
+    {
+        return size;
+    }
+
+private:
+    /** Start of the mapped view. */
+    const char* data = nullptr;
+
+    /** Size of the mapped view, in bytes. */
+    std::size_t size = 0;
+
+    /** Native handle of the open file, if the platform needs to keep it open while mapped. */
+    void* fileHandle = nullptr;
+
+    /** Native handle of the file mapping, if the platform requires one. */
+    void* mappingHandle = nullptr;
+};
+
+}  // namespace Rival
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstddef>  // std::size_t
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Rival {
+
+/**
+ * Thread-safe pool of equally-sized memory blocks.
+ *
+ * Blocks are allocated from the heap in chunks, and kept on a free list when they are released. Once the pool has
+ * grown to its working size, allocating and releasing blocks never touches the heap.
+ */
+class FixedBlockPool
+{
+public:
+    FixedBlockPool(std::size_t blockSize);
+
+    // Prevent copying and moving, since outstanding blocks refer back to this pool
+    FixedBlockPool(const FixedBlockPool& other) = delete;
+    FixedBlockPool(FixedBlockPool&& other) = delete;
+    FixedBlockPool& operator=(const FixedBlockPool& other) = delete;
+    FixedBlockPool& operator=(FixedBlockPool&& other) = delete;
+
+    /** Gets a free block, growing the pool if necessary. */
+    void* allocate();
+
+    /** Returns a block to the pool. */
+    void deallocate(void* block) noexcept;
+
+    /** Gets the size of each block, which may be larger than requested to satisfy alignment requirements. */
+    std::size_t getBlockSize() const
+    {
+        return blockSize;
+    }
+
+private:
+    void deallocateLocked(void* block) noexcept;
+
+private:
+    /** A block that is not currently in use; free blocks are linked together through their own memory. */
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    /** Number of blocks to allocate each time the pool grows. */
+    static constexpr std::size_t blocksPerChunk = 64;
+
+    std::size_t blockSize;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    FreeBlock* freeList = nullptr;
+    std::mutex mutex;
+};
+
+/**
+ * Allocator that takes single objects from a FixedBlockPool shared by all objects of the same type.
+ *
+ * This is intended for use with `std::allocate_shared`, which allocates the object together with its reference
+ * count, so that short-lived shared objects can be created and destroyed without touching the heap. Allocations of
+ * more than one object (e.g. by containers) fall back to the heap.
+ */
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        if (n != 1)
+        {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(getPool().allocate());
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        if (n != 1)
+        {
+            std::allocator<T>().deallocate(ptr, n);
+            return;
+        }
+        getPool().deallocate(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types cannot be pooled");
+
+    static FixedBlockPool& getPool()
+    {
+        static FixedBlockPool pool(sizeof(T));
+        return pool;
+    }
+};
+
+/**
+ * Thread-safe pool of reusable objects of a single type.
+ *
+ * Objects are handed out as shared pointers, and returned to the pool, rather than destroyed, once the last reference
+ * is released. This allows objects that own their own storage (e.g. a vector) to keep it between uses.
+ *
+ * T must be default-constructible and provide a `reset` method, which is called when an object is returned to the
+ * pool so that it does not keep hold of anything while unused. The caller is responsible for initializing an object
+ * after acquiring it.
+ */
+template <typename T>
+class ObjectPool
+{
+public:
+    /** Gets an unused object from the pool, creating a new one if none are free. */
+    static std::shared_ptr<T> acquire()
+    {
+        // The reference count is pooled too, so that recycling an object never touches the heap
+        return std::shared_ptr<T>(getInstance().take(), Recycler(), PoolAllocator<T>());
+    }
+
+private:
+    /** Deleter that returns an object to the pool instead of destroying it. */
+    struct Recycler
+    {
+        void operator()(T* obj) const
+        {
+            obj->reset();
+            getInstance().release(obj);
+        }
+    };
+
+    ~ObjectPool()
+    {
+        for (T* obj : freeObjects)
+        {
+            delete obj;
+        }
+    }
+
+    static ObjectPool& getInstance()
+    {
+        static ObjectPool instance;
+        return instance;
+    }
+
+    T* take()
+    {
+        {
+            std::scoped_lock lock(mutex);
+            if (!freeObjects.empty())
+            {
+                T* obj = freeObjects.back();
+                freeObjects.pop_back();
+                return obj;
+            }
+        }
+
+        return new T();
+    }
+
+    void release(T* obj)
+    {
+        std::scoped_lock lock(mutex);
+        freeObjects.push_back(obj);
+    }
+
+private:
+    std::vector<T*> freeObjects;
+    std::mutex mutex;
+};
+
+}  // namespace Rival
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>  // std::size_t
+#include <utility>  // std::move
+
+namespace Rival {
+
+/**
+ * Bounded, lock-free queue for passing items from one thread to another.
+ *
+ * Exactly one thread may push items and exactly one (other) thread may pop them. Neither operation ever blocks; if
+ * the queue is full or empty, the operation simply fails and it is up to the caller to decide what to do.
+ *
+ * Items are stored in a fixed ring buffer, so the queue never allocates memory after construction.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+public:
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+    /**
+     * Adds an item to the back of the queue. Must only be called by the producer thread.
+     *
+     * Returns false if the queue is full, in which case the item is left untouched.
+     */
+    bool tryPush(T&& item)
+    {
+        const std::size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        slots[currentTail % Capacity] = std::move(item);
+
+        // Publish the item; the consumer cannot see it until this store
+        tail.store(currentTail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the item at the front of the queue. Must only be called by the consumer thread.
+     *
+     * Returns false if the queue is empty.
+     */
+    bool tryPop(T& item)
+    {
+        const std::size_t currentHead = head.load(std::memory_order_relaxed);
+        if (currentHead == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        item = std::move(slots[currentHead % Capacity]);
+
+        // Hand the slot back to the producer
+        head.store(currentHead + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Gets the number of items in the queue.
+     *
+     * This may be called from any thread, but if the queue is in use the result may be out of date by the time it is
+     * returned, so it is only suitable for monitoring.
+     */
+    std::size_t size() const
+    {
+        // Read the head first, so that the tail can never appear to be behind it
+        const std::size_t currentHead = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - currentHead;
+    }
+
+private:
+    /** Assumed cache line size, used to keep the producer and consumer from contending for the same line. */
+    static constexpr std::size_t cacheLineSize = 64;
+
+    std::array<T, Capacity> slots;
+
+    /** Number of items ever popped; only written by the consumer. */
+    alignas(cacheLineSize) std::atomic<std::size_t> head = 0;
+
+    /** Number of items ever pushed; only written by the producer. */
+    alignas(cacheLineSize) std::atomic<std::size_t> tail = 0;
+};
+
+}  // namespace Rival
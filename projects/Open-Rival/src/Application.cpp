@@ -4,9 +4,13 @@
 
 #include "SDLWrapper.h"
 
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>  // std::in_place, std::move
 
+#include "net/packets/JoinRoomPacket.h"
 #include "net/Socket.h"
 #include "ApplicationContext.h"
 #include "ConfigUtils.h"
@@ -16,6 +20,9 @@
 
 namespace Rival {
 
+/** Number of logic updates to run between event polls when fast-forwarding. */
+static constexpr int fastForwardTicksPerPoll = 100;
+
 Application::Application(ApplicationContext& context)
     : context(context)
 {
@@ -25,13 +32,6 @@ void Application::start(std::unique_ptr<State> initialState)
 {
     setState(std::move(initialState));
 
-    Window* window = context.getWindow();
-    const bool vsyncEnabled = window->isVsyncEnabled();
-
-    TimeUtils::PrecisionTimer timer;
-
-    // Game loop
-    Uint32 nextUpdateDue = SDL_GetTicks();
     while (!exiting)
     {
         // Switch to the next State, if set
@@ -40,6 +40,47 @@ void Application::start(std::unique_ptr<State> initialState)
             makeNextStateActive();
         }
 
+        // Each of these runs until we exit, the State changes, or fast-forwarding is toggled
+        if (fastForward)
+        {
+            runFastForward();
+        }
+        else if (state->supportsSimulationThread())
+        {
+            runWithSimulationThread();
+        }
+        else
+        {
+            runSingleThreaded();
+        }
+    }
+}
+
+void Application::runFastForward()
+{
+    // When fast-forwarding, run the logic as fast as possible and skip rendering entirely.
+    // We still poll events periodically so that the window remains responsive.
+    while (!exiting && fastForward && !nextState)
+    {
+        pollEvents();
+        for (int i = 0; i < fastForwardTicksPerPoll && fastForward && !nextState; ++i)
+        {
+            updateState();
+        }
+    }
+}
+
+void Application::runSingleThreaded()
+{
+    Window* window = context.getWindow();
+    const bool vsyncEnabled = window->isVsyncEnabled();
+
+    TimeUtils::PrecisionTimer timer;
+
+    // Game loop
+    Uint32 nextUpdateDue = SDL_GetTicks();
+    while (!exiting && !fastForward && !nextState)
+    {
         // Determine when this frame began.
         // If we are running behind, this will be a long time after
         // nextUpdateDue, so we will have to update the logic multiple
@@ -65,7 +106,7 @@ void Application::start(std::unique_ptr<State> initialState)
             // If vsync is disabled, this should run once per render.
             while (nextUpdateDue <= frameStartTime)
             {
-                state->update();
+                updateState();
                 nextUpdateDue += TimeUtils::timeStepMs;
             }
 
@@ -101,6 +142,120 @@ void Application::start(std::unique_ptr<State> initialState)
     }
 }
 
+/**
+ * Renders on this thread while the logic is updated on a separate simulation thread.
+ *
+ * Only one thread can access the State at a time (except for rendering), but the simulation only holds the state
+ * mutex during a tick, and rendering only takes it to draw the UI.
+ */
+void Application::runWithSimulationThread()
+{
+    Window* window = context.getWindow();
+    const bool vsyncEnabled = window->isVsyncEnabled();
+
+    TimeUtils::PrecisionTimer timer;
+
+    lastUpdateTime = SDL_GetTicks();
+    simulating = true;
+    std::thread simulationThread(&Application::runSimulation, this);
+
+    Uint32 nextFrameDue = SDL_GetTicks();
+    while (!exiting && !fastForward)
+    {
+        {
+            std::scoped_lock lock(stateMutex);
+
+            // Handle events on the queue
+            pollEvents();
+
+            if (nextState)
+            {
+                break;
+            }
+        }
+
+        // Without vsync, render at the same rate as the logic
+        if (!vsyncEnabled)
+        {
+            Uint32 now = SDL_GetTicks();
+            if (now < nextFrameDue)
+            {
+                Uint32 sleepTime = nextFrameDue - now;
+                if (sleepTime >= TimeUtils::minSleepTime)
+                {
+                    timer.wait(sleepTime);
+                }
+                continue;
+            }
+            nextFrameDue = now + TimeUtils::timeStepMs;
+        }
+
+        // Render the game.
+        // The delta may be slightly out of date if a tick is in progress; the State is responsible for reading
+        // consistent data.
+        Uint32 delta = SDL_GetTicks() - lastUpdateTime;
+        state->render(static_cast<int>(delta));
+
+        // Update the window with our newly-rendered game.
+        // If vsync is enabled, this will block execution until the next swap interval, but the simulation will
+        // carry on regardless.
+        window->swapBuffers();
+    }
+
+    simulating = false;
+    simulationThread.join();
+
+    // Errors should be handled in the same way as if the logic had run on this thread
+    if (simulationError)
+    {
+        std::exception_ptr error = simulationError;
+        simulationError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Updates the logic at a fixed rate until told to stop.
+ *
+ * Runs on the simulation thread.
+ */
+void Application::runSimulation()
+{
+    TimeUtils::PrecisionTimer timer;
+
+    Uint32 nextUpdateDue = SDL_GetTicks();
+    while (simulating)
+    {
+        Uint32 now = SDL_GetTicks();
+        if (nextUpdateDue <= now)
+        {
+            try
+            {
+                std::scoped_lock lock(stateMutex);
+                updateState();
+            }
+            catch (...)
+            {
+                // Pass the error back to the main thread
+                simulationError = std::current_exception();
+                exiting = true;
+                return;
+            }
+            lastUpdateTime = nextUpdateDue;
+            nextUpdateDue += TimeUtils::timeStepMs;
+        }
+        else
+        {
+            // Next update is not yet due, so let's sleep (unless the next update is imminent!)
+            Uint32 sleepTime = nextUpdateDue - now;
+            if (sleepTime >= TimeUtils::minSleepTime)
+            {
+                timer.wait(sleepTime);
+            }
+        }
+    }
+}
+
 void Application::pollEvents()
 {
     SDL_Event e;
@@ -139,6 +294,17 @@ void Application::makeNextStateActive()
     state->onLoad();
 }
 
+void Application::updateState()
+{
+    state->update();
+
+    // Send everything that was produced during this tick in a single write
+    if (connection)
+    {
+        connection->flush();
+    }
+}
+
 void Application::startServer(std::uint16_t port)
 {
     std::cout << "Starting server on port " << std::to_string(port) << "\n";
@@ -146,21 +312,30 @@ void Application::startServer(std::uint16_t port)
     server.emplace(port, PlayerStore::maxPlayers);
     server->start();
 
-    // Connect to the server ourselves!
-    connectToServer("localhost", port);
+    // Connect to the server ourselves! We share a process, so there is no need to go through a socket.
+    if (!packetFactory)
+    {
+        packetFactory = std::make_shared<PacketFactory>();
+    }
+    connection.emplace(server->connectLoopback(), packetFactory);
+    connection->send(JoinRoomPacket(Server::defaultRoomId));
 }
 
-void Application::connectToServer(const std::string& address, std::uint16_t port)
+void Application::connectToServer(const std::string& address, std::uint16_t port, int roomId, Transport transport)
 {
-    std::cout << "Connecting to server on port " << std::to_string(port) << "\n";
+    std::cout << "Connecting to room " << std::to_string(roomId) << " on port " << std::to_string(port) << "\n";
 
     if (!packetFactory)
     {
         packetFactory = std::make_shared<PacketFactory>();
     }
 
-    Socket clientSocket = Socket::createClient(address, port);
-    connection.emplace(std::move(clientSocket), packetFactory);
+    Socket clientSocket = transport == Transport::Udp ? Socket::createUdpClient(address, port)
+                                                      : Socket::createClient(address, port);
+    connection.emplace(std::move(clientSocket), packetFactory, transport);
+
+    // The relay server needs to know which game we belong to before anything else is sent
+    connection->send(JoinRoomPacket(roomId));
 }
 
 }  // namespace Rival
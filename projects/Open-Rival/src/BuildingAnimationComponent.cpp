@@ -4,6 +4,7 @@
 
 #include <stdexcept>
 
+#include "utils/BufferUtils.h"
 #include "Animations.h"
 #include "Entity.h"
 #include "Resources.h"
@@ -56,6 +57,25 @@ void BuildingAnimationComponent::update()
     }
 }
 
+void BuildingAnimationComponent::saveState(std::vector<char>& buffer) const
+{
+    BufferUtils::reserveInBuffer(buffer, sizeof(currentAnimFrame) + sizeof(msPassedCurrentAnimFrame));
+    BufferUtils::addToBuffer(buffer, currentAnimFrame);
+    BufferUtils::addToBuffer(buffer, msPassedCurrentAnimFrame);
+}
+
+void BuildingAnimationComponent::restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, currentAnimFrame);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, msPassedCurrentAnimFrame);
+}
+
+void BuildingAnimationComponent::onStateRestored()
+{
+    // The animation itself never changes once the building has spawned
+    refreshSpriteComponent();
+}
+
 void BuildingAnimationComponent::setAnimation(const Animation* newAnimation)
 {
     animation = newAnimation;
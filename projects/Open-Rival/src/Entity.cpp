@@ -2,6 +2,12 @@
 
 #include "Entity.h"
 
+#include <cstdint>
+#include <cstring>  // std::memcpy
+#include <stdexcept>
+
+#include "utils/BufferUtils.h"
+
 namespace Rival {
 
 Entity::Entity(EntityType type, int width, int height)
@@ -70,6 +76,116 @@ void Entity::onDelete()
     components.clear();
 }
 
+void Entity::saveState(std::vector<char>& buffer) const
+{
+    BufferUtils::reserveInBuffer(buffer, sizeof(pos) + sizeof(std::uint8_t) + sizeof(std::uint32_t));
+    BufferUtils::addToBuffer(buffer, pos);
+    BufferUtils::addToBuffer(buffer, static_cast<std::uint8_t>(deleted));
+    BufferUtils::addToBuffer(buffer, static_cast<std::uint32_t>(components.size()));
+
+    for (auto const& kv : components)
+    {
+        const std::string& key = kv.first;
+        const auto& component = kv.second;
+
+        BufferUtils::reserveInBuffer(buffer, sizeof(std::size_t) + key.size() + sizeof(std::uint32_t));
+        BufferUtils::addStringToBuffer(buffer, key);
+
+        // Reserve space for the size of the component state, which is filled in once the state has been written
+        const std::size_t stateSizeOffset = buffer.size();
+        BufferUtils::addToBuffer(buffer, std::uint32_t(0));
+
+        component->saveState(buffer);
+
+        const std::uint32_t stateSize =
+                static_cast<std::uint32_t>(buffer.size() - stateSizeOffset - sizeof(std::uint32_t));
+        std::memcpy(buffer.data() + stateSizeOffset, &stateSize, sizeof(stateSize));
+    }
+}
+
+void Entity::restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, pos);
+
+    std::uint8_t deletedFlag = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, deletedFlag);
+    deleted = deletedFlag != 0;
+
+    std::uint32_t numComponents = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, numComponents);
+    if (numComponents != components.size())
+    {
+        throw std::runtime_error("Component mismatch when restoring entity " + std::to_string(id));
+    }
+
+    for (std::uint32_t i = 0; i < numComponents; ++i)
+    {
+        const std::string key = BufferUtils::readStringFromBuffer(buffer, bufferSize, offset);
+        std::uint32_t stateSize = 0;
+        BufferUtils::readFromBuffer(buffer, bufferSize, offset, stateSize);
+
+        auto it = components.find(key);
+        if (it == components.cend())
+        {
+            throw std::runtime_error("Unknown component when restoring entity " + std::to_string(id) + ": " + key);
+        }
+
+        const std::size_t stateEnd = offset + stateSize;
+        if (stateEnd > bufferSize)
+        {
+            throw std::runtime_error("Trying to read past end of buffer");
+        }
+
+        // Each component is limited to its own state, so it cannot read into the next one
+        it->second->restoreState(buffer, stateEnd, offset);
+        if (offset != stateEnd)
+        {
+            throw std::runtime_error("Failed to restore component state: " + key);
+        }
+    }
+
+    for (auto const& kv : components)
+    {
+        kv.second->onStateRestored();
+    }
+
+    moved = true;
+}
+
+void Entity::checkState(const char* buffer, std::size_t bufferSize, std::size_t& offset) const
+{
+    MapNode savedPos;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, savedPos);
+
+    std::uint8_t deletedFlag = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, deletedFlag);
+
+    std::uint32_t numComponents = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, numComponents);
+    if (numComponents != components.size())
+    {
+        throw std::runtime_error("Component mismatch when restoring entity " + std::to_string(id));
+    }
+
+    for (std::uint32_t i = 0; i < numComponents; ++i)
+    {
+        const std::string key = BufferUtils::readStringFromBuffer(buffer, bufferSize, offset);
+        std::uint32_t stateSize = 0;
+        BufferUtils::readFromBuffer(buffer, bufferSize, offset, stateSize);
+
+        if (components.find(key) == components.cend())
+        {
+            throw std::runtime_error("Unknown component when restoring entity " + std::to_string(id) + ": " + key);
+        }
+
+        if (offset + stateSize > bufferSize)
+        {
+            throw std::runtime_error("Trying to read past end of buffer");
+        }
+        offset += stateSize;
+    }
+}
+
 void Entity::setPos(MapNode newPos)
 {
     pos = newPos;
@@ -4,42 +4,87 @@
 
 #include <gl/glew.h>
 
-#include <algorithm>  // min
+#include <algorithm>  // std::min, std::sort
+#include <cstddef>  // std::size_t
+#include <functional>  // std::less
+#include <iterator>  // std::cbegin, std::cend
 #include <vector>
 
 #include "Camera.h"
 #include "Entity.h"
 #include "MapUtils.h"
-#include "MouseHandlerComponent.h"
-#include "OwnerComponent.h"
+#include "MovementComponent.h"
 #include "Palette.h"
 #include "Pathfinding.h"
-#include "PlayerContext.h"
-#include "PlayerState.h"
+#include "Rect.h"
+#include "RenderSnapshot.h"
 #include "RenderUtils.h"
 #include "Resources.h"
 #include "Shaders.h"
-#include "SpriteComponent.h"
 #include "Spritesheet.h"
 #include "Texture.h"
-#include "WalkerComponent.h"
 
 namespace Rival {
 
-EntityRenderer::EntityRenderer(const TextureStore& textureStore, const PlayerContext& playerContext)
+EntityRenderer::EntityRenderer(const TextureStore& textureStore)
     : paletteTexture(textureStore.getPalette())
     , hitboxRenderable(textureStore.getHitboxSpritesheet(), numHitboxSprites)
-    , playerContext(playerContext)
 {
+    batchPositions.reserve(
+            SpriteRenderable::numVerticesPerSprite * SpriteRenderable::numVertexDimensions * maxSpritesPerBatch);
+    batchTexCoords.reserve(
+            SpriteRenderable::numVerticesPerSprite * SpriteRenderable::numTexCoordDimensions * maxSpritesPerBatch);
 }
 
-void EntityRenderer::render(const Camera& camera, SharedEntityList entities, int delta) const
+void EntityRenderer::render(const RenderSnapshot& snapshot, int delta) const
 {
-    for (auto const& e : entities)
+    visibleEntities.clear();
+    for (const EntityRenderState& entity : snapshot.entities)
     {
-        if (isEntityVisible(*e, camera))
+        if (isEntityVisible(entity.pos, *snapshot.camera))
         {
-            renderEntity(*e, delta);
+            visibleEntities.push_back(&entity);
+        }
+    }
+
+    // Group Entities that can be drawn together. Draw order does not matter since we rely on depth testing.
+    std::sort(
+            visibleEntities.begin(),
+            visibleEntities.end(),
+            [](const EntityRenderState* a, const EntityRenderState* b) {
+                if (a->spritesheet != b->spritesheet)
+                {
+                    return std::less<const Spritesheet*>()(a->spritesheet, b->spritesheet);
+                }
+                return a->paletteIndex < b->paletteIndex;
+            });
+
+    std::size_t batchStart = 0;
+    while (batchStart < visibleEntities.size())
+    {
+        const EntityRenderState& first = *visibleEntities[batchStart];
+        batchPositions.clear();
+        batchTexCoords.clear();
+
+        std::size_t batchEnd = batchStart;
+        while (batchEnd < visibleEntities.size() && batchEnd - batchStart < static_cast<std::size_t>(maxSpritesPerBatch)
+               && visibleEntities[batchEnd]->spritesheet == first.spritesheet
+               && visibleEntities[batchEnd]->paletteIndex == first.paletteIndex)
+        {
+            addToBatch(*visibleEntities[batchEnd], delta);
+            ++batchEnd;
+        }
+
+        renderBatch(*first.spritesheet, first.paletteIndex, static_cast<int>(batchEnd - batchStart));
+        batchStart = batchEnd;
+    }
+
+    // Render hitbox of the Entity under the mouse
+    for (const EntityRenderState* entity : visibleEntities)
+    {
+        if (entity->underMouse)
+        {
+            renderHitbox(*entity);
         }
     }
 
@@ -47,10 +92,9 @@ void EntityRenderer::render(const Camera& camera, SharedEntityList entities, int
     glUniform1f(Shaders::indexedTextureShader.paletteTxYUnitUniformLoc, 0);
 }
 
-bool EntityRenderer::isEntityVisible(const Entity& entity, const Camera& camera) const
+bool EntityRenderer::isEntityVisible(const MapNode& pos, const Camera& camera) const
 {
     // Find the centre of this Entity's tile, in Camera units
-    const MapNode& pos = entity.getPos();
     float x = static_cast<float>(pos.x + Camera::tileWidth / 2.0f);
     float y = static_cast<float>(pos.y + Camera::tileHeight / 2.0f);
 
@@ -69,72 +113,16 @@ bool EntityRenderer::isEntityVisible(const Entity& entity, const Camera& camera)
     return camera.contains(x1, y1) || camera.contains(x2, y1) || camera.contains(x2, y2) || camera.contains(x1, y2);
 }
 
-void EntityRenderer::renderEntity(const Entity& entity, int delta) const
+void EntityRenderer::addToBatch(const EntityRenderState& entity, int delta) const
 {
-    // Get this Entity's SpriteComponent
-    const SpriteComponent* spriteComponent = entity.getComponent<SpriteComponent>(SpriteComponent::key);
-
-    // Entities without a SpriteComponent cannot be rendered
-    if (!spriteComponent)
-    {
-        return;
-    }
-
-    // Determine palette based on owner
-    int paletteIndex = PaletteUtils::paletteIndexGame;
-    const auto owner = entity.getComponent<OwnerComponent>(OwnerComponent::key);
-    if (owner)
-    {
-        paletteIndex += owner->getPlayerId();
-    }
-    float paletteTxy = PaletteUtils::getPaletteTxY(paletteIndex);
-    glUniform1f(Shaders::indexedTextureShader.paletteTxYUnitUniformLoc, paletteTxy);
-
-    // Use textures
-    const SpriteRenderable& renderable = spriteComponent->getRenderable();
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, renderable.getTextureId());
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, paletteTexture->getId());
-
-    // Bind vertex array
-    glBindVertexArray(renderable.getVao());
-
-    // Update the data on the GPU
-    if (needsUpdate(entity, *spriteComponent))
-    {
-        sendDataToGpu(entity, *spriteComponent, delta);
-    }
-
-    // Render
-    glDrawElements(renderable.getDrawMode(), renderable.getIndicesPerSprite(), GL_UNSIGNED_INT, nullptr);
-
-    // Render hitbox
-    if (isEntityUnderMouse(entity))
-    {
-        renderHitbox(entity);
-    }
-}
-
-bool EntityRenderer::needsUpdate(const Entity& entity, const SpriteComponent& spriteComponent) const
-{
-    return entity.moved || spriteComponent.dirty;
-}
-
-void EntityRenderer::sendDataToGpu(const Entity& entity, const SpriteComponent& spriteComponent, int delta) const
-{
-    // Determine the frame of the texture to be rendered
-    int txIndex = spriteComponent.getTxIndex();
-
     // Define vertex positions
-    const MapNode& pos = entity.getPos();
+    const MapNode& pos = entity.pos;
     float x1 = static_cast<float>(RenderUtils::tileToPx_X(pos.x));
     float y1 = static_cast<float>(RenderUtils::tileToPx_Y(pos.x, pos.y));
     x1 += static_cast<float>(RenderUtils::entityDrawOffsetX);
     y1 += static_cast<float>(RenderUtils::entityDrawOffsetY);
 
-    glm::vec2 lerpOffset = getLerpOffset(entity, delta);
-    spriteComponent.lastLerpOffset = lerpOffset;
+    glm::vec2 lerpOffset = getLerpOffset(pos, entity.movement, delta);
     x1 += lerpOffset.x;
     y1 += lerpOffset.y;
 
@@ -144,29 +132,64 @@ void EntityRenderer::sendDataToGpu(const Entity& entity, const SpriteComponent&
     float y2 = y1 + height;
 
     float z = RenderUtils::getEntityZ(pos.x, pos.y);
-    std::vector<GLfloat> vertexData = {
+    const GLfloat vertexData[] = {
         x1, y1, z,  //
         x2, y1, z,  //
         x2, y2, z,  //
         x1, y2, z   //
     };
+    batchPositions.insert(batchPositions.cend(), std::cbegin(vertexData), std::cend(vertexData));
 
     // Determine texture co-ordinates
-    const SpriteRenderable& renderable = spriteComponent.getRenderable();
-    std::vector<GLfloat> texCoords = renderable.spritesheet.getTexCoords(txIndex);
+    std::vector<GLfloat> texCoords = entity.spritesheet->getTexCoords(entity.txIndex);
+    batchTexCoords.insert(batchTexCoords.cend(), texCoords.cbegin(), texCoords.cend());
+}
+
+void EntityRenderer::renderBatch(const Spritesheet& spritesheet, int paletteIndex, int numSprites) const
+{
+    usePalette(paletteIndex);
+
+    // Use textures
+    const SpriteRenderable& renderable = getBatchRenderable(spritesheet);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, renderable.getTextureId());
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, paletteTexture->getId());
+
+    // Bind vertex array
+    glBindVertexArray(renderable.getVao());
 
     // Upload position data
     glBindBuffer(GL_ARRAY_BUFFER, renderable.getPositionVbo());
-    int positionBufferSize = vertexData.size() * sizeof(GLfloat);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, positionBufferSize, vertexData.data());
+    int positionBufferSize = batchPositions.size() * sizeof(GLfloat);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, positionBufferSize, batchPositions.data());
 
     // Upload tex co-ord data
     glBindBuffer(GL_ARRAY_BUFFER, renderable.getTexCoordVbo());
-    int texCoordBufferSize = texCoords.size() * sizeof(GLfloat);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, texCoordBufferSize, texCoords.data());
+    int texCoordBufferSize = batchTexCoords.size() * sizeof(GLfloat);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, texCoordBufferSize, batchTexCoords.data());
 
-    // Clear the dirty flag now that the GPU is up to date
-    spriteComponent.dirty = false;
+    // Render
+    glDrawElements(
+            renderable.getDrawMode(), renderable.getIndicesPerSprite() * numSprites, GL_UNSIGNED_INT, nullptr);
+}
+
+const SpriteRenderable& EntityRenderer::getBatchRenderable(const Spritesheet& spritesheet) const
+{
+    auto iter = batchRenderables.find(&spritesheet);
+    if (iter == batchRenderables.cend())
+    {
+        iter = batchRenderables
+                       .emplace(&spritesheet, std::make_unique<SpriteRenderable>(spritesheet, maxSpritesPerBatch))
+                       .first;
+    }
+    return *iter->second;
+}
+
+void EntityRenderer::usePalette(int paletteIndex) const
+{
+    float paletteTxy = PaletteUtils::getPaletteTxY(paletteIndex);
+    glUniform1f(Shaders::indexedTextureShader.paletteTxYUnitUniformLoc, paletteTxy);
 }
 
 /**
@@ -181,18 +204,22 @@ void EntityRenderer::sendDataToGpu(const Entity& entity, const SpriteComponent&
  */
 glm::vec2 EntityRenderer::getLerpOffset(const Entity& entity, int delta)
 {
-    glm::vec2 offset = { 0, 0 };
-
     // See if the Entity can move
     // TODO: This needs to work for flying units too
     const MovementComponent* moveComponent = entity.getComponent<MovementComponent>(MovementComponent::key);
     if (!moveComponent)
     {
-        return offset;
+        return { 0, 0 };
     }
 
+    return getLerpOffset(entity.getPos(), moveComponent->getMovement(), delta);
+}
+
+glm::vec2 EntityRenderer::getLerpOffset(const MapNode& pos, const Movement& movement, int delta)
+{
+    glm::vec2 offset = { 0, 0 };
+
     // See if the Entity is currently moving
-    const Movement& movement = moveComponent->getMovement();
     if (!movement.isValid())
     {
         return offset;
@@ -202,7 +229,7 @@ glm::vec2 EntityRenderer::getLerpOffset(const Entity& entity, int delta)
     const MapNode& nextNode = movement.destination;
 
     // Determine the direction of movement
-    Facing dir = MapUtils::getDir(entity.getPos(), nextNode);
+    Facing dir = MapUtils::getDir(pos, nextNode);
 
     // Determine the overall "progress" through the movement (0-1)
     int timeElapsed = movement.timeElapsed + delta;
@@ -247,26 +274,10 @@ glm::vec2 EntityRenderer::getLerpOffset(const Entity& entity, int delta)
     return offset;
 }
 
-bool EntityRenderer::isEntityUnderMouse(const Entity& entity) const
-{
-    if (const auto& entityUnderMouse = playerContext.weakEntityUnderMouse.lock())
-    {
-        return entity.getId() == entityUnderMouse->getId();
-    }
-
-    return false;
-}
-
-void EntityRenderer::renderHitbox(const Entity& entity) const
+void EntityRenderer::renderHitbox(const EntityRenderState& entity) const
 {
-    const MouseHandlerComponent* mouseHandler = entity.getComponent<MouseHandlerComponent>(MouseHandlerComponent::key);
-    if (!mouseHandler)
-    {
-        std::cerr << "Could not find MouseHandlerComponent for entity under mouse\n";
-        return;
-    }
-
-    const Rect& hitbox = mouseHandler->getHitbox();
+    const Rect& hitbox = entity.hitbox;
+    usePalette(entity.paletteIndex);
 
     // Use textures
     glActiveTexture(GL_TEXTURE0);
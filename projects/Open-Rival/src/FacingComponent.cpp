@@ -2,6 +2,7 @@
 
 #include "FacingComponent.h"
 
+#include "utils/BufferUtils.h"
 #include "Entity.h"
 #include "MapUtils.h"
 
@@ -32,6 +33,18 @@ void FacingComponent::onDelete()
     }
 }
 
+void FacingComponent::saveState(std::vector<char>& buffer) const
+{
+    BufferUtils::reserveInBuffer(buffer, sizeof(facing));
+    BufferUtils::addToBuffer(buffer, facing);
+}
+
+void FacingComponent::restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    // Listeners are not notified here; they are responsible for refreshing themselves once restored
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, facing);
+}
+
 void FacingComponent::onUnitMoveStart(const MapNode* nextNode)
 {
     Facing newFacing = MapUtils::getDir(entity->getPos(), *nextNode);
@@ -15,6 +15,7 @@
 #include "PlayerContext.h"
 #include "PlayerState.h"
 #include "Rect.h"
+#include "RenderSnapshot.h"
 #include "RenderUtils.h"
 #include "Resources.h"
 #include "Shaders.h"
@@ -27,38 +28,40 @@ GameRenderer::GameRenderer(
         const Window* window,
         const World& world,
         const PlayerStore& playerStore,
-        const Camera& camera,
         const Rect& viewport,
         const Resources& res,
         const PlayerContext& playerContext)
     : window(window)
-    , world(world)
-    , camera(camera)
     , viewport(viewport)
     , gameFbo(framebufferWidth, framebufferHeight, true)
     , gameFboRenderer(gameFbo)
-    , tileRenderer(res.getTileSpritesheet(world.isWilderness()), res.getPalette())
+    , tileRenderer(
+              res.getTileSpritesheet(world.isWilderness()),
+              res.getPalette(),
+              world.getTiles(),
+              world.getTilesVersion(),
+              world.getWidth(),
+              world.getHeight())
     , mapBorderRenderer(
               playerStore.getLocalPlayerState().getRace(),
               world.getWidth(),
               world.getHeight(),
               res.getMapBorderSpritesheet(),
               res.getPalette())
-    , entityRenderer(res, playerContext)
+    , entityRenderer(res)
     , uiRenderer(playerStore, res, res, window, playerContext)
 {
 }
 
-void GameRenderer::render(int delta)
+void GameRenderer::renderWorld(const RenderSnapshot& snapshot, int delta) const
 {
-    renderGameViaFramebuffer(delta);
-    renderUi();
-    renderText();
-    renderCursor(delta);
-}
+    // Nothing has been published yet
+    if (!snapshot.camera)
+    {
+        return;
+    }
+    const Camera& camera = *snapshot.camera;
 
-void GameRenderer::renderGameViaFramebuffer(int delta) const
-{
     // Render to our framebuffer.
     // Here the viewport specifies the region of the framebuffer texture
     // that we render onto, in pixels. We use the camera size here; if the
@@ -68,7 +71,7 @@ void GameRenderer::renderGameViaFramebuffer(int delta) const
     int canvasWidth = RenderUtils::getCanvasWidth(camera.getWidth());
     int canvasHeight = RenderUtils::getCanvasHeight(camera.getHeight());
     glViewport(0, 0, canvasWidth, canvasHeight);
-    renderGame(canvasWidth, canvasHeight, delta);
+    renderGame(snapshot, canvasWidth, canvasHeight, delta);
 
     // Render the framebuffer to the screen.
     // Here the viewport specifies the region of the game window that we
@@ -83,8 +86,17 @@ void GameRenderer::renderGameViaFramebuffer(int delta) const
     renderFramebuffer(canvasWidth, canvasHeight);
 }
 
-void GameRenderer::renderGame(int viewportWidth, int viewportHeight, int delta) const
+void GameRenderer::renderInterface(int delta, const std::vector<std::string>& overlayLines)
+{
+    renderUi();
+    renderText(overlayLines);
+    renderCursor(delta);
+}
+
+void GameRenderer::renderGame(const RenderSnapshot& snapshot, int viewportWidth, int viewportHeight, int delta) const
 {
+    const Camera& camera = *snapshot.camera;
+
     // Clear framebuffer
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -92,25 +104,34 @@ void GameRenderer::renderGame(int viewportWidth, int viewportHeight, int delta)
     // ordering
     glEnable(GL_DEPTH_TEST);
 
-    // Use indexed texture shader
-    glUseProgram(Shaders::indexedTextureShader.programId);
-
     // Determine our view-projection matrix
     glm::mat4 viewProjMatrix = RenderUtils::createGameViewProjectionMatrix(camera, viewportWidth, viewportHeight);
 
+    // Use tilemap shader
+    glUseProgram(Shaders::tilemapShader.programId);
+
+    // Set uniform values
+    glUniformMatrix4fv(Shaders::tilemapShader.viewProjMatrixUniformLoc, 1, GL_FALSE, &viewProjMatrix[0][0]);
+    glUniform1i(Shaders::tilemapShader.texUnitUniformLoc, 0);
+    glUniform1i(Shaders::tilemapShader.paletteTexUnitUniformLoc, 1);
+    glUniform1i(Shaders::tilemapShader.tileIndicesTexUnitUniformLoc, TileRenderer::tileIndicesTexUnit);
+
+    // Render Tiles
+    tileRenderer.render(snapshot.tiles, snapshot.tilesVersion);
+
+    // Use indexed texture shader
+    glUseProgram(Shaders::indexedTextureShader.programId);
+
     // Set uniform values
     glUniformMatrix4fv(Shaders::indexedTextureShader.viewProjMatrixUniformLoc, 1, GL_FALSE, &viewProjMatrix[0][0]);
     glUniform1i(Shaders::indexedTextureShader.texUnitUniformLoc, 0);
     glUniform1i(Shaders::indexedTextureShader.paletteTexUnitUniformLoc, 1);
 
-    // Render Tiles
-    tileRenderer.render(camera, world.getTiles(), world.getWidth(), world.getHeight());
-
     // Render Map Borders
     mapBorderRenderer.render();
 
     // Render Entities
-    entityRenderer.render(camera, world.getEntities(), delta);
+    entityRenderer.render(snapshot, delta);
 }
 
 void GameRenderer::renderFramebuffer(int srcWidth, int srcHeight) const
@@ -161,7 +182,7 @@ void GameRenderer::renderUi()
     uiRenderer.renderUi();
 }
 
-void GameRenderer::renderText()
+void GameRenderer::renderText(const std::vector<std::string>& overlayLines)
 {
     // Disable depth testing since text is always on top
     glDisable(GL_DEPTH_TEST);
@@ -169,7 +190,7 @@ void GameRenderer::renderText()
     // Render the UI to the screen
     // (the MenuTextRenderer takes care of the shader, projection, etc.)
     glViewport(0, 0, window->getWidth(), window->getHeight());
-    uiRenderer.renderText();
+    uiRenderer.renderText(overlayLines);
 }
 
 void GameRenderer::renderCursor(int delta)
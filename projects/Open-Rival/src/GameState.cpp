@@ -2,30 +2,46 @@
 
 #include "GameState.h"
 
+#include <algorithm>  // std::clamp, std::max
 #include <map>  // std::cend
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <utility>  // std::move
 
 #include "net/Connection.h"
 #include "net/packet-handlers/GameCommandPacketHandler.h"
+#include "net/packet-handlers/LatencyReportPacketHandler.h"
 #include "net/packet-handlers/PacketHandler.h"
+#include "net/packet-handlers/PingPacketHandler.h"
 #include "net/packets/GameCommandPacket.h"
+#include "net/packets/LatencyReportPacket.h"
+#include "net/packets/PingPacket.h"
 #include "Application.h"
 #include "ApplicationContext.h"
 #include "EnumUtils.h"
 #include "GameInterface.h"
 #include "Image.h"
 #include "InputUtils.h"
+#include "MouseHandlerComponent.h"
 #include "MouseUtils.h"
+#include "MovementComponent.h"
+#include "OwnerComponent.h"
 #include "Palette.h"
 #include "Race.h"
 #include "RenderUtils.h"
+#include "SetCommandDelayCommand.h"
+#include "SpriteComponent.h"
 #include "Spritesheet.h"
 #include "TimeUtils.h"
+#include "WorldSnapshot.h"
 
 namespace Rival {
 
+// Client readiness is stored as a bitmask
+static_assert(PlayerStore::maxPlayers <= 32, "Too many players for client bitmask");
+
 GameState::GameState(
         Application& app,
         std::unique_ptr<World> scenarioToMove,
@@ -42,34 +58,91 @@ GameState::GameState(
              RenderUtils::pxToCamera_Y(static_cast<float>(viewport.height)),
              *world)
     , mousePicker(camera, viewport, *world, playerContext, *this, *this)
-    , gameRenderer(window, *world, *this, camera, viewport, res, playerContext)
+    , gameRenderer(window, *world, *this, viewport, res, playerContext)
     , clients(clients)
     , localPlayerId(localPlayerId)
 {
     // Register PacketHandlers
     packetHandlers.insert({ PacketType::GameCommand, std::make_unique<GameCommandPacketHandler>() });
+    packetHandlers.insert({ PacketType::Ping, std::make_unique<PingPacketHandler>() });
+    packetHandlers.insert({ PacketType::LatencyReport, std::make_unique<LatencyReportPacketHandler>() });
+
+    // Determine which clients we need to hear from each tick
+    for (const auto& entry : this->clients)
+    {
+        int clientId = entry.first;
+        if (clientId < 0 || clientId >= PlayerStore::maxPlayers)
+        {
+            throw std::runtime_error("Invalid client ID: " + std::to_string(clientId));
+        }
+        scheduler.addClient(clientId);
+    }
+}
+
+GameState::~GameState()
+{
+    if (replayWriter)
+    {
+        replayWriter->close(scheduler.getCurrentTick());
+    }
+
+    if (isNetGame())
+    {
+        std::cout << "Stalled " << lockstepMetrics.numStalls << " times for a total of "
+                  << lockstepMetrics.totalStallMs << "ms; command delay changed "
+                  << lockstepMetrics.numDelayChanges << " times\n";
+    }
 }
 
 void GameState::onLoad()
 {
     app.getContext().getAudioSystem().playMidi(res.getMidi(0));
+
+    lastNetMetricsTime = SDL_GetTicks();
+    lastNetLogTime = lastNetMetricsTime;
+
+    // Give the renderer something to draw before the first tick
+    publishRenderSnapshot();
 }
 
 void GameState::update()
 {
     pollNetwork();
-    if (!isTickReady())
+
+    const bool tickReady = isTickReady();
+    updateStallMetrics(tickReady);
+    updateNetTelemetry();
+    if (!tickReady)
     {
         return;
     }
 
-    world->addPendingEntities();
-    earlyUpdateEntities();
+    rollBack();
     respondToInput();
+    sendLatencyInfo();
+    adjustCommandDelay();
     sendOutgoingCommands();
+    scheduleReplayCommands();
+    simulateTick();
+    scheduler.advanceTick();
+    confirmTicks();
+    scheduler.clearExpiredTick();
+    checkReplayFinished();
+    publishRenderSnapshot();
+}
+
+/**
+ * Advances the World by one tick.
+ *
+ * This must be entirely deterministic, since it may be re-run when rolling back.
+ */
+void GameState::simulateTick()
+{
+    world->addPendingEntities();
+    saveSnapshot();
+    earlyUpdateEntities();
     updateEntities();
     processCommands();
-    ++currentTick;
 }
 
 bool GameState::isTickReady()
@@ -79,24 +152,13 @@ bool GameState::isTickReady()
         return true;
     }
 
-    if (currentTick < TimeUtils::netCommandDelay)
+    if (scheduler.isRollbackEnabled())
     {
-        // No commands should be scheduled before this time
-        return true;
+        // We can simulate ahead of the other clients, but only as far as we can roll back
+        return scheduler.getCurrentTick() - firstUnconfirmedTick < LockstepScheduler::maxRollbackTicks;
     }
 
-    auto iter = clientsReady.find(currentTick);
-    if (iter == clientsReady.cend())
-    {
-        // No clients are ready! We can still process the next tick if we are the only player (unlikely for a net game,
-        // but technically possible).
-        return clients.empty();
-    }
-
-    std::unordered_set<int>& clientsReadyForTick = iter->second;
-    size_t numClientsReady = clientsReadyForTick.size();
-
-    return numClientsReady == clients.size();
+    return scheduler.isCurrentTickReady();
 }
 
 void GameState::pollNetwork()
@@ -106,9 +168,11 @@ void GameState::pollNetwork()
         return;
     }
 
-    const auto& receivedPackets = app.getConnection()->getReceivedPackets();
+    app.getConnection()->getReceivedPackets(receivedPackets);
     for (auto& packet : receivedPackets)
     {
+        latencyTracker.addArrival(packet->getRelayTime(), packet->getReceiveTime());
+
         auto iter = packetHandlers.find(packet->getType());
         if (iter == packetHandlers.cend())
         {
@@ -119,6 +183,9 @@ void GameState::pollNetwork()
 
         iter->second->onPacketReceived(packet, *this);
     }
+
+    // Release the packets straight away, so that they can be reused
+    receivedPackets.clear();
 }
 
 void GameState::earlyUpdateEntities() const
@@ -167,13 +234,161 @@ void GameState::sendOutgoingCommands()
         return;
     }
 
+    const std::optional<SendTick> sendTick = scheduler.takeSendTick(getCommandDelay(), !outgoingCommands.empty());
+    if (!sendTick)
+    {
+        return;
+    }
+
+    // Commands are only scheduled locally now that we know which tick they will be sent for
+    for (const auto& command : outgoingCommands)
+    {
+        scheduleCommand(command, sendTick->tick);
+    }
+
     // Send all commands for this tick to the server
-    GameCommandPacket packet(outgoingCommands, currentTick + TimeUtils::netCommandDelay);
+    GameCommandPacket packet(outgoingCommands, sendTick->tick, sendTick->previousTick);
     app.getConnection()->send(packet);
     outgoingCommands.clear();
 }
 
-void GameState::updateEntities() const
+void GameState::sendLatencyInfo()
+{
+    if (!isNetGame() || !app.getConnection()->isOpen() || scheduler.getCurrentTick() % latencyIntervalTicks != 0)
+    {
+        return;
+    }
+
+    if (latencyTracker.hasRtt())
+    {
+        LatencyReportPacket reportPacket(latencyTracker.getRtt(), latencyTracker.getJitter());
+        app.getConnection()->send(reportPacket);
+    }
+
+    PingPacket pingPacket(TimeUtils::getNetTimestamp());
+    app.getConnection()->send(pingPacket);
+}
+
+void GameState::adjustCommandDelay()
+{
+    // The host decides the command delay for everyone
+    if (!isNetGame() || scheduler.isRollbackEnabled() || localPlayerId != 0 || !latencyTracker.hasRtt()
+        || scheduler.getCurrentTick() % commandDelayIntervalTicks != 0)
+    {
+        return;
+    }
+
+    // A command has to travel from the sender to the relay server and on to every other client, which takes roughly
+    // half of the sender's round-trip time plus half of the recipient's. This is bounded by the worst round-trip time.
+    std::uint32_t worstLatencyMs = latencyTracker.getRtt() + jitterMultiplier * latencyTracker.getJitter();
+    for (const auto& entry : latencyReports)
+    {
+        const LatencyReport& report = entry.second;
+        worstLatencyMs = std::max(worstLatencyMs, report.rttMs + jitterMultiplier * report.jitterMs);
+    }
+
+    // Commands are only sent once per tick, so allow an extra tick for that
+    int requiredDelay = static_cast<int>(worstLatencyMs / TimeUtils::timeStepMs) + 2;
+    requiredDelay = std::clamp(requiredDelay, LockstepScheduler::minCommandDelay, LockstepScheduler::maxCommandDelay);
+
+    int newDelay = requiredDelay;
+    if (requiredDelay < commandDelay)
+    {
+        // Reduce the delay gradually in case the improvement is only temporary
+        newDelay = commandDelay - 1;
+    }
+
+    if (newDelay != commandDelay)
+    {
+        dispatchCommand(std::make_shared<SetCommandDelayCommand>(newDelay));
+    }
+}
+
+void GameState::updateStallMetrics(bool tickReady)
+{
+    const Uint32 now = SDL_GetTicks();
+
+    if (!tickReady)
+    {
+        if (!stalled)
+        {
+            stalled = true;
+            stallStartTime = now;
+            ++lockstepMetrics.numStalls;
+        }
+
+        // Record who we are waiting for. With rollback, we are held up by the oldest tick that is still missing
+        // commands, rather than the current tick.
+        const int blockingTick = scheduler.isRollbackEnabled() ? firstUnconfirmedTick : scheduler.getCurrentTick();
+        netTelemetry.addStalledUpdate(scheduler.getMissingClients(blockingTick));
+        return;
+    }
+
+    if (stalled)
+    {
+        lockstepMetrics.totalStallMs += now - stallStartTime;
+        stalled = false;
+    }
+}
+
+/**
+ * Collects the network metrics once per telemetry interval, and logs them periodically.
+ *
+ * This runs even while we are stalled, since that is when the metrics are most interesting.
+ */
+void GameState::updateNetTelemetry()
+{
+    if (!isNetGame())
+    {
+        return;
+    }
+
+    const Uint32 now = SDL_GetTicks();
+    const Uint32 elapsed = now - lastNetMetricsTime;
+    if (elapsed < NetTelemetry::metricsIntervalMs)
+    {
+        return;
+    }
+    lastNetMetricsTime = now;
+
+    netMetrics = netTelemetry.collectMetrics(elapsed, app.getConnection()->getStats());
+    if (latencyTracker.hasRtt())
+    {
+        netMetrics.rttMs = latencyTracker.getRtt();
+        netMetrics.jitterMs = latencyTracker.getJitter();
+    }
+
+    // Log any interval in which we stalled, so that hitches can be diagnosed after the fact
+    if (netMetrics.stalledUpdates > 0 || now - lastNetLogTime >= NetTelemetry::logIntervalMs)
+    {
+        logNetMetrics();
+        lastNetLogTime = now;
+    }
+
+    refreshNetOverlay();
+}
+
+void GameState::logNetMetrics() const
+{
+    std::cout << "Net at tick " << scheduler.getCurrentTick() << ": " << NetTelemetry::formatTraffic(netMetrics) << "; "
+              << NetTelemetry::formatLatency(netMetrics) << "; " << NetTelemetry::formatStalls(netMetrics) << "\n";
+}
+
+void GameState::refreshNetOverlay()
+{
+    netOverlayLines.clear();
+    if (!netOverlayVisible)
+    {
+        return;
+    }
+
+    netOverlayLines.push_back("Command delay: " + std::to_string(commandDelay) + " ticks");
+    netOverlayLines.push_back(NetTelemetry::formatTraffic(netMetrics));
+    netOverlayLines.push_back(NetTelemetry::formatLatency(netMetrics));
+    netOverlayLines.push_back(NetTelemetry::formatStalls(netMetrics));
+}
+
+void GameState::updateEntities()
 {
     std::vector<std::shared_ptr<Entity>> deletedEntities;
 
@@ -194,13 +409,93 @@ void GameState::updateEntities() const
     for (auto const& e : deletedEntities)
     {
         world->removeEntity(e);
-        e->onDelete();
+
+        if (scheduler.isRollbackEnabled())
+        {
+            // A rollback may need to bring this Entity back, so it is not deleted until it has left every snapshot
+            removedEntities[scheduler.getCurrentTick() % removedEntities.size()].push_back(e);
+        }
+        else
+        {
+            e->onDelete();
+        }
     }
 }
 
+/**
+ * Copies everything needed to render the World into the next RenderSnapshot.
+ */
+void GameState::publishRenderSnapshot()
+{
+    RenderSnapshot& snapshot = renderSnapshots.getWriteSnapshot();
+    snapshot.time = SDL_GetTicks();
+    snapshot.camera.emplace(camera);
+    snapshot.entities.clear();
+
+    // Snapshots are recycled, so this one may already hold the latest tiles
+    if (snapshot.tiles.empty() || snapshot.tilesVersion != world->getTilesVersion())
+    {
+        snapshot.tiles = world->getTiles();
+        snapshot.tilesVersion = world->getTilesVersion();
+    }
+
+    const auto entityUnderMouse = playerContext.weakEntityUnderMouse.lock();
+
+    auto const& entities = world->getMutableEntities();
+    for (auto const& e : entities)
+    {
+        // Entities without a SpriteComponent cannot be rendered
+        const SpriteComponent* spriteComponent = e->getComponent<SpriteComponent>(SpriteComponent::key);
+        if (!spriteComponent)
+        {
+            continue;
+        }
+
+        EntityRenderState& renderState = snapshot.entities.emplace_back();
+        renderState.pos = e->getPos();
+        renderState.spritesheet = &spriteComponent->getSpritesheet();
+        renderState.txIndex = spriteComponent->getTxIndex();
+
+        // Determine palette based on owner
+        renderState.paletteIndex = PaletteUtils::paletteIndexGame;
+        if (const auto owner = e->getComponent<OwnerComponent>(OwnerComponent::key))
+        {
+            renderState.paletteIndex += owner->getPlayerId();
+        }
+
+        if (const auto movementComponent = e->getComponent<MovementComponent>(MovementComponent::key))
+        {
+            renderState.movement = movementComponent->getMovement();
+        }
+
+        if (e == entityUnderMouse)
+        {
+            if (const auto mouseHandler = e->getComponent<MouseHandlerComponent>(MouseHandlerComponent::key))
+            {
+                renderState.underMouse = true;
+                renderState.hitbox = mouseHandler->getHitbox();
+            }
+        }
+    }
+
+    renderSnapshots.publish();
+}
+
 void GameState::render(int delta)
 {
-    gameRenderer.render(delta);
+    // The World is rendered from the latest snapshot, so this never has to wait for a tick to finish
+    const RenderSnapshot& snapshot = renderSnapshots.getLatest();
+    const int timeSinceSnapshot = static_cast<int>(SDL_GetTicks() - snapshot.time);
+    gameRenderer.renderWorld(snapshot, timeSinceSnapshot);
+
+    // The UI reads the live game state, so it cannot be rendered during a tick
+    std::scoped_lock lock(app.getStateMutex());
+    gameRenderer.renderInterface(delta, netOverlayLines);
+}
+
+bool GameState::supportsSimulationThread() const
+{
+    return true;
 }
 
 void GameState::keyDown(const SDL_Keycode keyCode)
@@ -223,6 +518,22 @@ void GameState::keyDown(const SDL_Keycode keyCode)
         input.lastDirectionX = Direction::Increasing;
         break;
 
+    case SDLK_F3:
+        if (isNetGame())
+        {
+            netOverlayVisible = !netOverlayVisible;
+            refreshNetOverlay();
+        }
+        break;
+
+    case SDLK_F5:
+        quickSave();
+        break;
+
+    case SDLK_F9:
+        quickLoad();
+        break;
+
     default:
         break;
     }
@@ -366,75 +677,251 @@ void GameState::dispatchCommand(std::shared_ptr<GameCommand> command)
         return;
     }
 
-    // In multiplayer, schedule commands for 'n' ticks in the future
-    int relevantTick = isNetGame() ? currentTick + TimeUtils::netCommandDelay : currentTick;
-    scheduleCommand(command, relevantTick);
+    if (isReplay())
+    {
+        // Only commands from the replay are allowed
+        return;
+    }
 
-    // Queue commands to be sent over the network
     if (isNetGame())
     {
+        // Queue commands to be sent over the network.
+        // These are scheduled when they are sent, since the command delay may change before then.
         outgoingCommands.push_back(command);
     }
+    else
+    {
+        scheduleCommand(command, scheduler.getCurrentTick());
+    }
+}
+
+void GameState::setCommandDelay(int newCommandDelay)
+{
+    if (newCommandDelay < LockstepScheduler::minCommandDelay || newCommandDelay > LockstepScheduler::maxCommandDelay)
+    {
+        throw std::runtime_error("Invalid command delay: " + std::to_string(newCommandDelay));
+    }
+
+    if (newCommandDelay == commandDelay)
+    {
+        return;
+    }
+
+    std::cout << "Command delay changed from " << commandDelay << " to " << newCommandDelay << " ticks at tick "
+              << scheduler.getCurrentTick() << "\n";
+    commandDelay = newCommandDelay;
+    ++lockstepMetrics.numDelayChanges;
+}
+
+void GameState::onPingReturned(std::uint32_t sendTime, std::uint32_t receiveTime)
+{
+    const std::uint32_t rttMs = receiveTime - sendTime;
+    latencyTracker.addRttSample(rttMs);
+    netTelemetry.addRttSample(rttMs);
+}
+
+void GameState::onLatencyReportReceived(int clientId, std::uint32_t rttMs, std::uint32_t jitterMs)
+{
+    latencyReports[clientId] = { rttMs, jitterMs };
+}
+
+int GameState::getCommandDelay() const
+{
+    // With rollback, local commands execute immediately and other clients roll back to apply them
+    return isNetGame() && !scheduler.isRollbackEnabled() ? commandDelay : 0;
 }
 
 void GameState::scheduleCommand(std::shared_ptr<GameCommand> command, int tick)
 {
-    auto findResult = pendingCommands.find(tick);
-    if (findResult == pendingCommands.end())
+    scheduler.scheduleCommand(command, tick);
+
+    if (tick < scheduler.getCurrentTick())
     {
-        // No commands are scheduled for this tick yet
-        pendingCommands.insert({ tick, { command } });
+        // We have already simulated this tick without this command
+        if (rollbackTick < 0 || tick < rollbackTick)
+        {
+            rollbackTick = tick;
+        }
     }
-    else
+}
+
+void GameState::onClientReady(int firstTick, int lastTick, int clientId)
+{
+    scheduler.onClientReady(firstTick, lastTick, clientId);
+}
+
+int GameState::resolveReceivedTick(int clientId, int tickDelta)
+{
+    return scheduler.resolveReceivedTick(clientId, tickDelta);
+}
+
+void GameState::startRecording(std::unique_ptr<ReplayWriter> writer)
+{
+    replayWriter = std::move(writer);
+}
+
+void GameState::startReplay(std::shared_ptr<const ReplayReader> replay, bool fastForward)
+{
+    replayReader = replay;
+    nextReplayTickIndex = 0;
+    fastForwardReplay = fastForward;
+    replayStartTime = SDL_GetTicks();
+    app.setFastForward(fastForward);
+}
+
+void GameState::enableRollback()
+{
+    scheduler.enableRollback();
+}
+
+void GameState::saveSnapshot()
+{
+    if (!scheduler.isRollbackEnabled())
     {
-        // Add our command to the commands already scheduled for this tick
-        std::vector<std::shared_ptr<GameCommand>>& commandsDue = findResult->second;
-        commandsDue.push_back(command);
+        return;
     }
+
+    // The snapshot we are about to replace is the last one that could contain Entities removed during its tick
+    const int currentTick = scheduler.getCurrentTick();
+    SharedMutableEntityList& expiredEntities = removedEntities[currentTick % removedEntities.size()];
+    for (auto const& e : expiredEntities)
+    {
+        e->onDelete();
+    }
+    expiredEntities.clear();
+
+    // Re-using the same buffers means this does not allocate once the game is underway
+    WorldSnapshot::save(*world, snapshots[currentTick % snapshots.size()]);
 }
 
-void GameState::onClientReady(int tick, int clientId)
+void GameState::rollBack()
 {
-    auto iter = clientsReady.find(tick);
-    if (iter == clientsReady.cend())
+    if (rollbackTick < 0)
     {
-        // This is the first player ready for this tick
-        std::unordered_set<int> clientsReadyForTick;
-        clientsReadyForTick.insert(clientId);
-        clientsReady.insert({ tick, clientsReadyForTick });
+        return;
     }
-    else
+
+    // Gather the Entities removed since the snapshot, any of which may need to be brought back
+    SharedMutableEntityList entitiesToRestore;
+    const int presentTick = scheduler.getCurrentTick();
+    for (int tick = rollbackTick; tick < presentTick; ++tick)
     {
-        // Add to the players already ready
-        std::unordered_set<int>& playersReadyForTick = iter->second;
-        auto result = playersReadyForTick.insert(clientId);
-        if (!result.second)
+        SharedMutableEntityList& entities = removedEntities[tick % removedEntities.size()];
+        entitiesToRestore.insert(entitiesToRestore.end(), entities.cbegin(), entities.cend());
+        entities.clear();
+    }
+
+    // Return to the start of the earliest tick that was simulated with missing commands
+    const std::vector<char>& snapshot = snapshots[rollbackTick % snapshots.size()];
+    WorldSnapshot::restore(*world, snapshot.data(), snapshot.size(), entitiesToRestore);
+
+    // Entities that were spawned and removed since the snapshot are gone for good.
+    // If they are spawned again during the re-simulation, it will be as new Entities.
+    for (auto const& e : entitiesToRestore)
+    {
+        if (world->getEntity(e->getId()) != e.get())
         {
-            // result is a pair <iter, bool> where bool is false if the element was already present in the set
-            throw std::runtime_error(
-                    "Duplicate player ready received for client " + std::to_string(clientId)
-                    + " for tick: " + std::to_string(tick));
+            e->onDelete();
         }
     }
+
+    // Re-simulate up to the present
+    scheduler.setCurrentTick(rollbackTick);
+    rollbackTick = -1;
+    while (scheduler.getCurrentTick() < presentTick)
+    {
+        simulateTick();
+        scheduler.advanceTick();
+    }
 }
 
-void GameState::processCommands()
+void GameState::confirmTicks()
+{
+    if (!scheduler.isRollbackEnabled())
+    {
+        return;
+    }
+
+    // We can only confirm ticks that we have simulated
+    while (firstUnconfirmedTick < scheduler.getCurrentTick() && scheduler.isTickConfirmed(firstUnconfirmedTick))
+    {
+        // No more commands can arrive for this tick, so it is now safe to record
+        if (replayWriter)
+        {
+            replayWriter->recordCommands(
+                    firstUnconfirmedTick, scheduler.getScheduledTick(firstUnconfirmedTick).commands);
+        }
+        ++firstUnconfirmedTick;
+    }
+}
+
+void GameState::scheduleReplayCommands()
 {
-    auto findResult = pendingCommands.find(currentTick);
-    if (findResult == pendingCommands.end())
+    if (!isReplay())
     {
-        // No commands due
         return;
     }
 
-    std::vector<std::shared_ptr<GameCommand>>& commandsDue = findResult->second;
-    for (auto& cmd : commandsDue)
+    const int currentTick = scheduler.getCurrentTick();
+    const std::vector<ReplayTick>& replayTicks = replayReader->getTicks();
+    while (nextReplayTickIndex < replayTicks.size() && replayTicks[nextReplayTickIndex].tick == currentTick)
+    {
+        for (const auto& command : replayTicks[nextReplayTickIndex].commands)
+        {
+            scheduleCommand(command, currentTick);
+        }
+        ++nextReplayTickIndex;
+    }
+}
+
+void GameState::processCommands()
+{
+    const int currentTick = scheduler.getCurrentTick();
+    ScheduledTick& scheduledTick = scheduler.getScheduledTick(currentTick);
+    for (auto& cmd : scheduledTick.commands)
     {
         cmd->execute(*this);
     }
 
-    pendingCommands.erase(currentTick);
-    clientsReady.erase(currentTick);
+    if (scheduler.isRollbackEnabled())
+    {
+        // Commands are kept until the tick leaves the rollback window, in case we need to re-simulate it
+        return;
+    }
+
+    if (replayWriter)
+    {
+        replayWriter->recordCommands(currentTick, scheduledTick.commands);
+    }
+
+    // Reset the slot so it can be reused for a future tick.
+    // Clearing the vector retains its capacity, and received commands go back to their pool, so this does not free
+    // any memory.
+    scheduledTick.commands.clear();
+    scheduledTick.clientsReady = 0;
+}
+
+void GameState::checkReplayFinished()
+{
+    const int currentTick = scheduler.getCurrentTick();
+    if (!isReplay() || currentTick <= replayReader->getFinalTick())
+    {
+        return;
+    }
+
+    Uint32 timeElapsed = SDL_GetTicks() - replayStartTime;
+    std::cout << "Replay finished after " << std::to_string(currentTick) << " ticks in "
+              << std::to_string(timeElapsed) << "ms\n";
+
+    if (fastForwardReplay)
+    {
+        // When fast-forwarding we are only interested in how long the replay took to run
+        app.setFastForward(false);
+        app.requestExit();
+    }
+
+    // Return control to the player
+    replayReader.reset();
 }
 
 bool GameState::isNetGame() const
@@ -442,6 +929,48 @@ bool GameState::isNetGame() const
     return app.getConnection().has_value();
 }
 
+bool GameState::canQuickSave() const
+{
+    // Loading a snapshot would desync a net game or a replay
+    return !isNetGame() && !isReplay();
+}
+
+void GameState::quickSave() const
+{
+    if (!canQuickSave())
+    {
+        return;
+    }
+
+    Uint32 startTime = SDL_GetTicks();
+    WorldSnapshot::saveToFile(*world, quickSaveFilename);
+    std::cout << "Saved game to " << quickSaveFilename << " in " << (SDL_GetTicks() - startTime) << "ms\n";
+}
+
+void GameState::quickLoad()
+{
+    if (!canQuickSave())
+    {
+        return;
+    }
+
+    try
+    {
+        Uint32 startTime = SDL_GetTicks();
+        WorldSnapshot::restoreFromFile(*world, quickSaveFilename);
+        std::cout << "Loaded game from " << quickSaveFilename << " in " << (SDL_GetTicks() - startTime) << "ms\n";
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "Failed to load game: " << e.what() << "\n";
+    }
+}
+
+bool GameState::isReplay() const
+{
+    return replayReader != nullptr;
+}
+
 int GameState::getNumPlayers() const
 {
     return static_cast<int>(playerStates.size());
@@ -0,0 +1,267 @@
+#include "pch.h"
+
+#include "GroupMoveCommand.h"
+
+#include <cstdint>
+#include <cstdlib>  // std::abs
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::move
+
+#include "utils/BufferUtils.h"
+#include "utils/ObjectPool.h"
+#include "MovementComponent.h"
+
+namespace Rival {
+
+/** Maximum number of tiles to search when looking for a free tile near the destination. */
+static constexpr std::size_t maxFreeTileSearch = 1024;
+
+static bool isInBounds(const MapBounds& area, const MapNode& node)
+{
+    return node.x >= 0 && node.x < area.getWidth() && node.y >= 0 && node.y < area.getHeight();
+}
+
+/**
+ * Finds the nearest tile to `center` that is pathable and not already claimed by another unit.
+ *
+ * Returns `center` if there is no such tile nearby.
+ */
+static MapNode findFreeTile(
+        const World& world,
+        const Pathfinding::PassabilityChecker& passabilityChecker,
+        const std::unordered_set<MapNode>& claimedTiles,
+        MapNode center)
+{
+    std::deque<MapNode> openTiles = { center };
+    std::unordered_set<MapNode> visitedTiles = { center };
+
+    while (!openTiles.empty() && visitedTiles.size() < maxFreeTileSearch)
+    {
+        const MapNode tile = openTiles.front();
+        openTiles.pop_front();
+
+        if (claimedTiles.find(tile) == claimedTiles.cend() && passabilityChecker.isNodePathable(world, tile))
+        {
+            return tile;
+        }
+
+        for (const MapNode& neighbor : MapUtils::findNeighbors(tile, world))
+        {
+            if (visitedTiles.insert(neighbor).second)
+            {
+                openTiles.push_back(neighbor);
+            }
+        }
+    }
+
+    return center;
+}
+
+GroupMoveCommand::GroupMoveCommand(std::vector<int> entityIds, MapNode destination)
+    : GameCommand(GameCommandType::GroupMove)
+    , entityIds(std::move(entityIds))
+    , destination(destination)
+{
+}
+
+void GroupMoveCommand::serialize(std::vector<char>& buffer) const
+{
+    GameCommand::serialize(buffer);
+
+    if (entityIds.empty() || entityIds.size() > maxGroupSize || destination.x < 0 || destination.x > UINT16_MAX
+        || destination.y < 0 || destination.y > UINT16_MAX)
+    {
+        throw std::runtime_error("Invalid group move command");
+    }
+
+    BufferUtils::addVarUintToBuffer(buffer, static_cast<std::uint32_t>(entityIds.size()));
+
+    // Units selected together were usually created together, so each entity ID is stored relative to the last
+    int previousEntityId = 0;
+    for (int entityId : entityIds)
+    {
+        if (entityId < 0)
+        {
+            throw std::runtime_error("Invalid group move command");
+        }
+        BufferUtils::addVarIntToBuffer(buffer, entityId - previousEntityId);
+        previousEntityId = entityId;
+    }
+
+    BufferUtils::addUint16ToBuffer(buffer, static_cast<std::uint16_t>(destination.x));
+    BufferUtils::addUint16ToBuffer(buffer, static_cast<std::uint16_t>(destination.y));
+}
+
+std::shared_ptr<GroupMoveCommand>
+GroupMoveCommand::deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    const std::uint32_t numEntities = BufferUtils::readVarUintFromBuffer(buffer, bufferSize, offset);
+    if (numEntities == 0 || numEntities > maxGroupSize)
+    {
+        throw std::runtime_error("Invalid group size: " + std::to_string(numEntities));
+    }
+
+    std::vector<int> entityIds;
+    entityIds.reserve(numEntities);
+    int previousEntityId = 0;
+    for (std::uint32_t i = 0; i < numEntities; ++i)
+    {
+        const int entityId = previousEntityId + BufferUtils::readVarIntFromBuffer(buffer, bufferSize, offset);
+        entityIds.push_back(entityId);
+        previousEntityId = entityId;
+    }
+
+    MapNode destination;
+    destination.x = BufferUtils::readUint16FromBuffer(buffer, bufferSize, offset);
+    destination.y = BufferUtils::readUint16FromBuffer(buffer, bufferSize, offset);
+
+    // Received commands only live until they are executed, so avoid hitting the heap every time
+    return std::allocate_shared<GroupMoveCommand>(
+            PoolAllocator<GroupMoveCommand>(), std::move(entityIds), destination);
+}
+
+void GroupMoveCommand::execute(GameCommandContext& context)
+{
+    World& world = context.getWorld();
+
+    // Find the units that can still be moved; the first of these leads the group
+    std::vector<MovementComponent*> moveComponents;
+    for (int entityId : entityIds)
+    {
+        Entity* entity = world.getMutableEntity(entityId);
+        if (!entity)
+        {
+            // Entity has been deleted since this command was issued
+            continue;
+        }
+
+        auto moveComponent = entity->getComponent<MovementComponent>(MovementComponent::key);
+        if (!moveComponent)
+        {
+            std::cerr << "Tried to move an immovable entity\n";
+            continue;
+        }
+
+        moveComponents.push_back(moveComponent);
+    }
+
+    if (moveComponents.empty())
+    {
+        return;
+    }
+
+    // The leader is the only unit that needs to find a path
+    MovementComponent& leader = *moveComponents.front();
+    const MapNode leaderStart = leader.getStartPosForNextMovement();
+    leader.moveTo(destination);
+    const Pathfinding::Route& leaderRoute = leader.getRoute();
+
+    // Tiles where units will end up
+    const MapNode leaderEnd = leaderRoute.isEmpty() ? leaderStart : leaderRoute.getPath().back();
+    std::unordered_set<MapNode> claimedTiles = { leaderEnd };
+
+    std::vector<MovementComponent*> stragglers;
+    for (std::size_t i = 1; i < moveComponents.size(); ++i)
+    {
+        if (!followLeader(world, *moveComponents[i], leaderStart, leaderRoute, claimedTiles))
+        {
+            stragglers.push_back(moveComponents[i]);
+        }
+    }
+
+    // Units that could not keep formation fill in the gaps around the destination
+    for (MovementComponent* straggler : stragglers)
+    {
+        const MapNode tile = findFreeTile(world, straggler->getPassabilityChecker(), claimedTiles, leaderEnd);
+        claimedTiles.insert(tile);
+        straggler->moveTo(tile);
+    }
+}
+
+/**
+ * Attempts to send a unit along a copy of the leader's route, shifted so that it starts next to the unit.
+ *
+ * Shifting a route east or west by an odd number of tiles would change which tiles are neighbors (see
+ * `MapUtils::findNeighbors`), so routes are only ever shifted by an even number of columns. Units in the other
+ * columns first take a single diagonal step to join the formation.
+ *
+ * Returns false if the unit cannot follow the leader.
+ */
+bool GroupMoveCommand::followLeader(
+        const World& world,
+        MovementComponent& follower,
+        MapNode leaderStart,
+        const Pathfinding::Route& leaderRoute,
+        std::unordered_set<MapNode>& claimedTiles) const
+{
+    if (leaderRoute.isEmpty())
+    {
+        return false;
+    }
+
+    const MapNode start = follower.getStartPosForNextMovement();
+    if (std::abs(start.x - leaderStart.x) > maxFormationSpread * MapUtils::eastWestTileSpan
+        || std::abs(start.y - leaderStart.y) > maxFormationSpread)
+    {
+        return false;
+    }
+
+    // Find the tiles from which this unit could join the formation, preferring those closer to the leader
+    std::vector<MapNode> joinTiles;
+    if ((start.x - leaderStart.x) % 2 == 0)
+    {
+        joinTiles.push_back(start);
+    }
+    else
+    {
+        const int towardsLeader = start.x > leaderStart.x ? -1 : 1;
+        joinTiles.push_back({ start.x + towardsLeader, start.y });
+        joinTiles.push_back({ start.x - towardsLeader, start.y });
+    }
+
+    const Pathfinding::PassabilityChecker& passabilityChecker = follower.getPassabilityChecker();
+    for (const MapNode& joinTile : joinTiles)
+    {
+        const MapNode offset = { joinTile.x - leaderStart.x, joinTile.y - leaderStart.y };
+        const MapNode& leaderEnd = leaderRoute.getPath().back();
+        const MapNode endTile = { leaderEnd.x + offset.x, leaderEnd.y + offset.y };
+        if (claimedTiles.find(endTile) != claimedTiles.cend())
+        {
+            continue;
+        }
+
+        std::deque<MapNode> path;
+        if (joinTile != start)
+        {
+            path.push_back(joinTile);
+        }
+        for (const MapNode& leaderNode : leaderRoute.getPath())
+        {
+            path.push_back({ leaderNode.x + offset.x, leaderNode.y + offset.y });
+        }
+
+        bool isPathable = true;
+        for (const MapNode& node : path)
+        {
+            if (!isInBounds(world, node) || !passabilityChecker.isNodePathable(world, node))
+            {
+                isPathable = false;
+                break;
+            }
+        }
+
+        if (isPathable)
+        {
+            claimedTiles.insert(endTile);
+            follower.setRoute(Pathfinding::Route(endTile, std::move(path)));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+}  // namespace Rival
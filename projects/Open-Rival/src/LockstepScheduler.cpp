@@ -0,0 +1,168 @@
+#include "pch.h"
+
+#include "LockstepScheduler.h"
+
+#include <algorithm>  // std::clamp, std::max
+#include <stdexcept>
+#include <string>
+
+namespace Rival {
+
+void LockstepScheduler::addClient(int clientId)
+{
+    if (clientId < 0 || clientId >= maxClients)
+    {
+        throw std::runtime_error("Invalid client ID: " + std::to_string(clientId));
+    }
+    allClientsMask |= (1u << clientId);
+}
+
+void LockstepScheduler::enableRollback()
+{
+    rollbackEnabled = true;
+    idleRangesEnabled = false;
+    nextSendTick = 0;
+}
+
+ScheduledTick& LockstepScheduler::getScheduledTick(int tick)
+{
+    static_assert(maxScheduledTicks > 2 * (maxCommandDelay + maxIdleRangeTicks), "Scheduled tick buffer is too small");
+
+    // With rollback, the buffer also holds the commands for past ticks that we may need to re-simulate. Other clients
+    // can be at most `maxRollbackTicks` ahead of us, and schedule commands for their current tick.
+    static_assert(maxScheduledTicks > 2 * maxRollbackTicks, "Scheduled tick buffer is too small for rollback");
+    const int firstTick = rollbackEnabled ? currentTick - maxRollbackTicks : currentTick;
+
+    if (tick < firstTick || tick >= firstTick + maxScheduledTicks)
+    {
+        throw std::runtime_error(
+                "Tick " + std::to_string(tick) + " is outside the scheduling window (current tick: "
+                + std::to_string(currentTick) + ")");
+    }
+
+    return scheduledTicks[tick % maxScheduledTicks];
+}
+
+bool LockstepScheduler::isTickConfirmed(int tick)
+{
+    // If we are the only player (unlikely for a net game, but technically possible) then the mask will be empty
+    return getScheduledTick(tick).clientsReady == allClientsMask;
+}
+
+std::uint32_t LockstepScheduler::getMissingClients(int tick)
+{
+    return allClientsMask & ~getScheduledTick(tick).clientsReady;
+}
+
+bool LockstepScheduler::isCurrentTickReady()
+{
+    if (currentTick < TimeUtils::netCommandDelay)
+    {
+        // No commands should be scheduled before the initial command delay
+        return true;
+    }
+
+    return isTickConfirmed(currentTick);
+}
+
+void LockstepScheduler::scheduleCommand(std::shared_ptr<GameCommand> command, int tick)
+{
+    getScheduledTick(tick).commands.push_back(command);
+}
+
+void LockstepScheduler::onClientReady(int firstTick, int lastTick, int clientId)
+{
+    if (clientId < 0 || clientId >= maxClients)
+    {
+        throw std::runtime_error("Invalid client ID: " + std::to_string(clientId));
+    }
+
+    // No commands are sent for the ticks before the initial command delay, so a client's first packet may appear to
+    // cover ticks that are already behind us
+    if (!rollbackEnabled)
+    {
+        firstTick = std::max(firstTick, TimeUtils::netCommandDelay);
+    }
+
+    const std::uint32_t clientBit = 1u << clientId;
+    for (int tick = firstTick; tick <= lastTick; ++tick)
+    {
+        ScheduledTick& scheduledTick = getScheduledTick(tick);
+        if (scheduledTick.clientsReady & clientBit)
+        {
+            throw std::runtime_error(
+                    "Duplicate player ready received for client " + std::to_string(clientId)
+                    + " for tick: " + std::to_string(tick));
+        }
+
+        scheduledTick.clientsReady |= clientBit;
+    }
+}
+
+int LockstepScheduler::resolveReceivedTick(int clientId, int tickDelta)
+{
+    auto iter = lastReceivedTicks.find(clientId);
+    const int previousTick = iter == lastReceivedTicks.end() ? GameCommandPacket::initialPreviousTick : iter->second;
+
+    const int tick = previousTick + tickDelta;
+    lastReceivedTicks[clientId] = tick;
+    return tick;
+}
+
+std::optional<SendTick> LockstepScheduler::takeSendTick(int commandDelay, bool hasCommands)
+{
+    const int targetTick = currentTick + commandDelay;
+    if (targetTick < nextSendTick)
+    {
+        // Either the command delay has decreased, or we have promised to be idle, and we have already sent our
+        // commands for this tick. Any new commands will have to wait until we catch up.
+        return {};
+    }
+
+    // A packet also tells other clients that we have no commands for any of the ticks since our previous packet. This
+    // covers the ticks in between if the command delay has increased.
+    SendTick sendTick;
+    sendTick.tick = targetTick;
+    sendTick.previousTick = lastSentTick;
+
+    if (!hasCommands)
+    {
+        // Rather than sending an empty packet every tick, promise to stay idle for a few ticks more. The longer we
+        // have been idle, the further ahead we promise, since we are less likely to be interrupted.
+        if (idleRangesEnabled)
+        {
+            sendTick.tick += std::clamp(numIdleTicks, 1, maxIdleRangeTicks) - 1;
+        }
+        numIdleTicks += sendTick.tick - lastSentTick;
+    }
+    else
+    {
+        numIdleTicks = 0;
+    }
+
+    lastSentTick = sendTick.tick;
+    nextSendTick = sendTick.tick + 1;
+    return sendTick;
+}
+
+void LockstepScheduler::clearExpiredTick()
+{
+    if (!rollbackEnabled)
+    {
+        return;
+    }
+
+    // Ticks that have fallen out of the rollback window can never be re-simulated.
+    // This slot is about to be re-used for the tick that has just entered the scheduling window.
+    const int expiredTick = currentTick - maxRollbackTicks - 1;
+    if (expiredTick < 0)
+    {
+        return;
+    }
+
+    ScheduledTick& scheduledTick = scheduledTicks[expiredTick % maxScheduledTicks];
+    scheduledTick.commands.clear();
+    scheduledTick.clientsReady = 0;
+}
+
+}  // namespace Rival
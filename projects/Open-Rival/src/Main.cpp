@@ -37,18 +37,26 @@ int main(int argc, char* argv[])
 
         // Host or join a game;
         // eventually this will be handled before we enter the LobbyState
-        if (options.isHost())
+        const Transport transport = options.isUdp() ? Transport::Udp : Transport::Tcp;
+        if (options.isClient())
+        {
+            // This may be a dedicated server, in which case we can still be the host of our own room
+            app.connectToServer(options.getHostAddress(), options.getPort(), options.getRoomId(), transport);
+        }
+        else if (options.isHost())
         {
             app.startServer(options.getPort());
         }
-        else if (options.isClient())
+
+        if (options.getPacketLossPercent() > 0)
         {
-            app.connectToServer(options.getHostAddress(), options.getPort());
+            app.getConnection()->setSimulatedPacketLoss(static_cast<float>(options.getPacketLossPercent()) / 100.f);
         }
 
         bool hostForLobby = options.isNetworked() ? options.isHost() : true;
         std::string playerName = hostForLobby ? "Host" : "Client";
-        std::unique_ptr<State> initialState = std::make_unique<LobbyState>(app, playerName, hostForLobby);
+        std::unique_ptr<State> initialState = std::make_unique<LobbyState>(
+                app, playerName, hostForLobby, options.getReplaySettings(), options.isRollbackEnabled());
         app.start(std::move(initialState));
     }
     catch (const std::exception& e)
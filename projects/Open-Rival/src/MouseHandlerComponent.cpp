@@ -8,9 +8,7 @@
 
 #include "Entity.h"
 #include "EntityRenderer.h"
-#include "MoveCommand.h"
 #include "OwnerComponent.h"
-#include "SpriteComponent.h"
 #include "UnitPropsComponent.h"
 #include "VoiceComponent.h"
 
@@ -32,7 +30,6 @@ void MouseHandlerComponent::onEntitySpawned(World*)
     }
 
     weakOwnerComponent = entity->getComponentWeak<OwnerComponent>(OwnerComponent::key);
-    weakSpriteComponent = entity->getComponentWeak<SpriteComponent>(SpriteComponent::key);
     weakVoiceComponent = entity->getComponentWeak<VoiceComponent>(VoiceComponent::key);
 }
 
@@ -44,6 +41,16 @@ void MouseHandlerComponent::onDelete()
     }
 }
 
+void MouseHandlerComponent::onStateRestored()
+{
+    dirty = true;
+
+    if (auto movementComponent = weakMovementComponent.lock())
+    {
+        moving = movementComponent->getMovement().isValid();
+    }
+}
+
 void MouseHandlerComponent::onUnitMoveStart(const MapNode*)
 {
     dirty = true;
@@ -103,34 +110,34 @@ void MouseHandlerComponent::onSelect(const PlayerStore& playerStore, bool isLead
     }
 }
 
-void MouseHandlerComponent::onTileClicked(
-        GameCommandInvoker& cmdInvoker, const PlayerStore& playerStore, const MapNode& tile, bool isLeader)
+bool MouseHandlerComponent::onTileClicked(const PlayerStore& playerStore, bool isLeader)
 {
     // TODO: Depends on state and entity type (e.g. move, harvest, cast spell)
-    // TODO: What about when a group is selected?
 
     // Check owner
     const auto ownerComponent = weakOwnerComponent.lock();
     if (!ownerComponent || !playerStore.isLocalPlayer(ownerComponent->getPlayerId()))
     {
         // Other players' units cannot be controlled
-        return;
+        return false;
     }
 
     // Move to tile
-    if (auto moveComponent = weakMovementComponent.lock())
+    if (weakMovementComponent.expired())
     {
-        if (isLeader)
+        return false;
+    }
+
+    if (isLeader)
+    {
+        // Leader should play a sound
+        if (const auto voiceComponent = weakVoiceComponent.lock())
         {
-            // Leader should play a sound
-            if (const auto voiceComponent = weakVoiceComponent.lock())
-            {
-                voiceComponent->playSound(UnitSoundType::Move);
-            }
+            voiceComponent->playSound(UnitSoundType::Move);
         }
-
-        cmdInvoker.dispatchCommand(std::make_shared<MoveCommand>(entity->getId(), tile));
     }
+
+    return true;
 }
 
 const Rect MouseHandlerComponent::createHitbox() const
@@ -182,15 +189,14 @@ const Rect MouseHandlerComponent::createHitbox() const
     // TMP: For now we use a fixed height for all entities
     float y1 = y2 - unitHitboxHeight;
 
-    // Add the last lerp offset that was used to render the entity
+    // Add the lerp offset as of the current tick.
+    // Rendering interpolates slightly further between ticks, but the renderer runs on another thread so we cannot
+    // share its offset.
     if (moving)
     {
-        if (auto spriteComponent = weakSpriteComponent.lock())
-        {
-            glm::vec2 lerpOffset = spriteComponent->lastLerpOffset;
-            x1 += lerpOffset.x;
-            y1 += lerpOffset.y;
-        }
+        glm::vec2 lerpOffset = EntityRenderer::getLerpOffset(*entity, 0);
+        x1 += lerpOffset.x;
+        y1 += lerpOffset.y;
     }
 
     return { x1, y1, unitHitboxWidth, unitHitboxHeight };
@@ -12,10 +12,12 @@
 #include "Camera.h"
 #include "Entity.h"
 #include "GameCommand.h"
+#include "GroupMoveCommand.h"
 #include "MapUtils.h"
 #include "MathUtils.h"
 #include "MouseHandlerComponent.h"
 #include "MouseUtils.h"
+#include "MoveCommand.h"
 #include "OwnerComponent.h"
 #include "PlayerContext.h"
 #include "PlayerState.h"
@@ -380,6 +382,7 @@ void MousePicker::selectEntities(WeakMutableEntityList& entities)
 void MousePicker::tileSelected()
 {
     bool isLeader = true;
+    std::vector<int> entityIdsToMove;
 
     for (const auto& weakSelectedEntity : playerContext.weakSelectedEntities)
     {
@@ -393,12 +396,34 @@ void MousePicker::tileSelected()
         if (const auto& mouseHandlerComponent =
                     selectedEntity->getComponent<MouseHandlerComponent>(MouseHandlerComponent::key))
         {
-            mouseHandlerComponent->onTileClicked(cmdInvoker, playerStore, playerContext.tileUnderMouse, isLeader);
+            if (mouseHandlerComponent->onTileClicked(playerStore, isLeader))
+            {
+                entityIdsToMove.push_back(selectedEntity->getId());
+            }
         }
 
         // TMP: For now, the first unit in the selection is the leader
         isLeader = false;
     }
+
+    moveEntities(entityIdsToMove, playerContext.tileUnderMouse);
+}
+
+void MousePicker::moveEntities(const std::vector<int>& entityIds, const MapNode& tile)
+{
+    if (entityIds.size() == 1)
+    {
+        cmdInvoker.dispatchCommand(std::make_shared<MoveCommand>(entityIds.front(), tile));
+        return;
+    }
+
+    // Move units as a group, so that only one of them has to find a path
+    for (std::size_t i = 0; i < entityIds.size(); i += GroupMoveCommand::maxGroupSize)
+    {
+        const std::size_t groupEnd = std::min(i + GroupMoveCommand::maxGroupSize, entityIds.size());
+        std::vector<int> groupEntityIds(entityIds.cbegin() + i, entityIds.cbegin() + groupEnd);
+        cmdInvoker.dispatchCommand(std::make_shared<GroupMoveCommand>(std::move(groupEntityIds), tile));
+    }
 }
 
 void MousePicker::deselect()
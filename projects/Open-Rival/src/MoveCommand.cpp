@@ -2,7 +2,12 @@
 
 #include "MoveCommand.h"
 
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
 #include "utils/BufferUtils.h"
+#include "utils/ObjectPool.h"
 #include "MapUtils.h"
 #include "MovementComponent.h"
 
@@ -19,19 +24,28 @@ void MoveCommand::serialize(std::vector<char>& buffer) const
 {
     GameCommand::serialize(buffer);
 
-    BufferUtils::addToBuffer(buffer, entityId);
-    BufferUtils::addToBuffer(buffer, destination);
+    if (entityId < 0 || destination.x < 0 || destination.x > UINT16_MAX || destination.y < 0
+        || destination.y > UINT16_MAX)
+    {
+        throw std::runtime_error("Invalid move command");
+    }
+
+    // Entity IDs are handed out incrementally so they are usually small, and tile co-ordinates always fit in 16 bits
+    BufferUtils::addVarUintToBuffer(buffer, static_cast<std::uint32_t>(entityId));
+    BufferUtils::addUint16ToBuffer(buffer, static_cast<std::uint16_t>(destination.x));
+    BufferUtils::addUint16ToBuffer(buffer, static_cast<std::uint16_t>(destination.y));
 }
 
-std::shared_ptr<MoveCommand> MoveCommand::deserialize(std::vector<char> buffer, size_t& offset)
+std::shared_ptr<MoveCommand> MoveCommand::deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset)
 {
-    int entityId;
-    BufferUtils::readFromBuffer(buffer, offset, entityId);
+    const auto entityId = static_cast<int>(BufferUtils::readVarUintFromBuffer(buffer, bufferSize, offset));
 
     MapNode destination;
-    BufferUtils::readFromBuffer(buffer, offset, destination);
+    destination.x = BufferUtils::readUint16FromBuffer(buffer, bufferSize, offset);
+    destination.y = BufferUtils::readUint16FromBuffer(buffer, bufferSize, offset);
 
-    return std::make_shared<MoveCommand>(entityId, destination);
+    // Received commands only live until they are executed, so avoid hitting the heap every time
+    return std::allocate_shared<MoveCommand>(PoolAllocator<MoveCommand>(), entityId, destination);
 }
 
 void MoveCommand::execute(GameCommandContext& context)
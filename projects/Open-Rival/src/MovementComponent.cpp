@@ -2,6 +2,10 @@
 
 #include "MovementComponent.h"
 
+#include <cstdint>
+#include <deque>
+
+#include "utils/BufferUtils.h"
 #include "Entity.h"
 #include "TimeUtils.h"
 #include "World.h"
@@ -56,6 +60,45 @@ void MovementComponent::update()
     entity->moved = true;
 }
 
+void MovementComponent::saveState(std::vector<char>& buffer) const
+{
+    const std::deque<MapNode>& path = route.getPath();
+    BufferUtils::reserveInBuffer(
+            buffer,
+            sizeof(movement) + sizeof(ticksPerMove) + sizeof(MapNode) + sizeof(std::uint32_t)
+                    + path.size() * sizeof(MapNode));
+
+    BufferUtils::addToBuffer(buffer, movement);
+    BufferUtils::addToBuffer(buffer, ticksPerMove);
+    BufferUtils::addToBuffer(buffer, route.getDestination());
+    BufferUtils::addToBuffer(buffer, static_cast<std::uint32_t>(path.size()));
+    for (const MapNode& node : path)
+    {
+        BufferUtils::addToBuffer(buffer, node);
+    }
+}
+
+void MovementComponent::restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, movement);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, ticksPerMove);
+
+    MapNode destination = { 0, 0 };
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, destination);
+
+    std::uint32_t pathLength = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, pathLength);
+    std::deque<MapNode> path;
+    for (std::uint32_t i = 0; i < pathLength; ++i)
+    {
+        MapNode node = { 0, 0 };
+        BufferUtils::readFromBuffer(buffer, bufferSize, offset, node);
+        path.push_back(node);
+    }
+
+    route = Pathfinding::Route(destination, path);
+}
+
 void MovementComponent::addListener(MovementListener* listener)
 {
     if (!listener)
@@ -63,6 +63,101 @@ const std::string ProgramOptions::parseArgs(int argc, char* argv[])
             }
         }
 
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // room
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        else if (arg == "-room")
+        {
+            try
+            {
+                roomId = parseInt(argc, argv, i + 1, 0, std::numeric_limits<int>::max());
+                ++i;  // Skip next argument
+            }
+            catch (const std::runtime_error& e)
+            {
+                return std::string(e.what()) + "\nExpected: -room [roomId]";
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // udp
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        else if (arg == "-udp")
+        {
+            udp = true;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // packetloss
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        else if (arg == "-packetloss")
+        {
+            try
+            {
+                packetLossPercent = parseInt(argc, argv, i + 1, 0, 100);
+                ++i;  // Skip next argument
+            }
+            catch (const std::runtime_error& e)
+            {
+                return std::string(e.what()) + "\nExpected: -packetloss [percent]";
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // record
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        else if (arg == "-record")
+        {
+            try
+            {
+                replaySettings.recordFilename = parseString(argc, argv, i + 1);
+                ++i;  // Skip next argument
+            }
+            catch (const std::runtime_error& e)
+            {
+                return std::string(e.what()) + "\nExpected: -record [filename]";
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // replay
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        else if (arg == "-replay")
+        {
+            try
+            {
+                replaySettings.playbackFilename = parseString(argc, argv, i + 1);
+                ++i;  // Skip next argument
+            }
+            catch (const std::runtime_error& e)
+            {
+                return std::string(e.what()) + "\nExpected: -replay [filename]";
+            }
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // fastforward
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        else if (arg == "-fastforward")
+        {
+            replaySettings.fastForward = true;
+        }
+
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // rollback
+        ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+        else if (arg == "-rollback")
+        {
+            rollback = true;
+        }
+
         else
         {
             return "Invalid argument: " + arg;
@@ -70,9 +165,42 @@ const std::string ProgramOptions::parseArgs(int argc, char* argv[])
     }
 
     // Final validation
-    if (host && !hostAddress.empty())
+    if (roomId != 0 && hostAddress.empty())
+    {
+        // When hosting without a dedicated server, we run our own server which only has a single room
+        return "room argument is only valid when connecting to a server";
+    }
+
+    if (udp && !isClient())
+    {
+        // When hosting, we always talk to our own server over a loopback link
+        return "udp argument is only valid when connecting to a server";
+    }
+
+    if (packetLossPercent > 0 && !udp)
+    {
+        return "packetloss argument is only valid when using udp";
+    }
+
+    if (replaySettings.isPlayback() && isNetworked())
+    {
+        return "replay argument not valid for a networked game";
+    }
+
+    if (replaySettings.isPlayback() && replaySettings.isRecording())
+    {
+        return "record argument not valid when watching a replay";
+    }
+
+    if (replaySettings.fastForward && !replaySettings.isPlayback())
+    {
+        return "fastforward argument is only valid when watching a replay";
+    }
+
+    if (rollback && !host)
     {
-        return "connect argument not valid when hosting";
+        // Clients use whichever setting the host chooses
+        return "rollback argument is only valid when hosting";
     }
 
     return {};
@@ -113,7 +241,7 @@ int ProgramOptions::parseInt(int argc, char* argv[], int index, int min, int max
 
 std::uint16_t ProgramOptions::parseUint16(int argc, char* argv[], int index) const
 {
-    return static_cast<std::uint16_t>(parseInt(argc, argv, index, 0, std::numeric_limits<std::uint8_t>::max()));
+    return static_cast<std::uint16_t>(parseInt(argc, argv, index, 0, std::numeric_limits<std::uint16_t>::max()));
 }
 
 std::string ProgramOptions::parseString(int argc, char* argv[], int index) const
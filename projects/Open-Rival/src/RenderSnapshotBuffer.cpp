@@ -0,0 +1,32 @@
+#include "pch.h"
+
+#include "RenderSnapshotBuffer.h"
+
+#include <utility>  // std::swap
+
+namespace Rival {
+
+RenderSnapshot& RenderSnapshotBuffer::getWriteSnapshot()
+{
+    return snapshots[writeIndex];
+}
+
+void RenderSnapshotBuffer::publish()
+{
+    std::scoped_lock lock(mutex);
+    std::swap(writeIndex, pendingIndex);
+    pendingIsNew = true;
+}
+
+const RenderSnapshot& RenderSnapshotBuffer::getLatest()
+{
+    std::scoped_lock lock(mutex);
+    if (pendingIsNew)
+    {
+        std::swap(readIndex, pendingIndex);
+        pendingIsNew = false;
+    }
+    return snapshots[readIndex];
+}
+
+}  // namespace Rival
@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <utility>  // std::move
 
 #include "FileUtils.h"
 
@@ -93,6 +94,11 @@ ScenarioReader::ScenarioReader(const std::string filename)
     }
 }
 
+ScenarioReader::ScenarioReader(std::vector<unsigned char> data)
+    : data(std::move(data))
+{
+}
+
 ScenarioData ScenarioReader::readScenario()
 {
     pos = 0;
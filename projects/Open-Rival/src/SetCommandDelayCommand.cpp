@@ -0,0 +1,36 @@
+#include "pch.h"
+
+#include "SetCommandDelayCommand.h"
+
+#include "utils/BufferUtils.h"
+#include "utils/ObjectPool.h"
+
+namespace Rival {
+
+SetCommandDelayCommand::SetCommandDelayCommand(int commandDelay)
+    : GameCommand(GameCommandType::SetCommandDelay)
+    , commandDelay(commandDelay)
+{
+}
+
+void SetCommandDelayCommand::serialize(std::vector<char>& buffer) const
+{
+    GameCommand::serialize(buffer);
+
+    BufferUtils::addVarIntToBuffer(buffer, commandDelay);
+}
+
+std::shared_ptr<SetCommandDelayCommand>
+SetCommandDelayCommand::deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    const int commandDelay = BufferUtils::readVarIntFromBuffer(buffer, bufferSize, offset);
+
+    return std::allocate_shared<SetCommandDelayCommand>(PoolAllocator<SetCommandDelayCommand>(), commandDelay);
+}
+
+void SetCommandDelayCommand::execute(GameCommandContext& context)
+{
+    context.setCommandDelay(commandDelay);
+}
+
+}  // namespace Rival
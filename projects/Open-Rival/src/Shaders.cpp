@@ -79,6 +79,60 @@ bool IndexedTextureShader::isValid() const
             && validateUniform(transparentIndex, "transparent_index");
 }
 
+///////////////////////////////////////////////////////////////////////////
+// TilemapShader
+///////////////////////////////////////////////////////////////////////////
+
+TilemapShader tilemapShader;
+
+void TilemapShader::init()
+{
+
+    GLuint programId = createShader("res\\shaders\\tilemap.vert", "res\\shaders\\tilemap.frag");
+
+    tilemapShader = TilemapShader();
+    tilemapShader.programId = programId;
+    tilemapShader.vertexAttribLoc = glGetAttribLocation(programId, "in_vertex");
+    tilemapShader.viewProjMatrixUniformLoc = glGetUniformLocation(programId, "view_proj_matrix");
+    tilemapShader.texUnitUniformLoc = glGetUniformLocation(programId, "tex");
+    tilemapShader.spritesheetColumnsUniformLoc = glGetUniformLocation(programId, "spritesheet_columns");
+    tilemapShader.spriteSizeUniformLoc = glGetUniformLocation(programId, "sprite_size");
+    tilemapShader.spritePaddingUniformLoc = glGetUniformLocation(programId, "sprite_padding");
+    tilemapShader.paletteTexUnitUniformLoc = glGetUniformLocation(programId, "palette");
+    tilemapShader.paletteTxYUnitUniformLoc = glGetUniformLocation(programId, "palette_txy");
+    tilemapShader.tileIndicesTexUnitUniformLoc = glGetUniformLocation(programId, "tile_indices");
+    tilemapShader.columnWidthUniformLoc = glGetUniformLocation(programId, "column_width");
+    tilemapShader.rowHeightUniformLoc = glGetUniformLocation(programId, "row_height");
+
+    if (!tilemapShader.isValid())
+    {
+        throw std::runtime_error("Failed to create TilemapShader");
+    }
+}
+
+bool TilemapShader::isValid() const
+{
+    // Validate program ID
+    if (programId == 0)
+    {
+        printf("Could not generate program ID\n");
+        return false;
+    }
+
+    // Validate vertex attributes / uniforms
+    return validateVertexAttribute(vertexAttribLoc, "in_vertex")                     //
+            && validateUniform(viewProjMatrixUniformLoc, "view_proj_matrix")         //
+            && validateUniform(texUnitUniformLoc, "tex")                             //
+            && validateUniform(spritesheetColumnsUniformLoc, "spritesheet_columns")  //
+            && validateUniform(spriteSizeUniformLoc, "sprite_size")                  //
+            && validateUniform(spritePaddingUniformLoc, "sprite_padding")            //
+            && validateUniform(paletteTexUnitUniformLoc, "palette")                  //
+            && validateUniform(paletteTxYUnitUniformLoc, "palette_txy")              //
+            && validateUniform(tileIndicesTexUnitUniformLoc, "tile_indices")         //
+            && validateUniform(columnWidthUniformLoc, "column_width")                //
+            && validateUniform(rowHeightUniformLoc, "row_height");
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // FontShader
 ///////////////////////////////////////////////////////////////////////////
@@ -168,6 +222,7 @@ bool TextureShader::isValid() const
 void initializeShaders()
 {
     IndexedTextureShader::init();
+    TilemapShader::init();
     FontShader::init();
     TextureShader::init();
 }
@@ -10,7 +10,7 @@ const std::string SpriteComponent::key = "sprite";
 
 SpriteComponent::SpriteComponent(const Spritesheet& spritesheet)
     : EntityComponent(key)
-    , renderable(spritesheet, 1)
+    , spritesheet(spritesheet)
 {
 }
 
@@ -22,12 +22,11 @@ int SpriteComponent::getTxIndex() const
 void SpriteComponent::setTxIndex(int newTxIndex)
 {
     txIndex = newTxIndex;
-    dirty = true;
 }
 
-const SpriteRenderable& SpriteComponent::getRenderable() const
+const Spritesheet& SpriteComponent::getSpritesheet() const
 {
-    return renderable;
+    return spritesheet;
 }
 
 }  // namespace Rival
@@ -42,4 +42,24 @@ const std::vector<GLfloat> Spritesheet::getTexCoords(int index) const
     };
 }
 
+int Spritesheet::getWidth() const
+{
+    return width;
+}
+
+int Spritesheet::getHeight() const
+{
+    return height;
+}
+
+int Spritesheet::getPadding() const
+{
+    return padding;
+}
+
+int Spritesheet::getColumns() const
+{
+    return xSize;
+}
+
 }  // namespace Rival
@@ -2,163 +2,196 @@
 
 #include "TileRenderer.h"
 
-#include <glm/mat4x4.hpp>
-#include <glm/vec3.hpp>
-#pragma warning(push)
-#pragma warning(disable : 4127)
-#include <glm/gtc/matrix_transform.hpp>
-#pragma warning(pop)
-#include <algorithm>
-#include <map>
-
-#include "Camera.h"
-#include "MathUtils.h"
-#include "Palette.h"
+#include <stdexcept>
+
+#include "GLUtils.h"
+#include "PaletteUtils.h"
 #include "Shaders.h"
 #include "Spritesheet.h"
-#include "Texture.h"
 
 namespace Rival {
 
-TileRenderer::TileRenderer(const Spritesheet& spritesheet, std::shared_ptr<const Texture> paletteTexture)
-    : paletteTexture(paletteTexture)
-    , renderable { spritesheet, maxTilesToRender }
+TileRenderer::TileRenderer(
+        const Spritesheet& spritesheet,
+        std::shared_ptr<const Texture> paletteTexture,
+        const std::vector<Tile>& tiles,
+        std::uint32_t tilesVersion,
+        int mapWidth,
+        int mapHeight)
+    : mapWidth(mapWidth)
+    , mapHeight(mapHeight)
+    , paletteTexture(paletteTexture)
+    , renderable { spritesheet, 1 }
+    , uploadedTxIndices(getTxIndices(tiles))
+    , uploadedTilesVersion(tilesVersion)
+    , tileIndicesTexture(createTileIndicesTexture(uploadedTxIndices, mapWidth, mapHeight))
 {
+    // Define a quad covering every tile in the map.
+    // Odd columns are offset downwards, so they reach furthest down.
+    const float x1 = 0.f;
+    const float y1 = 0.f;
+    const float x2 = static_cast<float>(RenderUtils::tileToPx_X(mapWidth - 1) + spritesheet.getWidth());
+    const float y2 = static_cast<float>(RenderUtils::tileToPx_Y(1, mapHeight - 1) + spritesheet.getHeight());
+    const float z = RenderUtils::zTiles;
+    const std::vector<GLfloat> positions = {
+        x1, y1, z,  //
+        x2, y1, z,  //
+        x2, y2, z,  //
+        x1, y2, z   //
+    };
+
+    // The quad never changes, so we set the buffer here and never touch it again
+    glBindVertexArray(renderable.getVao());
+    glBindBuffer(GL_ARRAY_BUFFER, renderable.getPositionVbo());
+    glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(GLfloat), positions.data());
 }
 
 /**
- * Renders all tiles visible to the camera.
+ * Renders the tiles.
  *
- * Note that while this is very slow in Debug mode, performance is not an
- * issue in Release mode.
+ * The view-projection matrix determines which part of the map is visible. This expects the TilemapShader to be in
+ * use.
  */
-void TileRenderer::render(const Camera& camera, const std::vector<Tile>& tiles, int mapWidth, int mapHeight) const
+void TileRenderer::render(const std::vector<Tile>& tiles, std::uint32_t tilesVersion) const
 {
+    // Update the data on the GPU
+    if (tilesVersion != uploadedTilesVersion)
+    {
+        sendChangedRowsToGpu(tiles);
+        uploadedTilesVersion = tilesVersion;
+    }
+
     // Use textures
-    glActiveTexture(GL_TEXTURE0 + 0);  // Texture unit 0
-    glBindTexture(GL_TEXTURE_2D, renderable.getTextureId());
+    glActiveTexture(GL_TEXTURE0 + tileIndicesTexUnit);
+    glBindTexture(GL_TEXTURE_2D, tileIndicesTexture.getId());
     glActiveTexture(GL_TEXTURE0 + 1);  // Texture unit 1
     glBindTexture(GL_TEXTURE_2D, paletteTexture->getId());
+    glActiveTexture(GL_TEXTURE0 + 0);  // Texture unit 0
+    glBindTexture(GL_TEXTURE_2D, renderable.getTextureId());
+
+    // Describe the layout of the spritesheet
+    const Spritesheet& spritesheet = renderable.spritesheet;
+    glUniform1i(Shaders::tilemapShader.spritesheetColumnsUniformLoc, spritesheet.getColumns());
+    glUniform2i(Shaders::tilemapShader.spriteSizeUniformLoc, spritesheet.getWidth(), spritesheet.getHeight());
+    glUniform1i(Shaders::tilemapShader.spritePaddingUniformLoc, spritesheet.getPadding());
+
+    // Describe the layout of the map
+    glUniform1i(Shaders::tilemapShader.columnWidthUniformLoc, RenderUtils::tileWidthPx / 2);
+    glUniform1i(Shaders::tilemapShader.rowHeightUniformLoc, RenderUtils::tileHeightPx);
+    glUniform1f(
+            Shaders::tilemapShader.paletteTxYUnitUniformLoc,
+            PaletteUtils::getPaletteTxY(PaletteUtils::paletteIndexGame));
 
     // Bind vertex array
     glBindVertexArray(renderable.getVao());
 
-    // Update the data on the GPU
-    if (needsUpdate())
-    {
-        sendDataToGpu(camera, tiles, mapWidth, mapHeight);
-    }
-
     // Render
-    glDrawElements(renderable.getDrawMode(), tiles.size() * renderable.getIndicesPerSprite(), GL_UNSIGNED_INT, nullptr);
+    glDrawElements(renderable.getDrawMode(), renderable.getIndicesPerSprite(), GL_UNSIGNED_INT, nullptr);
 }
 
-bool TileRenderer::needsUpdate() const
+Texture
+TileRenderer::createTileIndicesTexture(const std::vector<std::uint8_t>& txIndices, int mapWidth, int mapHeight)
 {
-    // Currently we update the buffers every frame.
-    // Later, we could optimise this by updating only when:
-    //   1) Camera has moved
-    //   2) Zoom level has changed
-    //   3) A tile has changed
-    return true;
+    // Disable byte-alignment restriction as we only need 1 byte per tile
+    GLUtils::PixelStore byteAlignment(GLUtils::PackAlignment::BYTES_1);
+
+    // Generate texture.
+    // This is an integer texture, so that the shader can read the texture indices directly.
+    GLuint textureId = 0;
+    glGenTextures(1, &textureId);
+    glActiveTexture(GL_TEXTURE0 + tileIndicesTexUnit);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexImage2D(
+            GL_TEXTURE_2D,
+            0,        // target slot
+            GL_R8UI,  // 1 byte per tile
+            mapWidth,
+            mapHeight,
+            0,  // always zero!
+            GL_RED_INTEGER,
+            GL_UNSIGNED_BYTE,
+            txIndices.data());
+
+    // Integer textures cannot be filtered
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Revert the state back to normal
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Check for error
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR)
+    {
+        printf("Error creating tile texture: %s\n", gluErrorString(error));
+        throw std::runtime_error("Failed to create tile texture");
+    }
+
+    return Texture(textureId, mapWidth, mapHeight);
 }
 
-void TileRenderer::sendDataToGpu(
-        const Camera& camera, const std::vector<Tile>& tiles, int mapWidth, int mapHeight) const
+std::vector<std::uint8_t> TileRenderer::getTxIndices(const std::vector<Tile>& tiles)
 {
-    // Find the first visible tiles.
-    // We subtract 1 because we need to start drawing offscreen, to account
-    // for tiles that are partially visible to the camera.
-    int minX = static_cast<int>(camera.getLeft()) - 1;
-    int minY = static_cast<int>(camera.getTop()) - 1;
-
-    // Keep within bounds
-    if (minX < 0)
-    {
-        minX = 0;
-    }
-    if (minY < 0)
+    std::vector<std::uint8_t> txIndices;
+    txIndices.reserve(tiles.size());
+    for (const Tile& tile : tiles)
     {
-        minY = 0;
+        txIndices.push_back(tile.txIndex);
     }
+    return txIndices;
+}
 
-    // Determine the number of tiles to draw.
-    // We add 3 to account for partially visible tiles either side of the
-    // screen, and because we started drawing offscreen.
-    int numTilesX = static_cast<int>(ceil(camera.getWidth())) + 3;
-    int numTilesY = static_cast<int>(ceil(camera.getHeight())) + 3;
-
-    // Find the last visible tiles
-    int maxX = minX + numTilesX;
-    int maxY = minY + numTilesY;
-
-    // Keep within the map bounds
-    maxX = std::min(maxX, mapWidth - 1);
-    maxY = std::min(maxY, mapHeight - 1);
-
-    // Keep within the rendering limits
-    maxX = std::min(maxX, RenderUtils::maxTilesX);
-    maxY = std::min(maxY, RenderUtils::maxTilesY);
-
-    // Create buffers to hold all our tile data
-    int numVertices = tiles.size() * SpriteRenderable::numVerticesPerSprite;
-    int positionDataSize = numVertices * SpriteRenderable::numVertexDimensions;
-    int texCoordDataSize = numVertices * SpriteRenderable::numTexCoordDimensions;
-    std::vector<GLfloat> positions;
-    std::vector<GLfloat> texCoords;
-    positions.reserve(positionDataSize);
-    texCoords.reserve(texCoordDataSize);
-
-    // Add data to buffers
-    for (int tileY = minY; tileY <= maxY; ++tileY)
-    {
-
-        // Calculate the index of the first tile in this row
-        int tileIndex = tileY * mapWidth + minX;
+/**
+ * Uploads any rows containing tiles that have changed.
+ *
+ * Rows are stored next to each other in the texture, so all rows between the first and last changed rows are
+ * uploaded together.
+ */
+void TileRenderer::sendChangedRowsToGpu(const std::vector<Tile>& tiles) const
+{
+    int firstChangedRow = -1;
+    int lastChangedRow = -1;
 
-        for (int tileX = minX; tileX <= maxX; ++tileX)
+    for (int tileY = 0; tileY < mapHeight; ++tileY)
+    {
+        for (int tileX = 0; tileX < mapWidth; ++tileX)
         {
-
-            auto const& tile = tiles[tileIndex];
-            const int txIndex = tile.txIndex;
-
-            // Define vertex positions
-            //    0------1
-            //    | \    |
-            //    |   \..|
-            //    3----- 2
-            float width = static_cast<float>(RenderUtils::tileSpriteWidthPx);
-            float height = static_cast<float>(RenderUtils::tileSpriteHeightPx);
-            float x1 = static_cast<float>(RenderUtils::tileToPx_X(tileX));
-            float y1 = static_cast<float>(RenderUtils::tileToPx_Y(tileX, tileY));
-            float x2 = x1 + width;
-            float y2 = y1 + height;
-            float z = RenderUtils::zTiles;
-            std::vector<GLfloat> thisVertexData = {
-                x1, y1, z,  //
-                x2, y1, z,  //
-                x2, y2, z,  //
-                x1, y2, z   //
-            };
-
-            // Determine texture co-ordinates
-            std::vector<GLfloat> thisTexCoords = renderable.spritesheet.getTexCoords(txIndex);
-
-            // Copy this tile's data to the main buffers
-            positions.insert(positions.cend(), thisVertexData.cbegin(), thisVertexData.cend());
-            texCoords.insert(texCoords.cend(), thisTexCoords.cbegin(), thisTexCoords.cend());
-
-            ++tileIndex;
+            const int tileIndex = tileY * mapWidth + tileX;
+            if (tiles[tileIndex].txIndex != uploadedTxIndices[tileIndex])
+            {
+                uploadedTxIndices[tileIndex] = tiles[tileIndex].txIndex;
+                if (firstChangedRow < 0)
+                {
+                    firstChangedRow = tileY;
+                }
+                lastChangedRow = tileY;
+            }
         }
     }
 
-    // Upload position data
-    glBindBuffer(GL_ARRAY_BUFFER, renderable.getPositionVbo());
-    glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(GLfloat), positions.data());
+    if (firstChangedRow < 0)
+    {
+        // Nothing has changed
+        return;
+    }
 
-    // Upload tex co-ord data
-    glBindBuffer(GL_ARRAY_BUFFER, renderable.getTexCoordVbo());
-    glBufferSubData(GL_ARRAY_BUFFER, 0, texCoords.size() * sizeof(GLfloat), texCoords.data());
+    GLUtils::PixelStore byteAlignment(GLUtils::PackAlignment::BYTES_1);
+
+    glActiveTexture(GL_TEXTURE0 + tileIndicesTexUnit);
+    glBindTexture(GL_TEXTURE_2D, tileIndicesTexture.getId());
+    glTexSubImage2D(
+            GL_TEXTURE_2D,
+            0,  // target slot
+            0,
+            firstChangedRow,
+            mapWidth,
+            lastChangedRow - firstChangedRow + 1,
+            GL_RED_INTEGER,
+            GL_UNSIGNED_BYTE,
+            uploadedTxIndices.data() + firstChangedRow * mapWidth);
 }
 
 }  // namespace Rival
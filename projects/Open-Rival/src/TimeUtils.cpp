@@ -2,20 +2,27 @@
 
 #include "TimeUtils.h"
 
+#include <chrono>
 #include <thread>
 
 namespace Rival { namespace TimeUtils {
 
 /** Maximum time that we are happy to spend spinning, in milliseconds. */
-static constexpr Uint32 maxSpinTime = 3;
+static constexpr int maxSpinTime = 3;
 
 /** Maximum time that we are happy to spend yielding, in milliseconds. */
-static constexpr Uint32 maxYieldTime = 10;
+static constexpr int maxYieldTime = 10;
 
-void PrecisionTimer::wait(Uint32 waitTimeMs)
+std::uint32_t getNetTimestamp()
 {
-    Uint32 startTime = SDL_GetTicks();
-    Uint32 timeElapsed = 0;
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
+void PrecisionTimer::wait(std::uint32_t waitTimeMs)
+{
+    std::uint32_t startTime = getNetTimestamp();
+    std::uint32_t timeElapsed = 0;
     int timeRemaining = static_cast<int>(waitTimeMs);
 
     while (timeRemaining > 0)
@@ -43,9 +50,9 @@ void PrecisionTimer::wait(Uint32 waitTimeMs)
             sleep(1);
         }
 
-        Uint32 nowTime = SDL_GetTicks();
+        std::uint32_t nowTime = getNetTimestamp();
         timeElapsed = nowTime - startTime;
-        timeRemaining = waitTimeMs - timeElapsed;
+        timeRemaining = static_cast<int>(waitTimeMs) - static_cast<int>(timeElapsed);
     }
 }
 
@@ -4,6 +4,8 @@
 
 #include <gl/glew.h>
 
+#include <algorithm>  // std::min
+
 #include "InventoryComponent.h"
 #include "PlayerContext.h"
 #include "PlayerState.h"
@@ -53,11 +55,19 @@ UiRenderer::UiRenderer(
     , nameProperties({ &fontStore.getFontSmall() })
     , nameRenderable(
               Unit::maxNameLength, nameProperties, GameInterface::selectionName.x, GameInterface::selectionName.y)
+    , overlayProperties({ &fontStore.getFontRegular() })
     , textRenderer(window)
 
     // Cursor
     , cursorRenderer(textureStore, window)
 {
+    overlayText.resize(maxOverlayLines);
+    overlayRenderables.reserve(maxOverlayLines);
+    for (int i = 0; i < maxOverlayLines; ++i)
+    {
+        overlayRenderables.emplace_back(
+                maxOverlayLineLength, overlayProperties, overlayX, overlayY + static_cast<float>(i) * overlayRowHeight);
+    }
 }
 
 void UiRenderer::renderUi()
@@ -270,7 +280,7 @@ bool UiRenderer::isPortraitVisible(int& outPortraitId) const
 // Text
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void UiRenderer::renderText()
+void UiRenderer::renderText(const std::vector<std::string>& overlayLines)
 {
     std::vector<const TextRenderable*> textRenderables;
 
@@ -281,6 +291,19 @@ void UiRenderer::renderText()
         textRenderables.push_back(&nameRenderable);
     }
 
+    const std::size_t numOverlayLines = std::min(overlayLines.size(), overlayRenderables.size());
+    for (std::size_t i = 0; i < numOverlayLines; ++i)
+    {
+        // Only update the text when it changes, so that it is not re-uploaded every frame
+        if (overlayText[i] != overlayLines[i])
+        {
+            overlayText[i] = overlayLines[i];
+            overlayRenderables[i].setTextSpan(
+                    { overlayLines[i].substr(0, maxOverlayLineLength), TextRenderable::defaultColor });
+        }
+        textRenderables.push_back(&overlayRenderables[i]);
+    }
+
     textRenderer.render(textRenderables);
 }
 
@@ -4,6 +4,7 @@
 
 #include <stdexcept>
 
+#include "utils/BufferUtils.h"
 #include "Animations.h"
 #include "Entity.h"
 #include "Resources.h"
@@ -76,6 +77,34 @@ void UnitAnimationComponent::update()
     }
 }
 
+void UnitAnimationComponent::saveState(std::vector<char>& buffer) const
+{
+    BufferUtils::reserveInBuffer(buffer, sizeof(currentAnimFrame) + sizeof(msPassedCurrentAnimFrame));
+    BufferUtils::addToBuffer(buffer, currentAnimFrame);
+    BufferUtils::addToBuffer(buffer, msPassedCurrentAnimFrame);
+}
+
+void UnitAnimationComponent::restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, currentAnimFrame);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, msPassedCurrentAnimFrame);
+}
+
+void UnitAnimationComponent::onStateRestored()
+{
+    const int restoredAnimFrame = currentAnimFrame;
+    const int restoredMsPassed = msPassedCurrentAnimFrame;
+
+    // The animation itself is not saved since it can be derived from the unit's state
+    if (auto unitPropsComponent = weakUnitPropsComponent.lock())
+    {
+        onUnitStateChanged(unitPropsComponent->getState());
+    }
+
+    msPassedCurrentAnimFrame = restoredMsPassed;
+    setCurrentAnimFrame(restoredAnimFrame);
+}
+
 void UnitAnimationComponent::onUnitStateChanged(const UnitState newState)
 {
     auto unitPropsComponent = weakUnitPropsComponent.lock();
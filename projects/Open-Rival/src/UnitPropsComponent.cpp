@@ -2,6 +2,7 @@
 
 #include "UnitPropsComponent.h"
 
+#include "utils/BufferUtils.h"
 #include "Entity.h"
 #include "MapUtils.h"
 
@@ -34,6 +35,18 @@ void UnitPropsComponent::onDelete()
     }
 }
 
+void UnitPropsComponent::saveState(std::vector<char>& buffer) const
+{
+    BufferUtils::reserveInBuffer(buffer, sizeof(state));
+    BufferUtils::addToBuffer(buffer, state);
+}
+
+void UnitPropsComponent::restoreState(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    // Listeners are not notified here; they are responsible for refreshing themselves once restored
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, state);
+}
+
 void UnitPropsComponent::onUnitMoveStart(const MapNode*)
 {
     setState(UnitState::Moving);
@@ -0,0 +1,236 @@
+#include "pch.h"
+
+#include "WorldSnapshot.h"
+
+#include <cstring>  // std::memcmp, std::memcpy
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_set>
+
+#include "utils/BufferUtils.h"
+#include "utils/MappedFile.h"
+#include "Entity.h"
+#include "Tile.h"
+#include "World.h"
+
+namespace Rival {
+
+// Tiles and passability are copied directly to / from memory
+static_assert(std::is_trivially_copyable<Tile>::value, "Tile must be trivially copyable");
+static_assert(std::is_trivially_copyable<TilePassability>::value, "TilePassability must be trivially copyable");
+
+/** Rough estimate of the space required by each Entity, used to avoid reallocations while saving. */
+static constexpr std::size_t estimatedEntitySize = 128;
+
+/** Finds the Entity with the given ID in a list, returning an empty pointer if it is not present. */
+static std::shared_ptr<Entity> findEntity(const SharedMutableEntityList& entities, int id)
+{
+    for (const auto& entity : entities)
+    {
+        if (entity->getId() == id)
+        {
+            return entity;
+        }
+    }
+    return {};
+}
+
+void WorldSnapshot::save(const World& world, std::vector<char>& buffer)
+{
+    if (!world.pendingEntities.empty())
+    {
+        throw std::runtime_error("Cannot take a snapshot while entities are pending");
+    }
+
+    const std::size_t tilesSize = world.tiles.size() * sizeof(Tile);
+    const std::size_t passabilitySize = world.tilePassability.size() * sizeof(TilePassability);
+
+    buffer.clear();
+    BufferUtils::reserveInBuffer(
+            buffer,
+            sizeof(magic) + sizeof(version) + sizeof(world.width) + sizeof(world.height) + sizeof(std::uint8_t)
+                    + sizeof(world.nextId) + sizeof(std::uint32_t) + tilesSize + passabilitySize
+                    + world.entities.size() * estimatedEntitySize);
+
+    // Header
+    BufferUtils::addToBuffer(buffer, magic);
+    BufferUtils::addToBuffer(buffer, version);
+    BufferUtils::addToBuffer(buffer, world.width);
+    BufferUtils::addToBuffer(buffer, world.height);
+    BufferUtils::addToBuffer(buffer, static_cast<std::uint8_t>(world.wilderness));
+    BufferUtils::addToBuffer(buffer, world.nextId);
+    BufferUtils::addToBuffer(buffer, static_cast<std::uint32_t>(world.entities.size()));
+
+    // Map data
+    std::size_t offset = buffer.size();
+    buffer.resize(offset + tilesSize + passabilitySize);
+    std::memcpy(buffer.data() + offset, world.tiles.data(), tilesSize);
+    offset += tilesSize;
+    std::memcpy(buffer.data() + offset, world.tilePassability.data(), passabilitySize);
+
+    // Entities
+    for (const auto& kv : world.entities)
+    {
+        BufferUtils::reserveInBuffer(buffer, sizeof(kv.first));
+        BufferUtils::addToBuffer(buffer, kv.first);
+        kv.second->saveState(buffer);
+    }
+}
+
+void WorldSnapshot::restore(
+        World& world, const char* data, std::size_t size, const SharedMutableEntityList& removedEntities)
+{
+    std::size_t offset = 0;
+
+    // Header
+    char snapshotMagic[sizeof(magic)];
+    BufferUtils::readFromBuffer(data, size, offset, snapshotMagic);
+    if (std::memcmp(snapshotMagic, magic, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("Not a snapshot");
+    }
+
+    std::uint32_t snapshotVersion = 0;
+    BufferUtils::readFromBuffer(data, size, offset, snapshotVersion);
+    if (snapshotVersion != version)
+    {
+        throw std::runtime_error("Unsupported snapshot version: " + std::to_string(snapshotVersion));
+    }
+
+    int width = 0;
+    int height = 0;
+    BufferUtils::readFromBuffer(data, size, offset, width);
+    BufferUtils::readFromBuffer(data, size, offset, height);
+    if (width != world.width || height != world.height)
+    {
+        throw std::runtime_error("Snapshot does not match world size");
+    }
+
+    std::uint8_t wilderness = 0;
+    BufferUtils::readFromBuffer(data, size, offset, wilderness);
+
+    int nextId = 0;
+    BufferUtils::readFromBuffer(data, size, offset, nextId);
+
+    std::uint32_t numEntities = 0;
+    BufferUtils::readFromBuffer(data, size, offset, numEntities);
+
+    // Map data
+    const std::size_t tilesSize = world.tiles.size() * sizeof(Tile);
+    const std::size_t passabilitySize = world.tilePassability.size() * sizeof(TilePassability);
+    if (offset + tilesSize + passabilitySize > size)
+    {
+        throw std::runtime_error("Trying to read past end of buffer");
+    }
+    const std::size_t mapDataOffset = offset;
+    offset += tilesSize + passabilitySize;
+
+    // Check the Entities before touching the World, so that a bad snapshot leaves the World as it was
+    const std::size_t entitiesOffset = offset;
+    std::vector<std::shared_ptr<Entity>> snapshotEntities;
+    snapshotEntities.reserve(numEntities);
+    std::unordered_set<int> snapshotIds;
+    std::size_t numExistingEntities = 0;
+    for (std::uint32_t i = 0; i < numEntities; ++i)
+    {
+        int id = -1;
+        BufferUtils::readFromBuffer(data, size, offset, id);
+        if (id >= nextId || !snapshotIds.insert(id).second)
+        {
+            throw std::runtime_error("Snapshot contains invalid entity: " + std::to_string(id));
+        }
+
+        std::shared_ptr<Entity> entity;
+        auto it = world.entities.find(id);
+        if (it != world.entities.cend())
+        {
+            entity = it->second;
+            ++numExistingEntities;
+        }
+        else
+        {
+            // The Entity may have been removed since the snapshot was taken, in which case we can bring it back
+            entity = findEntity(removedEntities, id);
+            if (!entity)
+            {
+                throw std::runtime_error("Snapshot contains unknown entity: " + std::to_string(id));
+            }
+        }
+
+        entity->checkState(data, size, offset);
+        snapshotEntities.push_back(entity);
+    }
+
+    // IDs are never reused, so any Entity with an ID from nextId onwards was spawned after the snapshot was taken;
+    // every other Entity must be part of the snapshot
+    std::size_t numOlderEntities = 0;
+    for (const auto& kv : world.entities)
+    {
+        if (kv.first < nextId)
+        {
+            ++numOlderEntities;
+        }
+    }
+    if (numExistingEntities != numOlderEntities)
+    {
+        throw std::runtime_error("Snapshot does not match world entities");
+    }
+
+    // Everything checks out, so now we can restore
+    if (std::memcmp(world.tiles.data(), data + mapDataOffset, tilesSize) != 0)
+    {
+        std::memcpy(world.tiles.data(), data + mapDataOffset, tilesSize);
+        ++world.tilesVersion;
+    }
+    std::memcpy(world.tilePassability.data(), data + mapDataOffset + tilesSize, passabilitySize);
+
+    world.wilderness = wilderness != 0;
+    world.nextId = nextId;
+
+    for (auto it = world.entities.begin(); it != world.entities.end();)
+    {
+        if (it->first < nextId)
+        {
+            ++it;
+            continue;
+        }
+
+        const std::shared_ptr<Entity> entity = it->second;
+        it = world.entities.erase(it);
+        entity->onDelete();
+    }
+
+    // The snapshot was taken between ticks, when no Entities were pending
+    world.pendingEntities.clear();
+
+    offset = entitiesOffset;
+    for (const auto& entity : snapshotEntities)
+    {
+        int id = -1;
+        BufferUtils::readFromBuffer(data, size, offset, id);
+        world.entities.insert({ id, entity });
+        entity->restoreState(data, size, offset);
+    }
+}
+
+void WorldSnapshot::saveToFile(const World& world, const std::string& filename)
+{
+    std::vector<char> buffer;
+    save(world, buffer);
+
+    std::ofstream os(filename, std::ios::binary | std::ios::trunc);
+    if (!os.is_open())
+    {
+        throw std::runtime_error("Failed to open snapshot file for writing: " + filename);
+    }
+    os.write(buffer.data(), buffer.size());
+}
+
+void WorldSnapshot::restoreFromFile(World& world, const std::string& filename)
+{
+    MappedFile file(filename);
+    restore(world, file.getData(), file.getSize());
+}
+
+}  // namespace Rival
@@ -8,25 +8,32 @@
 #include "utils/BufferUtils.h"
 #include "EnumUtils.h"
 #include "GameCommand.h"
+#include "GroupMoveCommand.h"
 #include "MoveCommand.h"
+#include "SetCommandDelayCommand.h"
 
 namespace Rival {
 
-std::shared_ptr<GameCommand> GameCommandFactory::deserialize(const std::vector<char>& buffer, size_t& offset) const
+std::shared_ptr<GameCommand>
+GameCommandFactory::deserialize(const char* buffer, std::size_t bufferSize, std::size_t& offset) const
 {
     GameCommandType type = GameCommandType::Invalid;
-    BufferUtils::readFromBuffer(buffer, offset, type);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, type);
 
-    return deserializeFromType(buffer, type, offset);
+    return deserializeFromType(buffer, bufferSize, type, offset);
 }
 
-std::shared_ptr<GameCommand>
-GameCommandFactory::deserializeFromType(const std::vector<char>& buffer, GameCommandType type, size_t& offset) const
+std::shared_ptr<GameCommand> GameCommandFactory::deserializeFromType(
+        const char* buffer, std::size_t bufferSize, GameCommandType type, std::size_t& offset) const
 {
     switch (type)
     {
     case GameCommandType::Move:
-        return MoveCommand::deserialize(buffer, offset);
+        return MoveCommand::deserialize(buffer, bufferSize, offset);
+    case GameCommandType::SetCommandDelay:
+        return SetCommandDelayCommand::deserialize(buffer, bufferSize, offset);
+    case GameCommandType::GroupMove:
+        return GroupMoveCommand::deserialize(buffer, bufferSize, offset);
     default:
         std::cerr << "Unsupported GameCommand type received: " << std::to_string(EnumUtils::toIntegral(type)) << "\n";
         return {};
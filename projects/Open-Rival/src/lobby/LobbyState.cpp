@@ -3,22 +3,37 @@
 #include "lobby/LobbyState.h"
 
 #include <cstdlib>  // std::rand
+#include <memory>
+#include <stdexcept>
+#include <utility>  // std::move
+#include <vector>
 
 #include "net/packet-handlers/AcceptPlayerPacketHandler.h"
 #include "net/packet-handlers/KickPlayerPacketHandler.h"
 #include "net/packet-handlers/LobbyWelcomePacketHandler.h"
 #include "net/packet-handlers/RejectPlayerPacketHandler.h"
 #include "net/packet-handlers/RequestJoinPacketHandler.h"
+#include "net/packet-handlers/ScenarioAckPacketHandler.h"
+#include "net/packet-handlers/ScenarioChunkPacketHandler.h"
+#include "net/packet-handlers/ScenarioInfoPacketHandler.h"
 #include "net/packet-handlers/StartGamePacketHandler.h"
 #include "net/packets/AcceptPlayerPacket.h"
 #include "net/packets/KickPlayerPacket.h"
 #include "net/packets/LobbyWelcomePacket.h"
 #include "net/packets/RejectPlayerPacket.h"
 #include "net/packets/RequestJoinPacket.h"
+#include "net/packets/ScenarioAckPacket.h"
+#include "net/packets/ScenarioInfoPacket.h"
 #include "net/packets/StartGamePacket.h"
+#include "net/packets/TargetedPacket.h"
+#include "replay/ReplayReader.h"
+#include "replay/ReplayWriter.h"
+#include "utils/ChecksumUtils.h"
+#include "utils/CompressionUtils.h"
 #include "Application.h"
 #include "ApplicationContext.h"
 #include "ConfigUtils.h"
+#include "FileUtils.h"
 #include "GameState.h"
 #include "PlayerState.h"
 #include "ScenarioBuilder.h"
@@ -34,10 +49,13 @@ Rect makeViewport(const Window* window)
     return { 0, 0, window->getWidth(), window->getHeight() };
 }
 
-LobbyState::LobbyState(Application& app, std::string playerName, bool host)
+LobbyState::LobbyState(
+        Application& app, std::string playerName, bool host, ReplaySettings replaySettings, bool rollback)
     : State(app)
     , host(host)
     , localPlayerName(playerName)
+    , replaySettings(replaySettings)
+    , rollback(rollback)
     , menuRenderer(res, window, makeViewport(window))
     , textRenderer(window)
 {
@@ -48,12 +66,33 @@ LobbyState::LobbyState(Application& app, std::string playerName, bool host)
     packetHandlers.insert({ PacketType::LobbyWelcome, std::make_unique<LobbyWelcomePacketHandler>() });
     packetHandlers.insert({ PacketType::KickPlayer, std::make_unique<KickPlayerPacketHandler>() });
     packetHandlers.insert({ PacketType::StartGame, std::make_unique<StartGamePacketHandler>() });
+    packetHandlers.insert({ PacketType::ScenarioInfo, std::make_unique<ScenarioInfoPacketHandler>() });
+    packetHandlers.insert({ PacketType::ScenarioChunk, std::make_unique<ScenarioChunkPacketHandler>() });
+    packetHandlers.insert({ PacketType::ScenarioAck, std::make_unique<ScenarioAckPacketHandler>() });
 }
 
 void LobbyState::onLoad()
 {
+    if (replaySettings.isPlayback())
+    {
+        // Replays contain their own copy of the scenario
+        replayReader = std::make_shared<ReplayReader>(replaySettings.playbackFilename);
+        setScenario(replayReader->getScenarioData());
+        startGame();
+        return;
+    }
+
+    if (isNetGame() && !host)
+    {
+        // Clients wait to receive the scenario from the host once they have joined.
+        // We generate a random request ID, just in case 2 players try to join with the same name.
+        joinRequestId = std::rand();
+        RequestJoinPacket joinPacket(joinRequestId, localPlayerName);
+        app.getConnection()->send(joinPacket);
+        return;
+    }
+
     // Load the initial level
-    // TODO: Clients should wait to receive the level name from the host
     ApplicationContext& context = app.getContext();
     const std::string levelName = ConfigUtils::get(context.getConfig(), "levelName", std::string());
     if (levelName.empty())
@@ -64,20 +103,15 @@ void LobbyState::onLoad()
 
     if (isNetGame())
     {
-        if (host)
-        {
-            // Add ourselves to the lobby.
-            // The host should always have a client ID and player ID of 0.
-            ClientInfo localClient(0, localPlayerName);
-            onPlayerAccepted(joinRequestId, 0, localClient);
-        }
-        else
-        {
-            // We generate a random request ID, just in case 2 players try to join with the same name
-            joinRequestId = std::rand();
-            RequestJoinPacket joinPacket(joinRequestId, localPlayerName);
-            app.getConnection()->send(joinPacket);
-        }
+        // Compress the scenario up-front, ready to send to any players who don't have it
+        compressedScenario = std::make_shared<const std::vector<char>>(CompressionUtils::compress(scenarioFileData));
+        std::cout << "Compressed scenario from " << scenarioFileData.size() << " to " << compressedScenario->size()
+                  << " bytes\n";
+
+        // Add ourselves to the lobby.
+        // The host should always have a client ID and player ID of 0.
+        ClientInfo localClient(0, localPlayerName);
+        onPlayerAccepted(joinRequestId, 0, localClient);
     }
     else
     {
@@ -89,6 +123,7 @@ void LobbyState::onLoad()
 void LobbyState::update()
 {
     pollNetwork();
+    sendScenarioChunks();
 }
 
 void LobbyState::render(int delta)
@@ -175,7 +210,8 @@ void LobbyState::pollNetwork()
         return;
     }
 
-    const auto& receivedPackets = app.getConnection()->getReceivedPackets();
+    std::vector<std::shared_ptr<const Packet>> receivedPackets;
+    app.getConnection()->getReceivedPackets(receivedPackets);
     for (auto& packet : receivedPackets)
     {
         auto iter = packetHandlers.find(packet->getType());
@@ -234,6 +270,17 @@ void LobbyState::onPlayerAccepted(int requestId, int clientId, const ClientInfo&
         clientsIncludingHost.insert({ 0, localClient });
         LobbyWelcomePacket welcomePacket(client.getPlayerId(), clientsIncludingHost);
         app.getConnection()->send(welcomePacket);
+
+        // Tell them which scenario we are playing; they will ask for it if they don't have it
+        ScenarioInfoPacket infoPacket(
+                client.getPlayerId(),
+                scenarioFilename,
+                static_cast<std::uint32_t>(scenarioFileData.size()),
+                static_cast<std::uint32_t>(compressedScenario->size()),
+                ChecksumUtils::crc32(scenarioFileData));
+        app.getConnection()->send(TargetedPacket(clientId, infoPacket));
+        scenarioUploads.insert_or_assign(
+                client.getPlayerId(), ScenarioUpload(client.getPlayerId(), clientId, compressedScenario));
     }
 
     clients.insert({ clientId, client });
@@ -286,8 +333,133 @@ int LobbyState::requestPlayerId()
 
 void LobbyState::loadLevel(const std::string& filename)
 {
-    ScenarioReader reader(Resources::mapsDir + filename);
+    scenarioFilename = filename;
+    setScenario(FileUtils::readBinaryFile(Resources::mapsDir + filename));
+}
+
+void LobbyState::setScenario(std::vector<std::uint8_t> data)
+{
+    ScenarioReader reader(data);
     scenarioData = reader.readScenario();
+    scenarioFileData = std::move(data);
+}
+
+void LobbyState::onScenarioInfoReceived(
+        int playerId,
+        const std::string& filename,
+        std::uint32_t scenarioSize,
+        std::uint32_t compressedSize,
+        std::uint32_t checksum)
+{
+    if (playerId != localPlayerId)
+    {
+        // This was not intended for us
+        return;
+    }
+
+    // The filename comes from the host, so make sure it cannot point anywhere outside of our maps directory
+    if (!ScenarioDownload::isValidFilename(filename))
+    {
+        // TODO: return to main menu
+        throw std::runtime_error("Invalid scenario filename received from host: " + filename);
+    }
+
+    scenarioFilename = filename;
+
+    // Use our own copy of the scenario if it is identical to the host's
+    std::vector<std::uint8_t> localData;
+    try
+    {
+        localData = FileUtils::readBinaryFile(Resources::mapsDir + filename);
+    }
+    catch (const std::runtime_error&)
+    {
+        // We don't have this scenario at all
+    }
+
+    if (localData.size() == scenarioSize && ChecksumUtils::crc32(localData) == checksum)
+    {
+        std::cout << "Found scenario " << filename << "\n";
+        setScenario(std::move(localData));
+        ScenarioAckPacket ackPacket(localPlayerId, ScenarioUpload::getNumChunks(compressedSize));
+        app.getConnection()->send(ackPacket);
+        return;
+    }
+
+    std::cout << "Downloading scenario " << filename << " (" << compressedSize << " bytes)\n";
+    scenarioDownload.emplace(scenarioSize, compressedSize, checksum);
+    ScenarioAckPacket ackPacket(localPlayerId, 0);
+    app.getConnection()->send(ackPacket);
+}
+
+void LobbyState::onScenarioChunkReceived(int playerId, std::uint32_t chunkIndex, const std::vector<char>& data)
+{
+    if (playerId != localPlayerId || !scenarioDownload)
+    {
+        // This was not intended for us
+        return;
+    }
+
+    scenarioDownload->addChunk(chunkIndex, data);
+
+    if (scenarioDownload->isAckDue())
+    {
+        ScenarioAckPacket ackPacket(localPlayerId, scenarioDownload->getChunksReceived());
+        app.getConnection()->send(ackPacket);
+    }
+
+    if (scenarioDownload->isComplete())
+    {
+        std::cout << "Received scenario " << scenarioFilename << "\n";
+        setScenario(scenarioDownload->extract());
+        scenarioDownload.reset();
+    }
+}
+
+void LobbyState::onScenarioAckReceived(int playerId, std::uint32_t chunksReceived)
+{
+    if (!host)
+    {
+        return;
+    }
+
+    auto iter = scenarioUploads.find(playerId);
+    if (iter == scenarioUploads.end() || iter->second.isComplete())
+    {
+        return;
+    }
+
+    ScenarioUpload& upload = iter->second;
+    upload.onAckReceived(chunksReceived);
+    if (upload.isComplete())
+    {
+        std::cout << "Player " << std::to_string(playerId) << " has the scenario\n";
+    }
+}
+
+void LobbyState::sendScenarioChunks()
+{
+    if (!host || !isNetGame())
+    {
+        return;
+    }
+
+    for (auto& entry : scenarioUploads)
+    {
+        entry.second.sendChunks(*app.getConnection());
+    }
+}
+
+bool LobbyState::isScenarioReceivedByAll() const
+{
+    for (const auto& entry : scenarioUploads)
+    {
+        if (!entry.second.isComplete())
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 void LobbyState::requestStartGame()
@@ -298,11 +470,28 @@ void LobbyState::requestStartGame()
         return;
     }
 
-    StartGamePacket packet;
+    if (!isScenarioReceivedByAll())
+    {
+        std::cerr << "Cannot start the game until every player has the scenario\n";
+        return;
+    }
+
+    StartGamePacket packet(rollback);
     app.getConnection()->send(packet);
     startGame();
 }
 
+void LobbyState::onStartGameReceived(bool rollbackEnabled)
+{
+    if (scenarioFileData.empty())
+    {
+        throw std::runtime_error("Game started before the scenario was received");
+    }
+
+    rollback = rollbackEnabled;
+    startGame();
+}
+
 void LobbyState::startGame()
 {
     std::unique_ptr<State> game = createGameState();
@@ -334,7 +523,23 @@ std::unique_ptr<State> LobbyState::createGameState() const
                         static_cast<int>(playerProps.startingFood)));
     }
 
-    return std::make_unique<GameState>(app, std::move(world), playerStates, clients, localPlayerId);
+    auto game = std::make_unique<GameState>(app, std::move(world), playerStates, clients, localPlayerId);
+
+    if (replaySettings.isRecording())
+    {
+        game->startRecording(std::make_unique<ReplayWriter>(replaySettings.recordFilename, scenarioFileData));
+    }
+    else if (replayReader)
+    {
+        game->startReplay(replayReader, replaySettings.fastForward);
+    }
+
+    if (rollback && isNetGame())
+    {
+        game->enableRollback();
+    }
+
+    return game;
 }
 
 bool LobbyState::isNetGame() const
@@ -2,36 +2,63 @@
 
 #include "net/Connection.h"
 
+#include <chrono>
+#include <exception>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <utility>  // std::move
 
-#include "net/packets/RelayedPacket.h"
-#include "utils/BufferUtils.h"
+#include "TimeUtils.h"
 
 namespace Rival {
 
-Connection::Connection(
-        Socket socket, std::shared_ptr<PacketFactory> packetFactory, int remoteClientId, ConnectionListener* listener)
+Connection::Connection(Socket socket, std::shared_ptr<PacketFactory> packetFactory, Transport transport)
     : socket(std::move(socket))
     , packetFactory(packetFactory)
-    , remoteClientId(remoteClientId)
-    , listener(listener)
-    , receiveThread(&Connection::receiveThreadLoop, this)
+    , transport(transport)
 {
     sendBuffer.reserve(maxBufferSize);
     recvBuffer.reserve(maxBufferSize);
+
+    // Threads are only started once every member they use has been constructed
+    receiveThread = std::thread(
+            transport == Transport::Udp ? &Connection::receiveDatagramsLoop : &Connection::receiveThreadLoop, this);
+
+    if (transport == Transport::Tcp)
+    {
+        writeThread = std::thread(&Connection::writeThreadLoop, this);
+    }
+}
+
+Connection::Connection(std::shared_ptr<LoopbackLink> link, std::shared_ptr<PacketFactory> packetFactory)
+    : packetFactory(packetFactory)
+    , transport(Transport::Loopback)
+    , loopbackLink(link)
+{
+    sendBuffer.reserve(maxBufferSize);
 }
 
 Connection::~Connection()
 {
     close();
-    receiveThread.join();
+    if (receiveThread.joinable())
+    {
+        receiveThread.join();
+    }
+    if (writeThread.joinable())
+    {
+        writeThread.join();
+    }
+
+    const ConnectionStats stats = getStats();
+    std::cout << "Connection closed; sent " << stats.packetsSent << " packets (" << stats.bytesSent << " bytes) in "
+              << stats.socketWrites << " writes, received " << stats.packetsReceived << " packets\n";
 }
 
 bool Connection::operator==(const Connection& other) const
 {
-    return socket == other.socket;
+    return socket == other.socket && loopbackLink == other.loopbackLink;
 }
 
 bool Connection::operator!=(const Connection& other) const
@@ -42,11 +69,16 @@ bool Connection::operator!=(const Connection& other) const
 void Connection::close() noexcept
 {
     socket.close();
+    if (loopbackLink)
+    {
+        loopbackLink->closed = true;
+    }
+    wakeWriteThread();
 }
 
 bool Connection::isOpen() const
 {
-    return socket.isOpen();
+    return loopbackLink ? !loopbackLink->closed : socket.isOpen();
 }
 
 void Connection::receiveThreadLoop()
@@ -61,8 +93,7 @@ void Connection::receiveThreadLoop()
 
         // Extract the packet size from the buffer
         std::size_t offset = 0;
-        int nextPacketSize = 0;
-        BufferUtils::readFromBuffer(recvBuffer, offset, nextPacketSize);
+        const std::size_t nextPacketSize = Packet::readSize(recvBuffer.data(), recvBuffer.size(), offset);
         recvBuffer.clear();
 
         // Sanity-check the packet size
@@ -77,24 +108,242 @@ void Connection::receiveThreadLoop()
             break;
         }
 
-        // If this Connection has no packet factory, then it belongs to the relay server. The relay server doesn't care
-        // about the contents of incoming packets, it just wraps them in RelayedPackets.
-        std::shared_ptr<const Packet> packet = packetFactory
-                ? packetFactory->deserialize(recvBuffer)
-                : std::make_shared<RelayedPacket>(recvBuffer, remoteClientId);
+        onPacketReceived(recvBuffer.data(), recvBuffer.size());
+    }
+}
+
+void Connection::receiveDatagramsLoop()
+{
+    std::vector<char> datagram(ReliableChannel::maxDatagramSize);
+    std::uint32_t lastReceiveTime = TimeUtils::getNetTimestamp();
+
+    while (isOpen())
+    {
+        const int size = socket.receiveDatagram(datagram.data(), datagram.size(), datagramResendIntervalMs);
+        if (size < 0)
+        {
+            break;
+        }
+
+        const std::uint32_t now = TimeUtils::getNetTimestamp();
+        if (size == 0)
+        {
+            if (now - lastReceiveTime > datagramTimeoutMs)
+            {
+                std::cerr << "Connection timed out\n";
+                close();
+                break;
+            }
+
+            // Make sure our data still gets through even if the connection is not being flushed
+            std::scoped_lock lock(channelMutex);
+            if (channel.hasUnackedMessages() || isKeepAliveDue())
+            {
+                sendDatagram();
+            }
+            continue;
+        }
+
+        lastReceiveTime = now;
 
-        if (packet)
+        try
         {
-            // Pass packets directly to the listener if present, otherwise queue them until requested
-            if (listener)
             {
-                listener->onPacketReceived(*this, packet);
+                std::scoped_lock lock(channelMutex);
+                channel.readDatagram(datagram.data(), static_cast<std::size_t>(size), now, receivedStream);
             }
-            else
+            extractPacketsFromStream();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Received invalid data: " << e.what() << "\n";
+            close();
+            break;
+        }
+    }
+}
+
+/**
+ * Writes each block of packets handed over by `flush` to the socket.
+ *
+ * Writes may block if the other side is slow to read, but only this thread has to wait for them.
+ */
+void Connection::writeThreadLoop()
+{
+    std::shared_ptr<const std::vector<char>> block;
+
+    while (isOpen())
+    {
+        {
+            std::unique_lock lock(writeWakeMutex);
+            writeWakeCondition.wait(lock, [this]() { return !isOpen() || queuedWrites.size() > 0; });
+        }
+
+        while (queuedWrites.tryPop(block))
+        {
+            socket.send(*block);
+            if (!isOpen())
             {
-                std::scoped_lock lock(receivedPacketsMutex);
-                receivedPackets.push_back(packet);
+                break;
             }
+
+            bytesSent += block->size();
+            ++socketWrites;
+
+            // Release the block now rather than holding onto it until the next one arrives
+            block.reset();
+        }
+    }
+}
+
+/**
+ * Wakes the writer thread, if there is one, so that it notices new data or the connection closing.
+ */
+void Connection::wakeWriteThread()
+{
+    if (transport != Transport::Tcp)
+    {
+        return;
+    }
+
+    {
+        // Taking the lock ensures that the writer thread cannot miss the notification between checking for data and
+        // starting to wait
+        std::scoped_lock lock(writeWakeMutex);
+    }
+    writeWakeCondition.notify_one();
+}
+
+/**
+ * Records the number of blocks of packets waiting to be written.
+ *
+ * The send mutex must be held by the caller.
+ */
+void Connection::recordSendQueueDepth(std::size_t queueDepth)
+{
+    if (queueDepth > maxSendQueueDepth.load(std::memory_order_relaxed))
+    {
+        maxSendQueueDepth.store(queueDepth, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Splits the data delivered by the ReliableChannel into packets.
+ *
+ * Any incomplete packet at the end of the stream is kept until the rest of it arrives.
+ */
+void Connection::extractPacketsFromStream()
+{
+    std::size_t offset = 0;
+
+    while (receivedStream.size() - offset >= Packet::sizeBytes)
+    {
+        // Peek at the packet size
+        std::size_t packetOffset = offset;
+        const std::size_t packetSize = Packet::readSize(receivedStream.data(), receivedStream.size(), packetOffset);
+
+        // Sanity-check the packet size
+        if (packetSize > maxBufferSize)
+        {
+            throw std::runtime_error("Unexpected packet size: " + std::to_string(packetSize));
+        }
+
+        if (receivedStream.size() - packetOffset < packetSize)
+        {
+            break;
+        }
+
+        // Packets are deserialized in place, without copying them out of the stream
+        onPacketReceived(receivedStream.data() + packetOffset, packetSize);
+        offset = packetOffset + packetSize;
+    }
+
+    receivedStream.erase(receivedStream.begin(), receivedStream.begin() + offset);
+}
+
+/**
+ * Deserializes a received packet and queues it until requested.
+ */
+void Connection::onPacketReceived(const char* data, std::size_t size)
+{
+    std::shared_ptr<Packet> packet = deserializePacket(data, size);
+    if (!packet)
+    {
+        return;
+    }
+
+    // Queue packets until requested. Packets must not be lost, so if the queue is full we have no choice but to wait
+    // for the game to catch up; this is only the receive thread, so the game itself is never held up.
+    std::shared_ptr<const Packet> queuedPacket = packet;
+    while (!receivedPackets.tryPush(std::move(queuedPacket)))
+    {
+        if (!isOpen())
+        {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(queueFullWaitMs));
+    }
+
+    // Only the receive thread ever writes this, so there is no need for anything more expensive than a plain store
+    const std::size_t queueDepth = receivedPackets.size();
+    if (queueDepth > maxReceiveQueueDepth.load(std::memory_order_relaxed))
+    {
+        maxReceiveQueueDepth.store(queueDepth, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Deserializes a received packet and records it in the stats.
+ *
+ * Returns null if the packet is not recognized.
+ */
+std::shared_ptr<Packet> Connection::deserializePacket(const char* data, std::size_t size)
+{
+    std::shared_ptr<Packet> packet = packetFactory->deserialize(data, size);
+    if (!packet)
+    {
+        return nullptr;
+    }
+
+    packet->setReceiveTime(TimeUtils::getNetTimestamp());
+
+    ++packetsReceived;
+    bytesReceived += Packet::sizeBytes + size;
+
+    return packet;
+}
+
+/**
+ * Deserializes every packet that the server has passed over the loopback link.
+ */
+void Connection::receiveFromLoopback(std::vector<std::shared_ptr<const Packet>>& packets)
+{
+    // Only the collecting thread ever writes this when using the loopback transport
+    const std::size_t queueDepth = loopbackLink->toClient.size();
+    if (queueDepth > maxReceiveQueueDepth.load(std::memory_order_relaxed))
+    {
+        maxReceiveQueueDepth.store(queueDepth, std::memory_order_relaxed);
+    }
+
+    LoopbackLink::Block block;
+    while (loopbackLink->toClient.tryPop(block))
+    {
+        // Blocks only ever contain complete packets
+        std::size_t offset = 0;
+        while (offset < block->size())
+        {
+            const std::size_t packetSize = Packet::readSize(block->data(), block->size(), offset);
+            if (packetSize > block->size() - offset)
+            {
+                throw std::runtime_error("Unexpected packet size: " + std::to_string(packetSize));
+            }
+
+            std::shared_ptr<Packet> packet = deserializePacket(block->data() + offset, packetSize);
+            if (packet)
+            {
+                packets.push_back(std::move(packet));
+            }
+            offset += packetSize;
         }
     }
 }
@@ -111,27 +360,170 @@ bool Connection::readFromSocket(std::size_t numBytes)
 
 void Connection::send(const Packet& packet)
 {
+    std::scoped_lock lock(sendMutex);
+
     packet.serialize(sendBuffer);
     packet.finalize(sendBuffer);
     if (sendBuffer.empty())
     {
         throw std::runtime_error("Tried to send empty buffer");
     }
-    socket.send(sendBuffer);
+    pendingSends.insert(pendingSends.cend(), sendBuffer.cbegin(), sendBuffer.cend());
     sendBuffer.clear();
+
+    ++packetsSent;
 }
 
-std::vector<std::shared_ptr<const Packet>> Connection::getReceivedPackets()
+void Connection::flush()
 {
-    std::vector<std::shared_ptr<const Packet>> packetsToReturn;
+    std::scoped_lock lock(sendMutex);
+
+    if (transport == Transport::Loopback)
+    {
+        flushLoopback();
+        return;
+    }
 
+    if (transport == Transport::Udp)
     {
-        std::scoped_lock lock(receivedPacketsMutex);
-        packetsToReturn = receivedPackets;
-        receivedPackets.clear();
+        std::scoped_lock channelLock(channelMutex);
+
+        // Everything produced during the tick becomes a single message
+        if (!pendingSends.empty())
+        {
+            channel.queueMessage(pendingSends.data(), pendingSends.size());
+            bytesSent += pendingSends.size();
+            pendingSends.clear();
+        }
+
+        // Send a datagram if there is anything due, since this may also acknowledge received data or resend lost data
+        if (isOpen())
+        {
+            sendDatagram();
+        }
+        return;
     }
 
-    return packetsToReturn;
+    if (pendingSends.empty() || !isOpen())
+    {
+        return;
+    }
+
+    // Everything produced during the tick is written as a single block
+    auto block = std::make_shared<const std::vector<char>>(std::move(pendingSends));
+    pendingSends.clear();
+
+    if (!queuedWrites.tryPush(std::move(block)))
+    {
+        // Packets can never be dropped, so there is no way to recover if the socket cannot keep up
+        std::cerr << "Closing connection; " << maxQueuedWrites << " writes are waiting for the socket\n";
+        close();
+        return;
+    }
+
+    recordSendQueueDepth(queuedWrites.size());
+    wakeWriteThread();
+}
+
+/**
+ * Passes all queued packets to the server as a single block.
+ *
+ * The send mutex must be held by the caller.
+ */
+void Connection::flushLoopback()
+{
+    if (pendingSends.empty() || !isOpen())
+    {
+        return;
+    }
+
+    const std::size_t numBytes = pendingSends.size();
+    LoopbackLink::Block block = std::make_shared<const std::vector<char>>(std::move(pendingSends));
+    pendingSends.clear();
+
+    // Packets must not be lost, so if the server has fallen behind we have no choice but to wait for it, just as a
+    // write to a full socket would
+    while (!loopbackLink->toServer.tryPush(std::move(block)))
+    {
+        if (!isOpen())
+        {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(queueFullWaitMs));
+    }
+
+    bytesSent += numBytes;
+    ++socketWrites;
+    recordSendQueueDepth(loopbackLink->toServer.size());
+}
+
+void Connection::setSimulatedPacketLoss(float lossChance)
+{
+    std::scoped_lock lock(channelMutex);
+    simulatedLossChance = lossChance;
+}
+
+/**
+ * Sends the next datagram from the ReliableChannel, if there is anything to send.
+ *
+ * The channel mutex must be held by the caller.
+ */
+void Connection::sendDatagram()
+{
+    const std::uint32_t now = TimeUtils::getNetTimestamp();
+    if (!channel.writeDatagram(datagramSendBuffer, now, isKeepAliveDue()))
+    {
+        return;
+    }
+
+    lastDatagramSendTime = now;
+    ++socketWrites;
+
+    if (simulatedLossChance > 0.f
+        && std::uniform_real_distribution<float>(0.f, 1.f)(lossRandom) < simulatedLossChance)
+    {
+        return;
+    }
+
+    // Datagrams that cannot be sent are treated as lost; they will be resent if necessary
+    socket.trySend(datagramSendBuffer.data(), datagramSendBuffer.size());
+}
+
+bool Connection::isKeepAliveDue() const
+{
+    return TimeUtils::getNetTimestamp() - lastDatagramSendTime >= ReliableChannel::keepAliveIntervalMs;
+}
+
+ConnectionStats Connection::getStats() const
+{
+    ConnectionStats stats;
+    stats.packetsSent = packetsSent;
+    stats.bytesSent = bytesSent;
+    stats.socketWrites = socketWrites;
+    stats.packetsReceived = packetsReceived;
+    stats.bytesReceived = bytesReceived;
+    stats.receiveQueueDepth = loopbackLink ? loopbackLink->toClient.size() : receivedPackets.size();
+    stats.maxReceiveQueueDepth = maxReceiveQueueDepth.load(std::memory_order_relaxed);
+    stats.sendQueueDepth = loopbackLink ? loopbackLink->toServer.size() : queuedWrites.size();
+    stats.maxSendQueueDepth = maxSendQueueDepth.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void Connection::getReceivedPackets(std::vector<std::shared_ptr<const Packet>>& packets)
+{
+    packets.clear();
+
+    if (loopbackLink)
+    {
+        receiveFromLoopback(packets);
+        return;
+    }
+
+    std::shared_ptr<const Packet> packet;
+    while (receivedPackets.tryPop(packet))
+    {
+        packets.push_back(std::move(packet));
+    }
 }
 
 }  // namespace Rival
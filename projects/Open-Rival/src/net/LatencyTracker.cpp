@@ -0,0 +1,44 @@
+#include "pch.h"
+
+#include "net/LatencyTracker.h"
+
+#include <cmath>  // std::abs
+
+namespace Rival {
+
+void LatencyTracker::addRttSample(std::uint32_t rttMs)
+{
+    const float rtt = static_cast<float>(rttMs);
+
+    if (!rttSampled)
+    {
+        smoothedRtt = rtt;
+        rttVariation = rtt / 2;
+        rttSampled = true;
+        return;
+    }
+
+    // RFC 6298, section 2.3
+    rttVariation += (std::abs(smoothedRtt - rtt) - rttVariation) / 4;
+    smoothedRtt += (rtt - smoothedRtt) / 8;
+}
+
+void LatencyTracker::addArrival(std::uint32_t relayTime, std::uint32_t receiveTime)
+{
+    if (arrivalSampled)
+    {
+        // RFC 3550, section 6.4.1.
+        // The offset between the 2 clocks cancels out, so we only see the change in transit time. The subtraction is
+        // done on unsigned values first so that it is unaffected by the timestamps wrapping around.
+        const auto receiveDelta = static_cast<std::int32_t>(receiveTime - lastReceiveTime);
+        const auto relayDelta = static_cast<std::int32_t>(relayTime - lastRelayTime);
+        const float transitDelta = static_cast<float>(std::abs(receiveDelta - relayDelta));
+        jitter += (transitDelta - jitter) / 16;
+    }
+
+    lastRelayTime = relayTime;
+    lastReceiveTime = receiveTime;
+    arrivalSampled = true;
+}
+
+}  // namespace Rival
@@ -0,0 +1,96 @@
+#include "pch.h"
+
+#include "net/NetTelemetry.h"
+
+#include <algorithm>  // std::max
+
+namespace Rival {
+
+void NetTelemetry::addRttSample(std::uint32_t rttMs)
+{
+    lastRttSampleMs = rttMs;
+    maxRttSampleMs = std::max(maxRttSampleMs, rttMs);
+}
+
+void NetTelemetry::addStalledUpdate(std::uint32_t missingClientsMask)
+{
+    ++stalledUpdates;
+
+    for (int clientId = 0; clientId < maxClients; ++clientId)
+    {
+        if (missingClientsMask & (1u << clientId))
+        {
+            ++stalledUpdatesByClient[clientId];
+        }
+    }
+}
+
+NetMetrics NetTelemetry::collectMetrics(std::uint32_t elapsedMs, const ConnectionStats& connectionStats)
+{
+    const float elapsedSeconds = elapsedMs > 0 ? static_cast<float>(elapsedMs) / 1000.f : 1.f;
+
+    NetMetrics metrics;
+    metrics.packetsInPerSecond =
+            static_cast<float>(connectionStats.packetsReceived - lastConnectionStats.packetsReceived) / elapsedSeconds;
+    metrics.bytesInPerSecond =
+            static_cast<float>(connectionStats.bytesReceived - lastConnectionStats.bytesReceived) / elapsedSeconds;
+    metrics.packetsOutPerSecond =
+            static_cast<float>(connectionStats.packetsSent - lastConnectionStats.packetsSent) / elapsedSeconds;
+    metrics.bytesOutPerSecond =
+            static_cast<float>(connectionStats.bytesSent - lastConnectionStats.bytesSent) / elapsedSeconds;
+    metrics.lastRttSampleMs = lastRttSampleMs;
+    metrics.maxRttSampleMs = maxRttSampleMs;
+    metrics.receiveQueueDepth = connectionStats.receiveQueueDepth;
+    metrics.maxReceiveQueueDepth = connectionStats.maxReceiveQueueDepth;
+    metrics.sendQueueDepth = connectionStats.sendQueueDepth;
+    metrics.maxSendQueueDepth = connectionStats.maxSendQueueDepth;
+    metrics.stalledUpdates = stalledUpdates;
+
+    for (int clientId = 0; clientId < maxClients; ++clientId)
+    {
+        if (stalledUpdatesByClient[clientId] > metrics.worstClientStalledUpdates)
+        {
+            metrics.worstClientId = clientId;
+            metrics.worstClientStalledUpdates = stalledUpdatesByClient[clientId];
+        }
+    }
+
+    lastConnectionStats = connectionStats;
+    lastRttSampleMs = 0;
+    maxRttSampleMs = 0;
+    stalledUpdates = 0;
+    stalledUpdatesByClient.fill(0);
+
+    return metrics;
+}
+
+std::string NetTelemetry::formatTraffic(const NetMetrics& metrics)
+{
+    return "In: " + std::to_string(static_cast<int>(metrics.packetsInPerSecond)) + " pkt/s "
+            + std::to_string(static_cast<int>(metrics.bytesInPerSecond)) + " B/s  Out: "
+            + std::to_string(static_cast<int>(metrics.packetsOutPerSecond)) + " pkt/s "
+            + std::to_string(static_cast<int>(metrics.bytesOutPerSecond)) + " B/s  Queues: in "
+            + std::to_string(metrics.receiveQueueDepth) + " (max " + std::to_string(metrics.maxReceiveQueueDepth)
+            + ") out " + std::to_string(metrics.sendQueueDepth) + " (max " + std::to_string(metrics.maxSendQueueDepth)
+            + ")";
+}
+
+std::string NetTelemetry::formatLatency(const NetMetrics& metrics)
+{
+    return "RTT: " + std::to_string(metrics.rttMs) + "ms  Jitter: " + std::to_string(metrics.jitterMs)
+            + "ms  Last ping: " + std::to_string(metrics.lastRttSampleMs) + "ms (max "
+            + std::to_string(metrics.maxRttSampleMs) + "ms)";
+}
+
+std::string NetTelemetry::formatStalls(const NetMetrics& metrics)
+{
+    std::string text = "Stalled updates: " + std::to_string(metrics.stalledUpdates);
+    if (metrics.worstClientId >= 0)
+    {
+        text += " (waiting for client " + std::to_string(metrics.worstClientId) + " in "
+                + std::to_string(metrics.worstClientStalledUpdates) + ")";
+    }
+    return text;
+}
+
+}  // namespace Rival
@@ -2,58 +2,79 @@
 
 #include "net/PacketFactory.h"
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 
 #include "net/packets/AcceptPlayerPacket.h"
 #include "net/packets/GameCommandPacket.h"
 #include "net/packets/KickPlayerPacket.h"
+#include "net/packets/LatencyReportPacket.h"
 #include "net/packets/LobbyWelcomePacket.h"
+#include "net/packets/PingPacket.h"
 #include "net/packets/RejectPlayerPacket.h"
 #include "net/packets/RequestJoinPacket.h"
+#include "net/packets/ScenarioAckPacket.h"
+#include "net/packets/ScenarioChunkPacket.h"
+#include "net/packets/ScenarioInfoPacket.h"
 #include "net/packets/StartGamePacket.h"
 #include "utils/BufferUtils.h"
 #include "EnumUtils.h"
 
 namespace Rival {
 
-std::shared_ptr<Packet> PacketFactory::deserialize(const std::vector<char>& buffer) const
+std::shared_ptr<Packet> PacketFactory::deserialize(const char* buffer, std::size_t bufferSize) const
 {
     std::size_t offset = 0;
 
     int clientId = -1;
-    BufferUtils::readFromBuffer(buffer, offset, clientId);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, clientId);
+
+    std::uint32_t relayTime = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, relayTime);
 
     PacketType type = PacketType::Invalid;
-    BufferUtils::readFromBuffer(buffer, offset, type);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, type);
 
-    std::shared_ptr<Packet> packet = deserializeFromType(buffer, type);
+    std::shared_ptr<Packet> packet = deserializeFromType(buffer, bufferSize, type);
     if (packet)
     {
         packet->setClientId(clientId);
+        packet->setRelayTime(relayTime);
     }
 
     return packet;
 }
 
-std::shared_ptr<Packet> PacketFactory::deserializeFromType(const std::vector<char>& buffer, PacketType type) const
+std::shared_ptr<Packet>
+PacketFactory::deserializeFromType(const char* buffer, std::size_t bufferSize, PacketType type) const
 {
     switch (type)
     {
     case PacketType::RequestJoin:
-        return RequestJoinPacket::deserialize(buffer);
+        return RequestJoinPacket::deserialize(buffer, bufferSize);
     case PacketType::AcceptPlayer:
-        return AcceptPlayerPacket::deserialize(buffer);
+        return AcceptPlayerPacket::deserialize(buffer, bufferSize);
     case PacketType::RejectPlayer:
-        return RejectPlayerPacket::deserialize(buffer);
+        return RejectPlayerPacket::deserialize(buffer, bufferSize);
     case PacketType::LobbyWelcome:
-        return LobbyWelcomePacket::deserialize(buffer);
+        return LobbyWelcomePacket::deserialize(buffer, bufferSize);
     case PacketType::KickPlayer:
-        return KickPlayerPacket::deserialize(buffer);
+        return KickPlayerPacket::deserialize(buffer, bufferSize);
     case PacketType::StartGame:
-        return StartGamePacket::deserialize(buffer);
+        return StartGamePacket::deserialize(buffer, bufferSize);
     case PacketType::GameCommand:
-        return GameCommandPacket::deserialize(buffer, gameCommandFactory);
+        return GameCommandPacket::deserialize(buffer, bufferSize, gameCommandFactory);
+    case PacketType::Ping:
+        return PingPacket::deserialize(buffer, bufferSize);
+    case PacketType::LatencyReport:
+        return LatencyReportPacket::deserialize(buffer, bufferSize);
+    case PacketType::ScenarioInfo:
+        return ScenarioInfoPacket::deserialize(buffer, bufferSize);
+    case PacketType::ScenarioChunk:
+        return ScenarioChunkPacket::deserialize(buffer, bufferSize);
+    case PacketType::ScenarioAck:
+        return ScenarioAckPacket::deserialize(buffer, bufferSize);
     default:
         std::cerr << "Unsupported packet type received: " << std::to_string(EnumUtils::toIntegral(type)) << "\n";
         return {};
@@ -0,0 +1,267 @@
+#include "pch.h"
+
+#include "net/RelayClient.h"
+
+#include <array>
+#include <cstddef>  // std::ptrdiff_t
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::move
+
+#include "net/Connection.h"
+#include "net/packets/Packet.h"
+#include "TimeUtils.h"
+
+namespace Rival {
+
+RelayClient::RelayClient(int token, Socket socket)
+    : token(token)
+    , socket(std::move(socket))
+{
+    readBuffer.reserve(readChunkSize);
+}
+
+RelayClient::RelayClient(int token, Socket& datagramSocket, const SocketAddress& address)
+    : token(token)
+    , datagramSocket(&datagramSocket)
+    , address(address)
+    , lastReceiveTime(TimeUtils::getNetTimestamp())
+{
+    readBuffer.reserve(readChunkSize);
+    datagram.reserve(ReliableChannel::maxDatagramSize);
+}
+
+RelayClient::RelayClient(int token, std::shared_ptr<LoopbackLink> link)
+    : token(token)
+    , loopbackLink(link)
+{
+    readBuffer.reserve(readChunkSize);
+}
+
+RelayClient::~RelayClient()
+{
+    // Let the other side know that we have gone away, as closing a socket would
+    if (loopbackLink)
+    {
+        loopbackLink->closed = true;
+    }
+}
+
+int RelayClient::readFromSocket()
+{
+    int numReads = 0;
+
+    discardExtractedData();
+
+    while (!connectionLost)
+    {
+        std::size_t oldSize = readBuffer.size();
+        readBuffer.resize(oldSize + readChunkSize);
+
+        int bytesReceived = socket.tryReceive(readBuffer.data() + oldSize, readChunkSize);
+        ++numReads;
+        if (bytesReceived < 0)
+        {
+            connectionLost = true;
+            bytesReceived = 0;
+        }
+
+        readBuffer.resize(oldSize + static_cast<std::size_t>(bytesReceived));
+
+        if (static_cast<std::size_t>(bytesReceived) < readChunkSize)
+        {
+            // No more data available for now
+            break;
+        }
+    }
+
+    return numReads;
+}
+
+int RelayClient::readFromLoopback()
+{
+    int numReads = 0;
+
+    discardExtractedData();
+
+    LoopbackLink::Block block;
+    while (loopbackLink->toServer.tryPop(block))
+    {
+        readBuffer.insert(readBuffer.cend(), block->cbegin(), block->cend());
+        ++numReads;
+    }
+
+    return numReads;
+}
+
+void RelayClient::receiveDatagram(const char* data, std::size_t size)
+{
+    lastReceiveTime = TimeUtils::getNetTimestamp();
+
+    discardExtractedData();
+    channel.readDatagram(data, size, lastReceiveTime, readBuffer);
+}
+
+void RelayClient::discardExtractedData()
+{
+    if (readOffset > 0)
+    {
+        readBuffer.erase(readBuffer.begin(), readBuffer.begin() + static_cast<std::ptrdiff_t>(readOffset));
+        readOffset = 0;
+    }
+}
+
+bool RelayClient::nextPacket(std::vector<char>& packetData)
+{
+    const std::size_t bytesAvailable = readBuffer.size() - readOffset;
+    if (bytesAvailable < Packet::sizeBytes)
+    {
+        return false;
+    }
+
+    // Peek at the packet size
+    std::size_t offset = readOffset;
+    const std::size_t packetSize = Packet::readSize(readBuffer.data(), readBuffer.size(), offset);
+
+    // Sanity-check the packet size
+    if (packetSize > Connection::maxBufferSize)
+    {
+        throw std::runtime_error("Unexpected packet size: " + std::to_string(packetSize));
+    }
+
+    if (bytesAvailable < Packet::sizeBytes + packetSize)
+    {
+        return false;
+    }
+
+    packetData.assign(readBuffer.data() + offset, readBuffer.data() + offset + packetSize);
+    readOffset = offset + packetSize;
+    return true;
+}
+
+void RelayClient::queueSend(std::shared_ptr<const std::vector<char>> data)
+{
+    queuedBytes += data->size();
+    writeQueue.push_back(std::move(data));
+}
+
+int RelayClient::flush()
+{
+    if (isDatagramClient())
+    {
+        return flushDatagrams();
+    }
+
+    if (isLoopbackClient())
+    {
+        return flushLoopback();
+    }
+
+    std::array<SendBuffer, Socket::maxSendBuffers> sendBuffers;
+    int numWrites = 0;
+
+    while (hasPendingWrites() && !connectionLost)
+    {
+        // Gather as many queued packets as possible into a single write
+        std::size_t numBuffers = 0;
+        for (const auto& data : writeQueue)
+        {
+            if (numBuffers == sendBuffers.size())
+            {
+                break;
+            }
+            const std::size_t offset = numBuffers == 0 ? writeOffset : 0;
+            sendBuffers[numBuffers] = { data->data() + offset, data->size() - offset };
+            ++numBuffers;
+        }
+
+        int bytesSent = socket.trySend(sendBuffers.data(), numBuffers);
+        ++numWrites;
+        if (bytesSent < 0)
+        {
+            connectionLost = true;
+            break;
+        }
+
+        if (bytesSent == 0)
+        {
+            // Socket is not ready; try again once it becomes writable
+            break;
+        }
+
+        // Release every packet that has been sent in full
+        std::size_t bytesRemaining = static_cast<std::size_t>(bytesSent);
+        while (bytesRemaining > 0)
+        {
+            const std::size_t packetBytesRemaining = writeQueue.front()->size() - writeOffset;
+            if (bytesRemaining < packetBytesRemaining)
+            {
+                writeOffset += bytesRemaining;
+                break;
+            }
+
+            bytesRemaining -= packetBytesRemaining;
+            queuedBytes -= writeQueue.front()->size();
+            writeQueue.pop_front();
+            writeOffset = 0;
+        }
+    }
+
+    return numWrites;
+}
+
+int RelayClient::flushDatagrams()
+{
+    // Everything queued since the last flush is sent as a single message, to keep the per-message overhead down
+    const bool hasNewData = !writeQueue.empty();
+    pendingMessage.clear();
+    for (const auto& data : writeQueue)
+    {
+        pendingMessage.insert(pendingMessage.cend(), data->cbegin(), data->cend());
+    }
+    writeQueue.clear();
+    queuedBytes = 0;
+    channel.queueMessage(pendingMessage.data(), pendingMessage.size());
+
+    // Repeated and timed-out data does not need to go out on every call, so it is batched up between resend intervals
+    const std::uint32_t now = TimeUtils::getNetTimestamp();
+    const bool resendDue = channel.hasUnackedMessages() && now - lastSendTime >= resendIntervalMs;
+    const bool keepAliveDue = now - lastSendTime >= ReliableChannel::keepAliveIntervalMs;
+    if (!hasNewData && !resendDue && !keepAliveDue && !channel.isAckOwed())
+    {
+        return 0;
+    }
+
+    if (!channel.writeDatagram(datagram, now, keepAliveDue))
+    {
+        return 0;
+    }
+
+    // Datagrams that cannot be sent are treated as lost; they will be resent if necessary
+    datagramSocket->trySendTo(datagram.data(), datagram.size(), address);
+    lastSendTime = now;
+    return 1;
+}
+
+int RelayClient::flushLoopback()
+{
+    int numWrites = 0;
+
+    while (hasPendingWrites())
+    {
+        // If the link is full, the rest is left queued until the client catches up
+        LoopbackLink::Block block = writeQueue.front();
+        if (!loopbackLink->toClient.tryPush(std::move(block)))
+        {
+            break;
+        }
+
+        queuedBytes -= writeQueue.front()->size();
+        writeQueue.pop_front();
+        ++numWrites;
+    }
+
+    return numWrites;
+}
+
+}  // namespace Rival
@@ -0,0 +1,67 @@
+#include "pch.h"
+
+#include "net/RelayRoom.h"
+
+#include <algorithm>  // std::find
+
+#include "net/RelayClient.h"
+
+namespace Rival {
+
+RelayRoom::RelayRoom(int id, int maxClients)
+    : id(id)
+    , maxClients(maxClients)
+{
+}
+
+void RelayRoom::addClient(RelayClient& client)
+{
+    // Client IDs are just handed out incrementally.
+    // Note that these are NOT the same as player IDs - they are just a way to uniquely identify a connection.
+    // The server has no knowledge of player IDs since they are given out by the host inside of packets.
+    client.joinRoom(id, nextClientId);
+    ++nextClientId;
+
+    clients.push_back(&client);
+}
+
+void RelayRoom::removeClient(const RelayClient& client)
+{
+    auto iter = std::find(clients.begin(), clients.end(), &client);
+    if (iter != clients.end())
+    {
+        clients.erase(iter);
+    }
+}
+
+RoomMetrics RelayRoom::collectMetrics(std::uint32_t elapsedMs)
+{
+    const float elapsedSeconds = elapsedMs > 0 ? static_cast<float>(elapsedMs) / 1000.f : 1.f;
+
+    RoomMetrics metrics;
+    metrics.roomId = id;
+    metrics.numClients = static_cast<int>(clients.size());
+    metrics.packetsInPerSecond = static_cast<float>(packetsIn) / elapsedSeconds;
+    metrics.bytesInPerSecond = static_cast<float>(bytesIn) / elapsedSeconds;
+    metrics.packetsOutPerSecond = static_cast<float>(packetsOut) / elapsedSeconds;
+    metrics.bytesOutPerSecond = static_cast<float>(bytesOut) / elapsedSeconds;
+    metrics.readsPerSecond = static_cast<float>(reads) / elapsedSeconds;
+    metrics.writesPerSecond = static_cast<float>(writes) / elapsedSeconds;
+    metrics.maxPendingWriteBytes = maxPendingWriteBytes;
+    metrics.packetsDropped = packetsDropped;
+    metrics.slowClientsDisconnected = slowClientsDisconnected;
+
+    packetsIn = 0;
+    bytesIn = 0;
+    packetsOut = 0;
+    bytesOut = 0;
+    reads = 0;
+    writes = 0;
+    maxPendingWriteBytes = 0;
+    packetsDropped = 0;
+    slowClientsDisconnected = 0;
+
+    return metrics;
+}
+
+}  // namespace Rival
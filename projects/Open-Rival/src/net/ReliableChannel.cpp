@@ -0,0 +1,212 @@
+#include "pch.h"
+
+#include "net/ReliableChannel.h"
+
+#include <algorithm>  // std::clamp, std::min
+#include <stdexcept>
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+/** Determines if message ID `a` comes before `b`, allowing for wraparound. */
+static bool isBefore(std::uint32_t a, std::uint32_t b)
+{
+    return static_cast<std::int32_t>(a - b) < 0;
+}
+
+void ReliableChannel::queueMessage(const char* data, std::size_t size)
+{
+    std::size_t offset = 0;
+    while (offset < size)
+    {
+        const std::size_t messageSize = std::min(size - offset, maxMessageSize);
+        Message& message = unackedMessages.emplace_back();
+        message.id = nextOutgoingId;
+        message.data.assign(data + offset, data + offset + messageSize);
+        unackedBytes += messageSize;
+        ++nextOutgoingId;
+        offset += messageSize;
+    }
+}
+
+bool ReliableChannel::writeDatagram(std::vector<char>& datagram, std::uint32_t now, bool keepAlive)
+{
+    if (!hasMessagesDue(now) && !ackOwed && !keepAlive)
+    {
+        return false;
+    }
+
+    datagram.clear();
+    datagram.reserve(maxDatagramSize);
+
+    BufferUtils::addToBuffer(datagram, nextIncomingId);
+
+    // Placeholder for the number of messages
+    const std::size_t numMessagesOffset = datagram.size();
+    BufferUtils::addToBuffer(datagram, std::uint8_t(0));
+
+    // Add every message that is due and fits, oldest first
+    std::uint8_t numMessages = 0;
+    for (Message& message : unackedMessages)
+    {
+        if (!isMessageDue(message, now))
+        {
+            continue;
+        }
+
+        if (datagram.size() + messageHeaderSize + message.data.size() > maxDatagramSize || numMessages == UINT8_MAX)
+        {
+            break;
+        }
+
+        BufferUtils::addToBuffer(datagram, message.id);
+        BufferUtils::addToBuffer(datagram, static_cast<std::uint16_t>(message.data.size()));
+        datagram.insert(datagram.cend(), message.data.cbegin(), message.data.cend());
+        ++numMessages;
+
+        if (message.numSends == 0)
+        {
+            message.firstSendTime = now;
+        }
+        message.lastSendTime = now;
+        ++message.numSends;
+    }
+    datagram[numMessagesOffset] = static_cast<char>(numMessages);
+
+    ackOwed = false;
+    return true;
+}
+
+/**
+ * Determines if a message should be included in the next datagram.
+ *
+ * New messages are repeated in a few consecutive datagrams; after that, a message is only resent if it has gone
+ * unacknowledged for longer than the retransmission timeout.
+ */
+bool ReliableChannel::isMessageDue(const Message& message, std::uint32_t now) const
+{
+    return message.numSends < redundantSends || now - message.lastSendTime >= resendTimeoutMs;
+}
+
+bool ReliableChannel::hasMessagesDue(std::uint32_t now) const
+{
+    for (const Message& message : unackedMessages)
+    {
+        if (isMessageDue(message, now))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReliableChannel::readDatagram(const char* data, std::size_t size, std::uint32_t now, std::vector<char>& received)
+{
+    std::size_t offset = 0;
+
+    std::uint32_t ack = 0;
+    BufferUtils::readFromBuffer(data, size, offset, ack);
+    acknowledge(ack, now);
+
+    std::uint8_t numMessages = 0;
+    BufferUtils::readFromBuffer(data, size, offset, numMessages);
+
+    for (int i = 0; i < numMessages; ++i)
+    {
+        std::uint32_t id = 0;
+        BufferUtils::readFromBuffer(data, size, offset, id);
+
+        std::uint16_t messageSize = 0;
+        BufferUtils::readFromBuffer(data, size, offset, messageSize);
+
+        if (offset + messageSize > size)
+        {
+            throw std::runtime_error("Trying to read past end of buffer");
+        }
+
+        receiveMessage(id, data + offset, messageSize, received);
+        offset += messageSize;
+    }
+}
+
+void ReliableChannel::acknowledge(std::uint32_t ack, std::uint32_t now)
+{
+    bool hasSample = false;
+    std::uint32_t rttMs = 0;
+
+    while (!unackedMessages.empty() && isBefore(unackedMessages.front().id, ack))
+    {
+        const Message& message = unackedMessages.front();
+
+        // Once a message has timed out and been resent, we cannot tell which copy is being acknowledged, so only the
+        // first few copies give a usable sample. The newest message gives the most up-to-date one.
+        if (message.numSends > 0 && message.numSends <= redundantSends)
+        {
+            hasSample = true;
+            rttMs = now - message.firstSendTime;
+        }
+
+        unackedBytes -= message.data.size();
+        unackedMessages.pop_front();
+    }
+
+    if (hasSample)
+    {
+        addRoundTripSample(rttMs);
+    }
+}
+
+/** Updates the retransmission timeout with a new round-trip time measurement, as per RFC 6298. */
+void ReliableChannel::addRoundTripSample(std::uint32_t rttMs)
+{
+    if (!hasRoundTripSample)
+    {
+        smoothedRttMs = rttMs;
+        rttDeviationMs = rttMs / 2;
+        hasRoundTripSample = true;
+    }
+    else
+    {
+        const std::uint32_t deviation = rttMs > smoothedRttMs ? rttMs - smoothedRttMs : smoothedRttMs - rttMs;
+        rttDeviationMs = (3 * rttDeviationMs + deviation) / 4;
+        smoothedRttMs = (7 * smoothedRttMs + rttMs) / 8;
+    }
+
+    resendTimeoutMs = std::clamp(smoothedRttMs + 4 * rttDeviationMs, minResendTimeoutMs, maxResendTimeoutMs);
+}
+
+void ReliableChannel::receiveMessage(std::uint32_t id, const char* data, std::size_t size, std::vector<char>& received)
+{
+    // Whatever we receive, the other side needs to hear about it (even duplicates, since this means our last
+    // acknowledgement was probably lost)
+    ackOwed = true;
+
+    if (isBefore(id, nextIncomingId) || id - nextIncomingId >= maxMessagesAhead)
+    {
+        // Already delivered, or too far ahead to be worth keeping
+        return;
+    }
+
+    if (id != nextIncomingId)
+    {
+        // There is a gap before this message; hold on to it until the gap is filled
+        outOfOrderMessages.try_emplace(id, data, data + size);
+        return;
+    }
+
+    received.insert(received.cend(), data, data + size);
+    ++nextIncomingId;
+
+    // Deliver any messages that were waiting for this one
+    auto it = outOfOrderMessages.find(nextIncomingId);
+    while (it != outOfOrderMessages.end())
+    {
+        received.insert(received.cend(), it->second.cbegin(), it->second.cend());
+        outOfOrderMessages.erase(it);
+        ++nextIncomingId;
+        it = outOfOrderMessages.find(nextIncomingId);
+    }
+}
+
+}  // namespace Rival
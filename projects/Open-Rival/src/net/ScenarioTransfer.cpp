@@ -0,0 +1,109 @@
+#include "pch.h"
+
+#include "net/ScenarioTransfer.h"
+
+#include <algorithm>  // std::max, std::min
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::move
+
+#include "net/Connection.h"
+#include "net/packets/ScenarioChunkPacket.h"
+#include "net/packets/TargetedPacket.h"
+#include "utils/ChecksumUtils.h"
+#include "utils/CompressionUtils.h"
+
+namespace Rival {
+
+ScenarioUpload::ScenarioUpload(int playerId, int clientId, std::shared_ptr<const std::vector<char>> compressedData)
+    : playerId(playerId)
+    , clientId(clientId)
+    , compressedData(std::move(compressedData))
+    , numChunks(getNumChunks(this->compressedData->size()))
+{
+}
+
+void ScenarioUpload::sendChunks(Connection& connection)
+{
+    if (!started)
+    {
+        return;
+    }
+
+    while (nextChunk < numChunks && nextChunk - chunksAcked < maxChunksInFlight)
+    {
+        const std::size_t start = nextChunk * ScenarioChunkPacket::maxDataSize;
+        const std::size_t end = std::min(start + ScenarioChunkPacket::maxDataSize, compressedData->size());
+        std::vector<char> data(compressedData->cbegin() + start, compressedData->cbegin() + end);
+
+        ScenarioChunkPacket packet(playerId, nextChunk, std::move(data));
+        connection.send(TargetedPacket(clientId, packet));
+        ++nextChunk;
+    }
+}
+
+void ScenarioUpload::onAckReceived(std::uint32_t chunksReceived)
+{
+    started = true;
+    chunksAcked = std::max(chunksAcked, std::min(chunksReceived, numChunks));
+
+    // A player who already has the scenario may acknowledge chunks we never sent
+    nextChunk = std::max(nextChunk, chunksAcked);
+}
+
+std::uint32_t ScenarioUpload::getNumChunks(std::size_t compressedSize)
+{
+    return static_cast<std::uint32_t>(
+            (compressedSize + ScenarioChunkPacket::maxDataSize - 1) / ScenarioChunkPacket::maxDataSize);
+}
+
+ScenarioDownload::ScenarioDownload(std::uint32_t scenarioSize, std::uint32_t compressedSize, std::uint32_t checksum)
+    : scenarioSize(scenarioSize)
+    , compressedSize(compressedSize)
+    , checksum(checksum)
+{
+    compressedData.reserve(compressedSize);
+}
+
+void ScenarioDownload::addChunk(std::uint32_t chunkIndex, const std::vector<char>& data)
+{
+    // Chunks are always delivered in order, so anything else means something has gone badly wrong
+    if (chunkIndex != chunksReceived)
+    {
+        throw std::runtime_error(
+                "Expected scenario chunk " + std::to_string(chunksReceived) + " but received "
+                + std::to_string(chunkIndex));
+    }
+
+    if (compressedData.size() + data.size() > compressedSize)
+    {
+        throw std::runtime_error("Received more scenario data than expected");
+    }
+
+    compressedData.insert(compressedData.cend(), data.cbegin(), data.cend());
+    ++chunksReceived;
+}
+
+std::vector<std::uint8_t> ScenarioDownload::extract() const
+{
+    if (!isComplete())
+    {
+        throw std::runtime_error("Scenario has not been fully received");
+    }
+
+    std::vector<std::uint8_t> scenario = CompressionUtils::decompress(compressedData, scenarioSize);
+    if (ChecksumUtils::crc32(scenario) != checksum)
+    {
+        throw std::runtime_error("Received scenario does not match the host's checksum");
+    }
+
+    return scenario;
+}
+
+bool ScenarioDownload::isValidFilename(const std::string& filename)
+{
+    return !filename.empty() && filename.find_first_of("/\\") == std::string::npos
+            && filename.find("..") == std::string::npos;
+}
+
+}  // namespace Rival
@@ -2,78 +2,634 @@
 
 #include "net/Server.h"
 
+#include <algorithm>
 #include <cstddef>  // std::size_t
+#include <exception>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <utility>  // std::make_pair, std::move
 
-#include "net/Socket.h"
+#include "net/Connection.h"
+#include "net/packets/JoinRoomPacket.h"
+#include "net/packets/RelayedPacket.h"
+#include "net/packets/TargetedPacket.h"
+#include "utils/BufferUtils.h"
+#include "TimeUtils.h"
 
 namespace Rival {
 
-Server::Server(std::uint16_t port, int maxClients)
-    : serverSocket(Socket::createServer(port))
-    , maxClients(maxClients)
+Server::Server(std::optional<std::uint16_t> port,
+               int maxClientsPerRoom,
+               int maxRooms,
+               SlowClientPolicy slowClientPolicy)
+    : maxClientsPerRoom(maxClientsPerRoom)
+    , maxRooms(maxRooms)
+    , slowClientPolicy(slowClientPolicy)
+    , roomMetrics(std::make_shared<const std::vector<RoomMetrics>>())
 {
+    if (port)
+    {
+        serverSocket = Socket::createServer(*port);
+        datagramSocket = Socket::createUdpServer(*port);
+
+        serverSocket.setNonBlocking();
+        poller.add(serverSocket, listenToken);
+        poller.add(datagramSocket, datagramToken);
+    }
+
+    receivedPacketData.reserve(Connection::maxBufferSize);
+    receivedDatagram.resize(ReliableChannel::maxDatagramSize);
 }
 
 Server::~Server()
 {
+    running = false;
+    if (eventLoopThread.joinable())
+    {
+        eventLoopThread.join();
+    }
+
     // Close connections
+    rooms.clear();
     for (auto& entry : connectedClients)
     {
-        entry.second->close();
+        RelayClient& client = *entry.second;
+        if (!client.isDatagramClient() && !client.isLoopbackClient())
+        {
+            poller.remove(client.getSocket());
+        }
     }
+    connectedClients.clear();
 
     // Kill server
-    serverSocket.close();
-    acceptThread.join();
+    if (datagramSocket.isOpen())
+    {
+        poller.remove(datagramSocket);
+        datagramSocket.close();
+    }
+    if (serverSocket.isOpen())
+    {
+        poller.remove(serverSocket);
+        serverSocket.close();
+    }
+}
+
+void Server::start()
+{
+    running = true;
+    lastMetricsTime = TimeUtils::getNetTimestamp();
+    eventLoopThread = std::thread(&Server::eventLoop, this);
+}
+
+std::shared_ptr<const std::vector<RoomMetrics>> Server::getRoomMetrics() const
+{
+    return std::atomic_load(&roomMetrics);
+}
+
+std::shared_ptr<LoopbackLink> Server::connectLoopback()
+{
+    auto link = std::make_shared<LoopbackLink>();
+
+    std::shared_ptr<LoopbackLink> pendingLink = link;
+    if (!pendingLoopbackLinks.tryPush(std::move(pendingLink)))
+    {
+        throw std::runtime_error("Too many loopback clients waiting to connect");
+    }
+
+    return link;
+}
+
+void Server::eventLoop()
+{
+    while (running)
+    {
+        poll(pollTimeoutMs);
+    }
+}
+
+void Server::poll(int maxWaitMs)
+{
+    // Wake up in time to resend any data that may have been lost, or to check on our loopback clients
+    int timeoutMs = maxWaitMs;
+    if (hasUnackedDatagrams)
+    {
+        timeoutMs = std::min(timeoutMs, static_cast<int>(RelayClient::resendIntervalMs));
+    }
+    if (!loopbackClientTokens.empty())
+    {
+        timeoutMs = std::min(timeoutMs, loopbackPollIntervalMs);
+    }
+
+    poller.wait(events, timeoutMs);
+
+    for (const SocketEvent& event : events)
+    {
+        if (event.token == listenToken)
+        {
+            acceptClients();
+            continue;
+        }
+
+        if (event.token == datagramToken)
+        {
+            receiveDatagrams();
+            continue;
+        }
+
+        auto iter = connectedClients.find(event.token);
+        if (iter == connectedClients.end())
+        {
+            continue;
+        }
+
+        RelayClient& client = *iter->second;
+        if (event.readable || event.closed)
+        {
+            receiveFromClient(client);
+        }
+        if (event.writable)
+        {
+            flushClient(client);
+        }
+    }
+
+    acceptLoopbackClients();
+    receiveFromLoopbackClients();
+    updateClients();
+    updateMetrics();
+}
+
+void Server::acceptClients()
+{
+    while (true)
+    {
+        Socket newPlayer = serverSocket.tryAccept();
+        if (!newPlayer.isOpen())
+        {
+            // No more pending connections
+            break;
+        }
+
+        if (!canAcceptClient())
+        {
+            // Server is full; the socket will be closed when it goes out of scope
+            std::cout << "Rejected connection to server; server is full\n";
+            continue;
+        }
+
+        const int token = nextToken;
+        ++nextToken;
+
+        newPlayer.setNonBlocking();
+        auto client = std::make_unique<RelayClient>(token, std::move(newPlayer));
+        poller.add(client->getSocket(), token);
+        connectedClients.insert(std::make_pair(token, std::move(client)));
+    }
+}
+
+void Server::acceptLoopbackClients()
+{
+    std::shared_ptr<LoopbackLink> link;
+    while (pendingLoopbackLinks.tryPop(link))
+    {
+        if (!canAcceptClient())
+        {
+            std::cout << "Rejected loopback client; server is full\n";
+            link->closed = true;
+            continue;
+        }
+
+        const int token = nextToken;
+        ++nextToken;
+
+        connectedClients.insert(std::make_pair(token, std::make_unique<RelayClient>(token, std::move(link))));
+        loopbackClientTokens.push_back(token);
+    }
+}
+
+bool Server::canAcceptClient() const
+{
+    const std::size_t maxConnections = static_cast<std::size_t>(maxRooms) * static_cast<std::size_t>(maxClientsPerRoom);
+    return connectedClients.size() < maxConnections;
+}
+
+void Server::receiveDatagrams()
+{
+    while (true)
+    {
+        SocketAddress address;
+        const int size = datagramSocket.tryReceiveFrom(receivedDatagram.data(), receivedDatagram.size(), address);
+        if (size <= 0)
+        {
+            // No more datagrams available
+            break;
+        }
+
+        RelayClient* client = findDatagramClient(address, static_cast<std::size_t>(size));
+        if (!client)
+        {
+            continue;
+        }
+
+        try
+        {
+            client->receiveDatagram(receivedDatagram.data(), static_cast<std::size_t>(size));
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Dropping client in room " << std::to_string(client->getRoomId()) << ": " << e.what() << "\n";
+            client->disconnect();
+            continue;
+        }
+
+        handleReceivedPackets(*client, 1);
+    }
 }
 
-void Server::onPacketReceived(Connection& connection, std::shared_ptr<const Packet> packet)
+/**
+ * Determines if a datagram begins a new connection by asking to join a room.
+ *
+ * This reads the datagram in place so that stray datagrams can be discarded without allocating anything.
+ */
+static bool isJoinRoomDatagram(const char* data, std::size_t size)
 {
-    // Forward packets to all other connections
-    for (const auto& entry : connectedClients)
+    try
     {
-        const std::unique_ptr<Connection>& otherConnection = entry.second;
-        if (connection == *otherConnection)
+        std::size_t offset = 0;
+
+        std::uint32_t ack = 0;
+        BufferUtils::readFromBuffer(data, size, offset, ack);
+
+        std::uint8_t numMessages = 0;
+        BufferUtils::readFromBuffer(data, size, offset, numMessages);
+        if (numMessages == 0)
+        {
+            return false;
+        }
+
+        // The first message ever sent over a channel always has ID 0
+        std::uint32_t messageId = 0;
+        BufferUtils::readFromBuffer(data, size, offset, messageId);
+        if (messageId != 0)
+        {
+            return false;
+        }
+
+        std::uint16_t messageSize = 0;
+        BufferUtils::readFromBuffer(data, size, offset, messageSize);
+        if (offset + messageSize > size)
+        {
+            return false;
+        }
+
+        // The message must start with a complete JoinRoom packet
+        const char* message = data + offset;
+        std::size_t messageOffset = 0;
+        const std::size_t packetSize = Packet::readSize(message, messageSize, messageOffset);
+        if (packetSize != sizeof(PacketType) + sizeof(int) || messageOffset + packetSize > messageSize)
+        {
+            return false;
+        }
+
+        PacketType type = PacketType::Invalid;
+        BufferUtils::readFromBuffer(message, messageSize, messageOffset, type);
+        return type == PacketType::JoinRoom;
+    }
+    catch (const std::runtime_error&)
+    {
+        return false;
+    }
+}
+
+RelayClient* Server::findDatagramClient(const SocketAddress& address, std::size_t size)
+{
+    auto iter = datagramClientTokens.find(address);
+    if (iter != datagramClientTokens.end())
+    {
+        return connectedClients.at(iter->second).get();
+    }
+
+    // Datagram clients connect implicitly by sending their first datagram, which must contain a request to join a
+    // room. Anything else from an unknown address is dropped before we commit any resources to it.
+    if (!isJoinRoomDatagram(receivedDatagram.data(), size))
+    {
+        return nullptr;
+    }
+
+    if (!canAcceptClient())
+    {
+        std::cout << "Rejected datagram client; server is full\n";
+        return nullptr;
+    }
+
+    const int token = nextToken;
+    ++nextToken;
+
+    auto client = std::make_unique<RelayClient>(token, datagramSocket, address);
+    RelayClient* clientPtr = client.get();
+    connectedClients.insert(std::make_pair(token, std::move(client)));
+    datagramClientTokens.insert(std::make_pair(address, token));
+    return clientPtr;
+}
+
+void Server::receiveFromClient(RelayClient& client)
+{
+    const int numReads = client.readFromSocket();
+    handleReceivedPackets(client, numReads);
+}
+
+void Server::receiveFromLoopbackClients()
+{
+    // Loopback clients have no socket to report when data is waiting, so we check them all every time
+    for (int token : loopbackClientTokens)
+    {
+        RelayClient& client = *connectedClients.at(token);
+        handleReceivedPackets(client, client.readFromLoopback());
+    }
+}
+
+void Server::handleReceivedPackets(RelayClient& client, int numReads)
+{
+    try
+    {
+        while (!client.isConnectionLost() && client.nextPacket(receivedPacketData))
+        {
+            handlePacket(client, receivedPacketData);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // A misbehaving client should never bring down the server
+        std::cerr << "Dropping client in room " << std::to_string(client.getRoomId()) << ": " << e.what() << "\n";
+        client.disconnect();
+    }
+
+    if (client.isInRoom())
+    {
+        rooms.at(client.getRoomId()).onSocketOperations(numReads, 0);
+    }
+}
+
+void Server::flushClient(RelayClient& client)
+{
+    const int numWrites = client.flush();
+
+    if (client.isInRoom())
+    {
+        rooms.at(client.getRoomId()).onSocketOperations(0, numWrites);
+    }
+}
+
+void Server::handlePacket(RelayClient& client, const std::vector<char>& packetData)
+{
+    std::size_t offset = 0;
+    PacketType type = PacketType::Invalid;
+    BufferUtils::readFromBuffer(packetData, offset, type);
+
+    if (type == PacketType::JoinRoom)
+    {
+        if (client.isInRoom())
+        {
+            std::cerr << "Client " << std::to_string(client.getClientId()) << " in room "
+                      << std::to_string(client.getRoomId()) << " tried to change rooms\n";
+            return;
+        }
+
+        // Room requests are handled by the server and never relayed
+        if (!joinRoom(client, JoinRoomPacket::readRoomId(packetData)))
+        {
+            client.disconnect();
+        }
+        return;
+    }
+
+    if (!client.isInRoom() && !joinRoom(client, defaultRoomId))
+    {
+        client.disconnect();
+        return;
+    }
+
+    RelayRoom& room = rooms.at(client.getRoomId());
+    room.onPacketReceived(Packet::sizeBytes + packetData.size());
+
+    if (type == PacketType::Targeted)
+    {
+        // Only the wrapped packet is relayed, and only to its recipient
+        const int recipientId = TargetedPacket::readRecipientId(packetData);
+        relayPacket(client, room, TargetedPacket::readPacketData(packetData), recipientId);
+        return;
+    }
+
+    relayPacket(client, room, packetData);
+}
+
+bool Server::joinRoom(RelayClient& client, int roomId)
+{
+    if (roomId < 0)
+    {
+        std::cout << "Rejected request to join invalid room " << std::to_string(roomId) << "\n";
+        return false;
+    }
+
+    auto iter = rooms.find(roomId);
+    if (iter == rooms.end())
+    {
+        if (rooms.size() >= static_cast<std::size_t>(maxRooms))
+        {
+            std::cout << "Rejected request to create room " << std::to_string(roomId) << "; too many rooms\n";
+            return false;
+        }
+        iter = rooms.emplace(roomId, RelayRoom(roomId, maxClientsPerRoom)).first;
+    }
+
+    RelayRoom& room = iter->second;
+    if (room.isFull())
+    {
+        std::cout << "Rejected request to join room " << std::to_string(roomId) << "; room is full\n";
+        return false;
+    }
+
+    room.addClient(client);
+    std::cout << "Client " << std::to_string(client.getClientId()) << " connected to room "
+              << std::to_string(roomId) << "\n";
+    return true;
+}
+
+void Server::relayPacket(
+        RelayClient& sender,
+        RelayRoom& room,
+        const std::vector<char>& packetData,
+        std::optional<int> recipientId)
+{
+    RelayedPacket packet(packetData, sender.getClientId());
+    packet.setReceiveTime(TimeUtils::getNetTimestamp());
+
+    // Serialize the packet once, regardless of how many clients it is sent to.
+    // The serialized data is then shared by all recipients until they have all sent it.
+    auto buffer = std::make_shared<std::vector<char>>();
+    buffer->reserve(Connection::maxBufferSize);
+    packet.serialize(*buffer);
+    packet.finalize(*buffer);
+    std::shared_ptr<const std::vector<char>> relayBuffer = std::move(buffer);
+
+    if (packet.getType() == PacketType::Ping)
+    {
+        // Pings are returned straight to the sender so that clients can measure their round-trip time
+        sendToClient(sender, room, relayBuffer);
+        return;
+    }
+
+    // Forward packets to all other clients in the room, or just the recipient if there is one
+    for (RelayClient* otherClient : room.getClients())
+    {
+        if (otherClient == &sender)
         {
             // Don't send packets back to the sender
             continue;
         }
 
-        otherConnection->send(*packet);
+        if (recipientId && otherClient->getClientId() != *recipientId)
+        {
+            continue;
+        }
+
+        sendToClient(*otherClient, room, relayBuffer);
     }
 }
 
-void Server::start()
+/**
+ * Queues a packet to be sent to a client, unless the client has fallen too far behind.
+ */
+void Server::sendToClient(RelayClient& client, RelayRoom& room, const std::shared_ptr<const std::vector<char>>& data)
 {
-    acceptThread = std::thread(&Server::acceptThreadLoop, this);
+    if (client.isConnectionLost())
+    {
+        return;
+    }
+
+    if (client.getPendingWriteBytes() + data->size() > RelayClient::maxPendingWriteBytes)
+    {
+        if (slowClientPolicy == SlowClientPolicy::Disconnect)
+        {
+            std::cerr << "Dropping client " << std::to_string(client.getClientId()) << " in room "
+                      << std::to_string(room.getId()) << ": too far behind\n";
+            client.disconnect();
+            room.onSlowClientDisconnected();
+        }
+        else
+        {
+            room.onPacketDropped();
+        }
+        return;
+    }
+
+    client.queueSend(data);
+    room.onPacketSent(data->size());
 }
 
-void Server::acceptThreadLoop()
+void Server::updateClients()
 {
-    while (serverSocket.isOpen() && connectedClients.size() < static_cast<std::size_t>(maxClients))
+    const std::uint32_t now = TimeUtils::getNetTimestamp();
+    hasUnackedDatagrams = false;
+
+    for (auto iter = connectedClients.begin(); iter != connectedClients.end();)
     {
-        Socket newPlayer = serverSocket.accept();
-        if (newPlayer.isOpen())
+        RelayClient& client = *iter->second;
+
+        flushClient(client);
+
+        if (client.isInRoom())
+        {
+            rooms.at(client.getRoomId()).onPendingWrites(client.getPendingWriteBytes());
+        }
+
+        if (client.isDatagramClient() && now - client.getLastReceiveTime() > datagramTimeoutMs)
+        {
+            // There is no way to tell if a datagram client has gone away except by its silence
+            client.disconnect();
+        }
+
+        if (client.isConnectionLost())
+        {
+            if (client.isDatagramClient())
+            {
+                datagramClientTokens.erase(client.getAddress());
+            }
+            else if (client.isLoopbackClient())
+            {
+                loopbackClientTokens.erase(std::find(
+                        loopbackClientTokens.begin(), loopbackClientTokens.end(), client.getToken()));
+            }
+            else
+            {
+                poller.remove(client.getSocket());
+            }
+
+            if (client.isInRoom())
+            {
+                std::cout << "Client " << std::to_string(client.getClientId()) << " disconnected from room "
+                          << std::to_string(client.getRoomId()) << "\n";
+
+                auto roomIter = rooms.find(client.getRoomId());
+                roomIter->second.removeClient(client);
+                if (roomIter->second.isEmpty())
+                {
+                    rooms.erase(roomIter);
+                }
+            }
+
+            iter = connectedClients.erase(iter);
+            continue;
+        }
+
+        if (client.isDatagramClient())
+        {
+            // Datagrams are never held back waiting for the socket, but they may need to be resent
+            hasUnackedDatagrams = hasUnackedDatagrams || client.hasUnackedData();
+            ++iter;
+            continue;
+        }
+
+        if (client.isLoopbackClient())
         {
-            int clientId = requestClientId();
-            std::cout << "Client " << std::to_string(clientId) << " connected to server\n";
+            // Anything that did not fit in the link is simply passed on during the next iteration
+            ++iter;
+            continue;
+        }
 
-            auto newPlayerConnection = std::make_unique<Connection>(std::move(newPlayer), nullptr, clientId, this);
-            connectedClients.insert(std::make_pair(clientId, std::move(newPlayerConnection)));
+        // Only wait for the socket to become writable while we have data that it was not ready to accept
+        bool waitingToWrite = client.hasPendingWrites();
+        if (waitingToWrite != client.isWaitingToWrite())
+        {
+            poller.setWriteInterest(client.getSocket(), client.getToken(), waitingToWrite);
+            client.setWaitingToWrite(waitingToWrite);
         }
+
+        ++iter;
     }
 }
 
-int Server::requestClientId()
+void Server::updateMetrics()
 {
-    // The server just hands out client IDs incrementally.
-    // Note that these are NOT the same as player IDs - they are just a way to uniquely identify a connection.
-    // The server has no knowledge of player IDs since they are given out by the host inside of packets.
-    int clientId = nextClientId;
-    ++nextClientId;
-    return clientId;
+    const std::uint32_t now = TimeUtils::getNetTimestamp();
+    const std::uint32_t elapsed = now - lastMetricsTime;
+    if (elapsed < metricsIntervalMs)
+    {
+        return;
+    }
+    lastMetricsTime = now;
+
+    auto newMetrics = std::make_shared<std::vector<RoomMetrics>>();
+    newMetrics->reserve(rooms.size());
+    for (auto& entry : rooms)
+    {
+        newMetrics->push_back(entry.second.collectMetrics(elapsed));
+    }
+
+    // Publish the new snapshot; any readers still using the old one keep it alive until they are done
+    std::atomic_store(&roomMetrics, std::shared_ptr<const std::vector<RoomMetrics>>(std::move(newMetrics)));
 }
 
 }  // namespace Rival
@@ -13,11 +13,14 @@ namespace Rival {
 void GameCommandPacketHandler::onPacketReceived(std::shared_ptr<const Packet> packet, State& state)
 {
     std::shared_ptr<const GameCommandPacket> commandPacket = std::static_pointer_cast<const GameCommandPacket>(packet);
-    std::vector<std::shared_ptr<GameCommand>> commands = commandPacket->getCommands();
-    int tick = commandPacket->getTick();
+    const std::vector<std::shared_ptr<GameCommand>>& commands = commandPacket->getCommands();
 
     GameState& game = static_cast<GameState&>(state);
-    game.onClientReady(tick, commandPacket->getClientId());
+    const int tickDelta = commandPacket->getTickDelta();
+    const int tick = game.resolveReceivedTick(commandPacket->getClientId(), tickDelta);
+
+    // The sender has no commands for any of the ticks since its previous packet
+    game.onClientReady(tick - tickDelta + 1, tick, commandPacket->getClientId());
 
     for (auto& command : commands)
     {
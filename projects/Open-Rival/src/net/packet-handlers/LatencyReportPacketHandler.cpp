@@ -0,0 +1,19 @@
+#include "pch.h"
+
+#include "net/packet-handlers/LatencyReportPacketHandler.h"
+
+#include "net/packets/LatencyReportPacket.h"
+#include "GameState.h"
+
+namespace Rival {
+
+void LatencyReportPacketHandler::onPacketReceived(std::shared_ptr<const Packet> packet, State& state)
+{
+    std::shared_ptr<const LatencyReportPacket> reportPacket =
+            std::static_pointer_cast<const LatencyReportPacket>(packet);
+
+    GameState& game = static_cast<GameState&>(state);
+    game.onLatencyReportReceived(reportPacket->getClientId(), reportPacket->getRtt(), reportPacket->getJitter());
+}
+
+}  // namespace Rival
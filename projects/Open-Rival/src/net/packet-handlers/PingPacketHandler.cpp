@@ -0,0 +1,19 @@
+#include "pch.h"
+
+#include "net/packet-handlers/PingPacketHandler.h"
+
+#include "net/packets/PingPacket.h"
+#include "GameState.h"
+
+namespace Rival {
+
+void PingPacketHandler::onPacketReceived(std::shared_ptr<const Packet> packet, State& state)
+{
+    std::shared_ptr<const PingPacket> pingPacket = std::static_pointer_cast<const PingPacket>(packet);
+
+    // The relay server only ever returns our own pings to us
+    GameState& game = static_cast<GameState&>(state);
+    game.onPingReturned(pingPacket->getSendTime(), pingPacket->getReceiveTime());
+}
+
+}  // namespace Rival
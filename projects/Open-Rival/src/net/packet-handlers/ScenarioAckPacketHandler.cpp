@@ -0,0 +1,18 @@
+#include "pch.h"
+
+#include "net/packet-handlers/ScenarioAckPacketHandler.h"
+
+#include "lobby/LobbyState.h"
+#include "net/packets/ScenarioAckPacket.h"
+
+namespace Rival {
+
+void ScenarioAckPacketHandler::onPacketReceived(std::shared_ptr<const Packet> packet, State& state)
+{
+    std::shared_ptr<const ScenarioAckPacket> ackPacket = std::static_pointer_cast<const ScenarioAckPacket>(packet);
+
+    LobbyState& lobby = static_cast<LobbyState&>(state);
+    lobby.onScenarioAckReceived(ackPacket->getPlayerId(), ackPacket->getChunksReceived());
+}
+
+}  // namespace Rival
@@ -0,0 +1,19 @@
+#include "pch.h"
+
+#include "net/packet-handlers/ScenarioChunkPacketHandler.h"
+
+#include "lobby/LobbyState.h"
+#include "net/packets/ScenarioChunkPacket.h"
+
+namespace Rival {
+
+void ScenarioChunkPacketHandler::onPacketReceived(std::shared_ptr<const Packet> packet, State& state)
+{
+    std::shared_ptr<const ScenarioChunkPacket> chunkPacket =
+            std::static_pointer_cast<const ScenarioChunkPacket>(packet);
+
+    LobbyState& lobby = static_cast<LobbyState&>(state);
+    lobby.onScenarioChunkReceived(chunkPacket->getPlayerId(), chunkPacket->getChunkIndex(), chunkPacket->getData());
+}
+
+}  // namespace Rival
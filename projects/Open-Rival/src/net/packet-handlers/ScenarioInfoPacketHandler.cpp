@@ -0,0 +1,23 @@
+#include "pch.h"
+
+#include "net/packet-handlers/ScenarioInfoPacketHandler.h"
+
+#include "lobby/LobbyState.h"
+#include "net/packets/ScenarioInfoPacket.h"
+
+namespace Rival {
+
+void ScenarioInfoPacketHandler::onPacketReceived(std::shared_ptr<const Packet> packet, State& state)
+{
+    std::shared_ptr<const ScenarioInfoPacket> infoPacket = std::static_pointer_cast<const ScenarioInfoPacket>(packet);
+
+    LobbyState& lobby = static_cast<LobbyState&>(state);
+    lobby.onScenarioInfoReceived(
+            infoPacket->getPlayerId(),
+            infoPacket->getFilename(),
+            infoPacket->getScenarioSize(),
+            infoPacket->getCompressedSize(),
+            infoPacket->getChecksum());
+}
+
+}  // namespace Rival
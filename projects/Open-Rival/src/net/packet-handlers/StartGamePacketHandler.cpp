@@ -12,7 +12,7 @@ void StartGamePacketHandler::onPacketReceived(std::shared_ptr<const Packet> pack
     std::shared_ptr<const StartGamePacket> startGamePacket = std::static_pointer_cast<const StartGamePacket>(packet);
 
     LobbyState& lobby = static_cast<LobbyState&>(state);
-    lobby.startGame();
+    lobby.onStartGameReceived(startGamePacket->isRollbackEnabled());
 }
 
 }  // namespace Rival
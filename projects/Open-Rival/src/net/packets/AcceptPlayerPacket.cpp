@@ -27,17 +27,17 @@ void AcceptPlayerPacket::serialize(std::vector<char>& buffer) const
     BufferUtils::addToBuffer(buffer, playerId);
 }
 
-std::shared_ptr<AcceptPlayerPacket> AcceptPlayerPacket::deserialize(const std::vector<char> buffer)
+std::shared_ptr<AcceptPlayerPacket> AcceptPlayerPacket::deserialize(const char* buffer, std::size_t bufferSize)
 {
     std::size_t offset = relayedPacketHeaderSize;
 
     int requestId = 0;
-    BufferUtils::readFromBuffer(buffer, offset, requestId);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, requestId);
 
-    std::string playerName = BufferUtils::readStringFromBuffer(buffer, offset);
+    std::string playerName = BufferUtils::readStringFromBuffer(buffer, bufferSize, offset);
 
     int playerId = 0;
-    BufferUtils::readFromBuffer(buffer, offset, playerId);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, playerId);
 
     return std::make_shared<AcceptPlayerPacket>(requestId, playerName, playerId);
 }
@@ -12,19 +12,32 @@
 
 namespace Rival {
 
-GameCommandPacket::GameCommandPacket(std::vector<std::shared_ptr<GameCommand>> commands, int tick)
+GameCommandPacket::GameCommandPacket(std::vector<std::shared_ptr<GameCommand>> commands, int tick, int previousTick)
     : Packet(PacketType::GameCommand)
     , commands(commands)
-    , tick(tick)
+    , tickDelta(tick - previousTick)
 {
 }
 
+GameCommandPacket::GameCommandPacket()
+    : Packet(PacketType::GameCommand)
+    , tickDelta(0)
+{
+}
+
+void GameCommandPacket::reset()
+{
+    // Release the commands, but keep the capacity for next time
+    commands.clear();
+    tickDelta = 0;
+}
+
 void GameCommandPacket::serialize(std::vector<char>& buffer) const
 {
     Packet::serialize(buffer);
 
     BufferUtils::addToBuffer(buffer, static_cast<std::uint8_t>(commands.size()));
-    BufferUtils::addToBuffer(buffer, tick);
+    BufferUtils::addVarIntToBuffer(buffer, tickDelta);
 
     for (auto& command : commands)
     {
@@ -33,24 +46,25 @@ void GameCommandPacket::serialize(std::vector<char>& buffer) const
 }
 
 std::shared_ptr<GameCommandPacket>
-GameCommandPacket::deserialize(const std::vector<char> buffer, const GameCommandFactory& commandFactory)
+GameCommandPacket::deserialize(const char* buffer, std::size_t bufferSize, const GameCommandFactory& commandFactory)
 {
     std::size_t offset = relayedPacketHeaderSize;
 
     std::uint8_t numCommands = 0;
-    BufferUtils::readFromBuffer(buffer, offset, numCommands);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, numCommands);
+
+    std::shared_ptr<GameCommandPacket> packet = ObjectPool<GameCommandPacket>::acquire();
 
-    int tick = 0;
-    BufferUtils::readFromBuffer(buffer, offset, tick);
+    // We only know the tick relative to the previous packet
+    packet->tickDelta = BufferUtils::readVarIntFromBuffer(buffer, bufferSize, offset);
 
-    std::vector<std::shared_ptr<GameCommand>> commands;
     for (std::uint8_t i = 0; i < numCommands; ++i)
     {
-        auto command = commandFactory.deserialize(buffer, offset);
-        commands.push_back(command);
+        auto command = commandFactory.deserialize(buffer, bufferSize, offset);
+        packet->commands.push_back(command);
     }
 
-    return std::make_shared<GameCommandPacket>(commands, tick);
+    return packet;
 }
 
 }  // namespace Rival
@@ -0,0 +1,35 @@
+#include "pch.h"
+
+#include "net/packets/JoinRoomPacket.h"
+
+#include <cstddef>  // std::size_t
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+JoinRoomPacket::JoinRoomPacket(int roomId)
+    : Packet(PacketType::JoinRoom)
+    , roomId(roomId)
+{
+}
+
+void JoinRoomPacket::serialize(std::vector<char>& buffer) const
+{
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, roomId);
+}
+
+int JoinRoomPacket::readRoomId(const std::vector<char>& packetData)
+{
+    // This packet is never relayed, so there is no relay header; the room ID comes straight after the packet type
+    std::size_t offset = sizeof(PacketType);
+
+    int roomId = -1;
+    BufferUtils::readFromBuffer(packetData, offset, roomId);
+
+    return roomId;
+}
+
+}  // namespace Rival
@@ -24,12 +24,12 @@ void KickPlayerPacket::serialize(std::vector<char>& buffer) const
     BufferUtils::addToBuffer(buffer, playerId);
 }
 
-std::shared_ptr<KickPlayerPacket> KickPlayerPacket::deserialize(const std::vector<char> buffer)
+std::shared_ptr<KickPlayerPacket> KickPlayerPacket::deserialize(const char* buffer, std::size_t bufferSize)
 {
     std::size_t offset = relayedPacketHeaderSize;
 
     int playerId = 0;
-    BufferUtils::readFromBuffer(buffer, offset, playerId);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, playerId);
 
     return std::make_shared<KickPlayerPacket>(playerId);
 }
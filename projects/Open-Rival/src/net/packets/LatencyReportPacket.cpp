@@ -0,0 +1,39 @@
+#include "pch.h"
+
+#include "net/packets/LatencyReportPacket.h"
+
+#include <cstddef>  // std::size_t
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+LatencyReportPacket::LatencyReportPacket(std::uint32_t rttMs, std::uint32_t jitterMs)
+    : Packet(PacketType::LatencyReport)
+    , rttMs(rttMs)
+    , jitterMs(jitterMs)
+{
+}
+
+void LatencyReportPacket::serialize(std::vector<char>& buffer) const
+{
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, rttMs);
+    BufferUtils::addToBuffer(buffer, jitterMs);
+}
+
+std::shared_ptr<LatencyReportPacket> LatencyReportPacket::deserialize(const char* buffer, std::size_t bufferSize)
+{
+    std::size_t offset = relayedPacketHeaderSize;
+
+    std::uint32_t rttMs = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, rttMs);
+
+    std::uint32_t jitterMs = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, jitterMs);
+
+    return std::make_shared<LatencyReportPacket>(rttMs, jitterMs);
+}
+
+}  // namespace Rival
@@ -35,15 +35,15 @@ void LobbyWelcomePacket::serialize(std::vector<char>& buffer) const
     }
 }
 
-std::shared_ptr<LobbyWelcomePacket> LobbyWelcomePacket::deserialize(const std::vector<char> buffer)
+std::shared_ptr<LobbyWelcomePacket> LobbyWelcomePacket::deserialize(const char* buffer, std::size_t bufferSize)
 {
     std::size_t offset = relayedPacketHeaderSize;
 
     int playerId = 0;
-    BufferUtils::readFromBuffer(buffer, offset, playerId);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, playerId);
 
     size_t numClients = 0;
-    BufferUtils::readFromBuffer(buffer, offset, numClients);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, numClients);
 
     std::unordered_map<int, ClientInfo> clients;
     clients.reserve(numClients);
@@ -51,12 +51,12 @@ std::shared_ptr<LobbyWelcomePacket> LobbyWelcomePacket::deserialize(const std::v
     for (size_t i = 0; i < numClients; ++i)
     {
         int thisClientId = 0;
-        BufferUtils::readFromBuffer(buffer, offset, thisClientId);
+        BufferUtils::readFromBuffer(buffer, bufferSize, offset, thisClientId);
 
         int clientPlayerId = 0;
-        BufferUtils::readFromBuffer(buffer, offset, clientPlayerId);
+        BufferUtils::readFromBuffer(buffer, bufferSize, offset, clientPlayerId);
 
-        std::string name = BufferUtils::readStringFromBuffer(buffer, offset);
+        std::string name = BufferUtils::readStringFromBuffer(buffer, bufferSize, offset);
 
         ClientInfo client(playerId, name);
         clients.insert({ thisClientId, client });
@@ -2,6 +2,10 @@
 
 #include "net/packets/Packet.h"
 
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
 #include "utils/BufferUtils.h"
 
 namespace Rival {
@@ -13,15 +17,26 @@ Packet::Packet(PacketType type)
 
 void Packet::serialize(std::vector<char>& buffer) const
 {
-    BufferUtils::addToBuffer(buffer, 0);  // Placeholder for packet size
+    BufferUtils::addUint16ToBuffer(buffer, 0);  // Placeholder for packet size
     BufferUtils::addToBuffer(buffer, type);
 }
 
 void Packet::finalize(std::vector<char>& buffer) const
 {
-    // Overwrite the placeholder packet size in the buffer
-    int packetSize = static_cast<int>(buffer.size() - sizeof(packetSize));
-    std::memcpy(buffer.data(), &packetSize, sizeof(packetSize));
+    const std::size_t packetSize = buffer.size() - sizeBytes;
+    if (packetSize > UINT16_MAX)
+    {
+        throw std::runtime_error("Packet too large: " + std::to_string(packetSize));
+    }
+
+    // Overwrite the placeholder packet size in the buffer, in the same byte order as `addUint16ToBuffer`
+    buffer[0] = static_cast<char>(packetSize & 0xff);
+    buffer[1] = static_cast<char>(packetSize >> 8);
+}
+
+std::size_t Packet::readSize(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    return BufferUtils::readUint16FromBuffer(buffer, bufferSize, offset);
 }
 
 }  // namespace Rival
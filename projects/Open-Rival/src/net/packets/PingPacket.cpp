@@ -0,0 +1,34 @@
+#include "pch.h"
+
+#include "net/packets/PingPacket.h"
+
+#include <cstddef>  // std::size_t
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+PingPacket::PingPacket(std::uint32_t sendTime)
+    : Packet(PacketType::Ping)
+    , sendTime(sendTime)
+{
+}
+
+void PingPacket::serialize(std::vector<char>& buffer) const
+{
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, sendTime);
+}
+
+std::shared_ptr<PingPacket> PingPacket::deserialize(const char* buffer, std::size_t bufferSize)
+{
+    std::size_t offset = relayedPacketHeaderSize;
+
+    std::uint32_t sendTime = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, sendTime);
+
+    return std::make_shared<PingPacket>(sendTime);
+}
+
+}  // namespace Rival
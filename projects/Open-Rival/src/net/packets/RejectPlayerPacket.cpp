@@ -30,22 +30,22 @@ void RejectPlayerPacket::serialize(std::vector<char>& buffer) const
     }
 }
 
-std::shared_ptr<RejectPlayerPacket> RejectPlayerPacket::deserialize(const std::vector<char> buffer)
+std::shared_ptr<RejectPlayerPacket> RejectPlayerPacket::deserialize(const char* buffer, std::size_t bufferSize)
 {
     std::size_t offset = relayedPacketHeaderSize;
 
     int requestId = 0;
-    BufferUtils::readFromBuffer(buffer, offset, requestId);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, requestId);
 
     size_t playerNameSize = 0;
-    BufferUtils::readFromBuffer(buffer, offset, playerNameSize);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, playerNameSize);
 
     std::string playerName;
     playerName.reserve(playerNameSize);
     for (size_t i = 0; i < playerNameSize; ++i)
     {
         char c;
-        BufferUtils::readFromBuffer(buffer, offset, c);
+        BufferUtils::readFromBuffer(buffer, bufferSize, offset, c);
         playerName += c;
     }
 
@@ -2,6 +2,7 @@
 
 #include "net/packets/RelayedPacket.h"
 
+#include <cstddef>  // std::size_t
 #include <iostream>
 #include <stdexcept>
 
@@ -9,9 +10,18 @@
 
 namespace Rival {
 
+/** Reads the packet type from the start of some raw packet data. */
+static PacketType readPacketType(const std::vector<char>& buffer)
+{
+    std::size_t offset = 0;
+    PacketType type = PacketType::Invalid;
+    BufferUtils::readFromBuffer(buffer, offset, type);
+    return type;
+}
+
 RelayedPacket::RelayedPacket(const std::vector<char>& buffer, int clientId)
-    // The packet type is not important, since we don't serialize it
-    : Packet(PacketType::Invalid)
+    // The packet type is not serialized, but the server uses it to decide where to send the packet
+    : Packet(readPacketType(buffer))
     , packetData(buffer)  // Make a copy of the incoming buffer
 {
     setClientId(clientId);
@@ -19,19 +29,22 @@ RelayedPacket::RelayedPacket(const std::vector<char>& buffer, int clientId)
 
 void RelayedPacket::serialize(std::vector<char>& buffer) const
 {
-    // Make sure the buffer is big enough for us to inject the client ID
-    std::size_t packetSize = Packet::sizeBytes + sizeof(clientId) + packetData.size();
+    // Make sure the buffer is big enough for us to inject the client ID and relay time
+    std::size_t packetSize = Packet::sizeBytes + sizeof(clientId) + sizeof(receiveTime) + packetData.size();
     if (packetSize > buffer.capacity())
     {
         throw std::runtime_error("No room in packet for client ID");
     }
 
     // Placeholder for packet size
-    BufferUtils::addToBuffer(buffer, 0);
+    BufferUtils::addUint16ToBuffer(buffer, 0);
 
     // We inject the client ID before the packet data so clients can know who sent it
     BufferUtils::addToBuffer(buffer, clientId);
 
+    // We also inject the time at which we received the packet, so clients can measure the jitter between us and them
+    BufferUtils::addToBuffer(buffer, receiveTime);
+
     // Fill buffer with packetData
     buffer.insert(std::end(buffer), std::cbegin(packetData), std::cend(packetData));
 }
@@ -25,14 +25,14 @@ void RequestJoinPacket::serialize(std::vector<char>& buffer) const
     BufferUtils::addStringToBuffer(buffer, playerName);
 }
 
-std::shared_ptr<RequestJoinPacket> RequestJoinPacket::deserialize(const std::vector<char> buffer)
+std::shared_ptr<RequestJoinPacket> RequestJoinPacket::deserialize(const char* buffer, std::size_t bufferSize)
 {
     std::size_t offset = relayedPacketHeaderSize;
 
     int requestId = 0;
-    BufferUtils::readFromBuffer(buffer, offset, requestId);
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, requestId);
 
-    std::string playerName = BufferUtils::readStringFromBuffer(buffer, offset);
+    std::string playerName = BufferUtils::readStringFromBuffer(buffer, bufferSize, offset);
 
     return std::make_shared<RequestJoinPacket>(requestId, playerName);
 }
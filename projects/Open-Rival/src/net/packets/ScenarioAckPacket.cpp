@@ -0,0 +1,37 @@
+#include "pch.h"
+
+#include "net/packets/ScenarioAckPacket.h"
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+ScenarioAckPacket::ScenarioAckPacket(int playerId, std::uint32_t chunksReceived)
+    : Packet(PacketType::ScenarioAck)
+    , playerId(playerId)
+    , chunksReceived(chunksReceived)
+{
+}
+
+void ScenarioAckPacket::serialize(std::vector<char>& buffer) const
+{
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, playerId);
+    BufferUtils::addToBuffer(buffer, chunksReceived);
+}
+
+std::shared_ptr<ScenarioAckPacket> ScenarioAckPacket::deserialize(const char* buffer, std::size_t bufferSize)
+{
+    std::size_t offset = relayedPacketHeaderSize;
+
+    int playerId = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, playerId);
+
+    std::uint32_t chunksReceived = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, chunksReceived);
+
+    return std::make_shared<ScenarioAckPacket>(playerId, chunksReceived);
+}
+
+}  // namespace Rival
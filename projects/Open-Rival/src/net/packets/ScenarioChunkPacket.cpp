@@ -0,0 +1,61 @@
+#include "pch.h"
+
+#include "net/packets/ScenarioChunkPacket.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::move
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+ScenarioChunkPacket::ScenarioChunkPacket(int playerId, std::uint32_t chunkIndex, std::vector<char> data)
+    : Packet(PacketType::ScenarioChunk)
+    , playerId(playerId)
+    , chunkIndex(chunkIndex)
+    , data(std::move(data))
+{
+}
+
+void ScenarioChunkPacket::serialize(std::vector<char>& buffer) const
+{
+    if (data.size() > maxDataSize)
+    {
+        throw std::runtime_error("Scenario chunk too large: " + std::to_string(data.size()));
+    }
+
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, playerId);
+    BufferUtils::addToBuffer(buffer, chunkIndex);
+    BufferUtils::addUint16ToBuffer(buffer, static_cast<std::uint16_t>(data.size()));
+
+    if (buffer.size() + data.size() > buffer.capacity())
+    {
+        throw std::runtime_error("Trying to overfill buffer");
+    }
+    buffer.insert(buffer.cend(), data.cbegin(), data.cend());
+}
+
+std::shared_ptr<ScenarioChunkPacket> ScenarioChunkPacket::deserialize(const char* buffer, std::size_t bufferSize)
+{
+    std::size_t offset = relayedPacketHeaderSize;
+
+    int playerId = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, playerId);
+
+    std::uint32_t chunkIndex = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, chunkIndex);
+
+    const std::size_t dataSize = BufferUtils::readUint16FromBuffer(buffer, bufferSize, offset);
+    if (offset + dataSize > bufferSize)
+    {
+        throw std::runtime_error("Trying to read past end of buffer");
+    }
+    std::vector<char> data(buffer + offset, buffer + offset + dataSize);
+
+    return std::make_shared<ScenarioChunkPacket>(playerId, chunkIndex, std::move(data));
+}
+
+}  // namespace Rival
@@ -0,0 +1,58 @@
+#include "pch.h"
+
+#include "net/packets/ScenarioInfoPacket.h"
+
+#include <utility>  // std::move
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+ScenarioInfoPacket::ScenarioInfoPacket(
+        int playerId,
+        std::string filename,
+        std::uint32_t scenarioSize,
+        std::uint32_t compressedSize,
+        std::uint32_t checksum)
+    : Packet(PacketType::ScenarioInfo)
+    , playerId(playerId)
+    , filename(std::move(filename))
+    , scenarioSize(scenarioSize)
+    , compressedSize(compressedSize)
+    , checksum(checksum)
+{
+}
+
+void ScenarioInfoPacket::serialize(std::vector<char>& buffer) const
+{
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, playerId);
+    BufferUtils::addStringToBuffer(buffer, filename);
+    BufferUtils::addToBuffer(buffer, scenarioSize);
+    BufferUtils::addToBuffer(buffer, compressedSize);
+    BufferUtils::addToBuffer(buffer, checksum);
+}
+
+std::shared_ptr<ScenarioInfoPacket> ScenarioInfoPacket::deserialize(const char* buffer, std::size_t bufferSize)
+{
+    std::size_t offset = relayedPacketHeaderSize;
+
+    int playerId = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, playerId);
+
+    std::string filename = BufferUtils::readStringFromBuffer(buffer, bufferSize, offset);
+
+    std::uint32_t scenarioSize = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, scenarioSize);
+
+    std::uint32_t compressedSize = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, compressedSize);
+
+    std::uint32_t checksum = 0;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, checksum);
+
+    return std::make_shared<ScenarioInfoPacket>(playerId, filename, scenarioSize, compressedSize, checksum);
+}
+
+}  // namespace Rival
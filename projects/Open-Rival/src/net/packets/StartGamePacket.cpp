@@ -9,14 +9,27 @@
 
 namespace Rival {
 
-StartGamePacket::StartGamePacket()
+StartGamePacket::StartGamePacket(bool rollback)
     : Packet(PacketType::StartGame)
+    , rollback(rollback)
 {
 }
 
-std::shared_ptr<StartGamePacket> StartGamePacket::deserialize(const std::vector<char> buffer)
+void StartGamePacket::serialize(std::vector<char>& buffer) const
 {
-    return std::make_shared<StartGamePacket>();
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, rollback);
+}
+
+std::shared_ptr<StartGamePacket> StartGamePacket::deserialize(const char* buffer, std::size_t bufferSize)
+{
+    std::size_t offset = relayedPacketHeaderSize;
+
+    bool rollback = false;
+    BufferUtils::readFromBuffer(buffer, bufferSize, offset, rollback);
+
+    return std::make_shared<StartGamePacket>(rollback);
 }
 
 }  // namespace Rival
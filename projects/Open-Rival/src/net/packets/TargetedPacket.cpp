@@ -0,0 +1,52 @@
+#include "pch.h"
+
+#include "net/packets/TargetedPacket.h"
+
+#include <cstddef>  // std::size_t
+#include <stdexcept>
+
+#include "utils/BufferUtils.h"
+
+namespace Rival {
+
+TargetedPacket::TargetedPacket(int recipientId, const Packet& packet)
+    : Packet(PacketType::Targeted)
+    , recipientId(recipientId)
+    , packet(packet)
+{
+}
+
+void TargetedPacket::serialize(std::vector<char>& buffer) const
+{
+    Packet::serialize(buffer);
+
+    BufferUtils::addToBuffer(buffer, recipientId);
+
+    // The wrapped packet takes up the rest of this packet, so it does not need a size of its own
+    const std::size_t packetStart = buffer.size();
+    packet.serialize(buffer);
+    buffer.erase(buffer.cbegin() + packetStart, buffer.cbegin() + packetStart + sizeBytes);
+}
+
+int TargetedPacket::readRecipientId(const std::vector<char>& packetData)
+{
+    // This packet is never relayed, so there is no relay header; the recipient comes straight after the packet type
+    std::size_t offset = sizeof(PacketType);
+
+    int recipientId = -1;
+    BufferUtils::readFromBuffer(packetData, offset, recipientId);
+
+    return recipientId;
+}
+
+std::vector<char> TargetedPacket::readPacketData(const std::vector<char>& packetData)
+{
+    if (packetData.size() <= packetDataOffset)
+    {
+        throw std::runtime_error("Targeted packet does not contain a packet");
+    }
+
+    return std::vector<char>(packetData.cbegin() + packetDataOffset, packetData.cend());
+}
+
+}  // namespace Rival
@@ -0,0 +1,65 @@
+#include "pch.h"
+
+#ifdef __linux__
+
+#include "utils/MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+namespace Rival {
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    struct stat fileInfo;
+    if (::fstat(fd, &fileInfo) == -1)
+    {
+        ::close(fd);
+        throw std::runtime_error("Failed to read file size: " + filename);
+    }
+    size = static_cast<std::size_t>(fileInfo.st_size);
+
+    if (size == 0)
+    {
+        // Empty files cannot be mapped
+        ::close(fd);
+        return;
+    }
+
+    void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping remains valid after the file is closed
+    ::close(fd);
+
+    if (view == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+
+    // We expect to read the file from start to finish
+    ::madvise(view, size, MADV_SEQUENTIAL);
+
+    data = static_cast<const char*>(view);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+    {
+        ::munmap(const_cast<char*>(data), size);
+    }
+}
+
+}  // namespace Rival
+
+#endif
@@ -0,0 +1,23 @@
+#include "pch.h"
+
+#ifdef __linux__
+
+// These comments...
+#include "net/NetUtils.h"
+// ... prevent the auto-formatter from moving the include
+
+namespace Rival { namespace NetUtils {
+
+void initNetworking()
+{
+    // Nothing to do; sockets are always available on POSIX systems
+}
+
+void destroyNetworking()
+{
+    // Nothing to do
+}
+
+}}  // namespace Rival::NetUtils
+
+#endif
@@ -0,0 +1,583 @@
+#include "pch.h"
+
+#ifdef __linux__
+
+// These comments...
+#include "net/Socket.h"
+// ... prevent the auto-formatter from moving the include
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>  // std::min
+#include <array>
+#include <cassert>  // assert macro
+#include <cerrno>
+#include <cstring>  // std::memset
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>  // std::exchange
+
+namespace Rival {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Address Utilities
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// This is a std::unique_ptr to a `::addrinfo` that accepts a custom deletor, with the signature of `::freeaddrinfo`.
+// This allows us to create addrinfo instances that clean themselves up when they go out of scope.
+using addrInfoPtr = std::unique_ptr<::addrinfo, decltype(&::freeaddrinfo)>;
+
+static addrInfoPtr lookupAddress(char const* node, char const* service, int domain, int type, int protocol, int flags)
+{
+    assert(node || service);
+
+    auto hints = ::addrinfo();
+    std::memset(&hints, 0, sizeof(::addrinfo));
+    hints.ai_family = domain;
+    hints.ai_socktype = type;
+    hints.ai_protocol = protocol;
+    hints.ai_flags = flags;
+
+    ::addrinfo* out = nullptr;
+    auto const result = ::getaddrinfo(node, service, &hints, &out);
+
+    if (result != 0)
+    {
+        throw std::runtime_error("Failed to look up address: " + std::string(::gai_strerror(result)));
+    }
+
+    assert(out);
+
+    return addrInfoPtr(out, &::freeaddrinfo);
+}
+
+/** Gets the addrInfo for hosting a local server. */
+static addrInfoPtr getLocalAddressInfo(int domain, int type, int protocol, std::uint16_t port)
+{
+    auto const port_str = std::to_string(port);
+    int flags = AI_PASSIVE | AI_NUMERICSERV;
+    return lookupAddress(nullptr, port_str.data(), domain, type, protocol, flags);
+}
+
+/** Gets the addrInfo for connecting to a server. */
+static addrInfoPtr getAddressInfo(int domain, int type, int protocol, std::string const& node, std::uint16_t port)
+{
+    auto const port_str = std::to_string(port);
+    int flags = AI_NUMERICSERV;
+    return lookupAddress(node.data(), port_str.data(), domain, type, protocol, flags);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Readiness Utilities
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Determines if a failed call should simply be retried once the socket is ready. */
+static bool isWouldBlockError(int err)
+{
+    if (err == EAGAIN || err == EINTR)
+    {
+        return true;
+    }
+
+#if EAGAIN != EWOULDBLOCK
+    // These are the same on Linux, but POSIX allows them to differ
+    if (err == EWOULDBLOCK)
+    {
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+/**
+ * Waits until a socket is ready for the given events (POLLIN / POLLOUT).
+ *
+ * The handle is passed by reference so that we notice if it gets closed by another thread; we poll with a timeout in
+ * case that happens before the poll begins.
+ *
+ * Returns false if the socket was closed while waiting.
+ */
+static bool waitUntilReady(const SOCKET& handle, short events)
+{
+    static constexpr int pollTimeoutMs = 100;
+
+    while (handle != INVALID_SOCKET)
+    {
+        ::pollfd pollInfo {};
+        pollInfo.fd = handle;
+        pollInfo.events = events;
+
+        int result = ::poll(&pollInfo, 1, pollTimeoutMs);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+
+        if (result == 0)
+        {
+            // Timed out; check that the socket is still open and keep waiting
+            continue;
+        }
+
+        // Errors and hang-ups are reported by the subsequent call
+        return (pollInfo.revents & POLLNVAL) == 0;
+    }
+
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Factory Methods
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Socket Socket::createServer(std::uint16_t port)
+{
+    const auto domain = AF_INET;
+    const auto type = SOCK_STREAM;
+    const auto protocol = IPPROTO_TCP;
+    const auto addrInfo = getLocalAddressInfo(domain, type, protocol, port);
+
+    // Create
+    SOCKET handle = ::socket(domain, type, protocol);
+    if (handle == INVALID_SOCKET)
+    {
+        throw std::runtime_error("Failed to create socket: " + std::to_string(errno));
+    }
+
+    // Allow the server to be restarted straight away, without waiting for old connections to time out
+    int reuseAddr = 1;
+    ::setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, &reuseAddr, sizeof(reuseAddr));
+
+    // Bind
+    if (::bind(handle, addrInfo->ai_addr, addrInfo->ai_addrlen) != 0)
+    {
+        const auto err = errno;
+        ::close(handle);
+        throw std::runtime_error("Failed to bind socket: " + std::to_string(err));
+    }
+
+    // Listen
+    if (::listen(handle, SOMAXCONN) != 0)
+    {
+        const auto err = errno;
+        ::close(handle);
+        throw std::runtime_error("Failed to listen on socket: " + std::to_string(err));
+    }
+
+    return { handle };
+}
+
+Socket Socket::createClient(const std::string& address, std::uint16_t port)
+{
+    const auto domain = AF_INET;
+    const auto type = SOCK_STREAM;
+    const auto protocol = IPPROTO_TCP;
+    const auto addrInfo = getAddressInfo(domain, type, protocol, address, port);
+
+    // Create
+    SOCKET handle = ::socket(domain, type, protocol);
+    if (handle == INVALID_SOCKET)
+    {
+        throw std::runtime_error("Failed to create socket: " + std::to_string(errno));
+    }
+
+    // Connect.
+    // This happens before the socket is made non-blocking, so it simply waits for the connection to be established.
+    if (::connect(handle, addrInfo->ai_addr, addrInfo->ai_addrlen) != 0)
+    {
+        const auto err = errno;
+        ::close(handle);
+        throw std::runtime_error("Failed to connect to server: " + std::to_string(err));
+    }
+
+    return { handle };
+}
+
+Socket Socket::createUdpServer(std::uint16_t port)
+{
+    const auto domain = AF_INET;
+    const auto type = SOCK_DGRAM;
+    const auto protocol = IPPROTO_UDP;
+    const auto addrInfo = getLocalAddressInfo(domain, type, protocol, port);
+
+    // Create
+    SOCKET handle = ::socket(domain, type, protocol);
+    if (handle == INVALID_SOCKET)
+    {
+        throw std::runtime_error("Failed to create socket: " + std::to_string(errno));
+    }
+
+    // Bind
+    if (::bind(handle, addrInfo->ai_addr, addrInfo->ai_addrlen) != 0)
+    {
+        const auto err = errno;
+        ::close(handle);
+        throw std::runtime_error("Failed to bind socket: " + std::to_string(err));
+    }
+
+    return { handle };
+}
+
+Socket Socket::createUdpClient(const std::string& address, std::uint16_t port)
+{
+    const auto domain = AF_INET;
+    const auto type = SOCK_DGRAM;
+    const auto protocol = IPPROTO_UDP;
+    const auto addrInfo = getAddressInfo(domain, type, protocol, address, port);
+
+    // Create
+    SOCKET handle = ::socket(domain, type, protocol);
+    if (handle == INVALID_SOCKET)
+    {
+        throw std::runtime_error("Failed to create socket: " + std::to_string(errno));
+    }
+
+    // Connect; for a datagram socket this just sets the default destination and filters incoming datagrams
+    if (::connect(handle, addrInfo->ai_addr, addrInfo->ai_addrlen) != 0)
+    {
+        const auto err = errno;
+        ::close(handle);
+        throw std::runtime_error("Failed to connect to server: " + std::to_string(err));
+    }
+
+    return { handle };
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Socket Implementation
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Socket::Socket(Socket&& other) noexcept
+    // Move constructor: this object is being created to replace `other`.
+    // Just steal the socket from `other`.
+    : handle(std::exchange(other.handle, INVALID_SOCKET))
+{
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept
+{
+    if (this != &other)
+    {
+        // Move assignment: this object is being replaced by `other`.
+        // First close this socket, then steal the socket from `other`.
+        close();
+        handle = std::exchange(other.handle, INVALID_SOCKET);
+    }
+    return *this;
+}
+
+void Socket::init()
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    // Disable Nagle algorithm to ensure packets are not held up
+    int socketOptionValue = 1;
+    ::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &socketOptionValue, sizeof(socketOptionValue));
+
+    // All I/O waits for readiness using poll, rather than blocking inside the call itself
+    int flags = ::fcntl(handle, F_GETFL, 0);
+    if (flags == -1 || ::fcntl(handle, F_SETFL, flags | O_NONBLOCK) == -1)
+    {
+        std::cerr << "Failed to make socket non-blocking: " + std::to_string(errno) << "\n";
+    }
+}
+
+void Socket::setNonBlocking()
+{
+    // Nothing to do; our sockets are always non-blocking under the hood
+}
+
+void Socket::close() noexcept
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    // Closing a file descriptor does not wake up other threads waiting on it, but shutting it down does
+    SOCKET oldHandle = std::exchange(handle, INVALID_SOCKET);
+    ::shutdown(oldHandle, SHUT_RDWR);
+
+    if (::close(oldHandle) != 0)
+    {
+        std::cerr << "Failed to close socket: " + std::to_string(errno) << "\n";
+    }
+}
+
+Socket Socket::accept()
+{
+    while (isOpen())
+    {
+        SOCKET clientSocket = ::accept(handle, nullptr, nullptr);
+        if (clientSocket != INVALID_SOCKET)
+        {
+            return { clientSocket };
+        }
+
+        const int err = errno;
+        if (isWouldBlockError(err) || err == ECONNABORTED)
+        {
+            // No connection is pending yet, or the client gave up before we got to it
+            if (!waitUntilReady(handle, POLLIN))
+            {
+                break;
+            }
+            continue;
+        }
+
+        if (isOpen())
+        {
+            std::cerr << "Failed to accept client: " + std::to_string(err) << "\n";
+        }
+        break;
+    }
+
+    return {};
+}
+
+bool Socket::isOpen() const
+{
+    return handle != INVALID_SOCKET;
+}
+
+void Socket::send(const std::vector<char>& buffer)
+{
+    std::size_t bytesSent = 0;
+
+    while (bytesSent < buffer.size() && isOpen())
+    {
+        std::size_t bytesRemaining = buffer.size() - bytesSent;
+
+        // MSG_NOSIGNAL prevents the process from being killed by SIGPIPE if the other side has disconnected
+        ssize_t result = ::send(handle, buffer.data() + bytesSent, bytesRemaining, MSG_NOSIGNAL);
+
+        if (result < 0)
+        {
+            const int err = errno;
+            if (isWouldBlockError(err))
+            {
+                // The send buffer is full; wait until there is room
+                if (waitUntilReady(handle, POLLOUT))
+                {
+                    continue;
+                }
+            }
+            else if (isOpen())
+            {
+                // Socket is still open on our side but may have been closed by the other side
+                std::cerr << "Failed to send on socket: " + std::to_string(err) << "\n";
+            }
+            close();
+            break;
+        }
+
+        bytesSent += static_cast<std::size_t>(result);
+    }
+}
+
+void Socket::receive(std::vector<char>& buffer)
+{
+    std::size_t bytesReceived = 0;
+
+    while (bytesReceived < buffer.size() && isOpen())
+    {
+        std::size_t bytesExpected = buffer.size() - bytesReceived;
+        ssize_t result = ::recv(handle, buffer.data() + bytesReceived, bytesExpected, 0);
+
+        if (result < 0)
+        {
+            const int err = errno;
+            if (isWouldBlockError(err))
+            {
+                // Nothing to read yet; wait until data arrives
+                if (waitUntilReady(handle, POLLIN))
+                {
+                    continue;
+                }
+            }
+            else if (isOpen())
+            {
+                // Socket is still open on our side but may have been closed by the other side
+                std::cerr << "Failed to read from socket: " + std::to_string(err) << "\n";
+            }
+            close();
+            break;
+        }
+
+        if (result == 0)
+        {
+            // Connection has been gracefully closed
+            close();
+            break;
+        }
+
+        bytesReceived += static_cast<std::size_t>(result);
+    }
+}
+
+Socket Socket::tryAccept()
+{
+    SOCKET clientSocket = ::accept(handle, nullptr, nullptr);
+    if (clientSocket != INVALID_SOCKET)
+    {
+        return { clientSocket };
+    }
+
+    const int err = errno;
+    if (!isWouldBlockError(err) && err != ECONNABORTED && isOpen())
+    {
+        std::cerr << "Failed to accept client: " + std::to_string(err) << "\n";
+    }
+
+    return {};
+}
+
+int Socket::trySend(const char* data, std::size_t size)
+{
+    ssize_t result = ::send(handle, data, size, MSG_NOSIGNAL);
+    if (result >= 0)
+    {
+        return static_cast<int>(result);
+    }
+
+    return isWouldBlockError(errno) ? 0 : -1;
+}
+
+int Socket::trySend(const SendBuffer* buffers, std::size_t numBuffers)
+{
+    numBuffers = std::min(numBuffers, maxSendBuffers);
+    std::array<::iovec, maxSendBuffers> iov;
+    for (std::size_t i = 0; i < numBuffers; ++i)
+    {
+        iov[i].iov_base = const_cast<char*>(buffers[i].data);
+        iov[i].iov_len = buffers[i].size;
+    }
+
+    ::msghdr message {};
+    message.msg_iov = iov.data();
+    message.msg_iovlen = numBuffers;
+
+    ssize_t result = ::sendmsg(handle, &message, MSG_NOSIGNAL);
+    if (result >= 0)
+    {
+        return static_cast<int>(result);
+    }
+
+    return isWouldBlockError(errno) ? 0 : -1;
+}
+
+int Socket::tryReceive(char* data, std::size_t size)
+{
+    ssize_t result = ::recv(handle, data, size, 0);
+    if (result > 0)
+    {
+        return static_cast<int>(result);
+    }
+
+    if (result == 0)
+    {
+        // Connection has been gracefully closed
+        return -1;
+    }
+
+    return isWouldBlockError(errno) ? 0 : -1;
+}
+
+bool Socket::trySendTo(const char* data, std::size_t size, const SocketAddress& address)
+{
+    ::sockaddr_in destination {};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = address.host;
+    destination.sin_port = address.port;
+
+    ssize_t result = ::sendto(handle,
+                              data,
+                              size,
+                              MSG_NOSIGNAL,
+                              reinterpret_cast<const ::sockaddr*>(&destination),
+                              sizeof(destination));
+    return result >= 0;
+}
+
+int Socket::tryReceiveFrom(char* data, std::size_t size, SocketAddress& address)
+{
+    ::sockaddr_in source {};
+    ::socklen_t sourceLength = sizeof(source);
+
+    ssize_t result = ::recvfrom(handle, data, size, 0, reinterpret_cast<::sockaddr*>(&source), &sourceLength);
+    if (result >= 0)
+    {
+        address.host = source.sin_addr.s_addr;
+        address.port = source.sin_port;
+        return static_cast<int>(result);
+    }
+
+    // A refused connection just means that a datagram we sent earlier could not be delivered
+    const int err = errno;
+    return isWouldBlockError(err) || err == ECONNREFUSED ? 0 : -1;
+}
+
+int Socket::receiveDatagram(char* data, std::size_t size, int timeoutMs)
+{
+    while (isOpen())
+    {
+        ssize_t result = ::recv(handle, data, size, 0);
+        if (result >= 0)
+        {
+            return static_cast<int>(result);
+        }
+
+        const int err = errno;
+        if (err == ECONNREFUSED)
+        {
+            // A datagram we sent earlier could not be delivered; this says nothing about incoming datagrams
+            continue;
+        }
+
+        if (!isWouldBlockError(err))
+        {
+            if (isOpen())
+            {
+                std::cerr << "Failed to read from socket: " + std::to_string(err) << "\n";
+            }
+            return -1;
+        }
+
+        // Wait for a datagram to arrive
+        ::pollfd pollInfo {};
+        pollInfo.fd = handle;
+        pollInfo.events = POLLIN;
+
+        int pollResult = ::poll(&pollInfo, 1, timeoutMs);
+        if (pollResult == 0)
+        {
+            return 0;
+        }
+        if ((pollResult < 0 && errno != EINTR) || (pollInfo.revents & POLLNVAL) != 0)
+        {
+            return -1;
+        }
+    }
+
+    return -1;
+}
+
+}  // namespace Rival
+
+#endif
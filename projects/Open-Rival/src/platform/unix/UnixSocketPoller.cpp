@@ -0,0 +1,100 @@
+#include "pch.h"
+
+#ifdef __linux__
+
+// These comments...
+#include "net/SocketPoller.h"
+// ... prevent the auto-formatter from moving the include
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace Rival {
+
+/** Maximum number of events retrieved by a single call to `wait`. Any others are returned by the next call. */
+static constexpr int maxEventsPerWait = 64;
+
+/** Registers a socket with an epoll instance, or modifies an existing registration. */
+static void updateEpoll(int epollHandle, int operation, SOCKET handle, int token, bool writeInterest)
+{
+    ::epoll_event event {};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    if (writeInterest)
+    {
+        event.events |= EPOLLOUT;
+    }
+    event.data.u32 = static_cast<std::uint32_t>(token);
+
+    if (::epoll_ctl(epollHandle, operation, handle, &event) != 0)
+    {
+        throw std::runtime_error("Failed to update epoll: " + std::to_string(errno));
+    }
+}
+
+SocketPoller::SocketPoller()
+    : epollHandle(::epoll_create1(EPOLL_CLOEXEC))
+{
+    if (epollHandle < 0)
+    {
+        throw std::runtime_error("Failed to create epoll instance: " + std::to_string(errno));
+    }
+}
+
+SocketPoller::~SocketPoller()
+{
+    ::close(epollHandle);
+}
+
+void SocketPoller::add(const Socket& socket, int token)
+{
+    updateEpoll(epollHandle, EPOLL_CTL_ADD, socket.handle, token, false);
+}
+
+void SocketPoller::setWriteInterest(const Socket& socket, int token, bool interested)
+{
+    updateEpoll(epollHandle, EPOLL_CTL_MOD, socket.handle, token, interested);
+}
+
+void SocketPoller::remove(const Socket& socket)
+{
+    // Before Linux 2.6.9 this required a non-null event, even though it is ignored
+    ::epoll_event event {};
+    ::epoll_ctl(epollHandle, EPOLL_CTL_DEL, socket.handle, &event);
+}
+
+void SocketPoller::wait(std::vector<SocketEvent>& events, int timeoutMs)
+{
+    events.clear();
+
+    std::array<::epoll_event, maxEventsPerWait> epollEvents;
+    int numEvents = ::epoll_wait(epollHandle, epollEvents.data(), maxEventsPerWait, timeoutMs);
+    if (numEvents < 0)
+    {
+        if (errno == EINTR)
+        {
+            // Interrupted by a signal; the caller will try again
+            return;
+        }
+        throw std::runtime_error("Failed to wait for sockets: " + std::to_string(errno));
+    }
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(numEvents); ++i)
+    {
+        const ::epoll_event& epollEvent = epollEvents[i];
+        SocketEvent& event = events.emplace_back();
+        event.token = static_cast<int>(epollEvent.data.u32);
+        event.readable = (epollEvent.events & EPOLLIN) != 0;
+        event.writable = (epollEvent.events & EPOLLOUT) != 0;
+        event.closed = (epollEvent.events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) != 0;
+    }
+}
+
+}  // namespace Rival
+
+#endif
@@ -14,7 +14,7 @@ PrecisionTimer::~PrecisionTimer() {}
 
 void PrecisionTimer::sleep(long ns)
 {
-    usleep(ns);
+    usleep(static_cast<useconds_t>(ns));
 }
 
 }}  // namespace Rival::TimeUtils
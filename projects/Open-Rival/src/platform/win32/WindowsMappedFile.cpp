@@ -0,0 +1,85 @@
+#include "pch.h"
+
+#ifdef _WIN32
+
+// These comments...
+#include "utils/MappedFile.h"
+// ... prevent the auto-formatter from moving the include
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+#include <stdexcept>
+
+namespace Rival {
+
+MappedFile::MappedFile(const std::string& filename)
+{
+    HANDLE file = ::CreateFileA(
+            filename.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Failed to open file: " + filename);
+    }
+
+    LARGE_INTEGER fileSize {};
+    if (!::GetFileSizeEx(file, &fileSize))
+    {
+        ::CloseHandle(file);
+        throw std::runtime_error("Failed to read file size: " + filename);
+    }
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    fileHandle = file;
+
+    if (size == 0)
+    {
+        // Empty files cannot be mapped
+        return;
+    }
+
+    HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        ::CloseHandle(file);
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+    mappingHandle = mapping;
+
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+        throw std::runtime_error("Failed to map file: " + filename);
+    }
+
+    data = static_cast<const char*>(view);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+    {
+        ::UnmapViewOfFile(data);
+    }
+    if (mappingHandle)
+    {
+        ::CloseHandle(mappingHandle);
+    }
+    if (fileHandle)
+    {
+        ::CloseHandle(fileHandle);
+    }
+}
+
+}  // namespace Rival
+
+#endif
@@ -8,8 +8,11 @@
 
 #include <winsock2.h>
 
+#include <mstcpip.h>  // SIO_UDP_CONNRESET
 #include <ws2tcpip.h>
 
+#include <algorithm>  // std::min
+#include <array>
 #include <cassert>  // assert macro
 #include <cstring>  // std::memset
 #include <iostream>
@@ -128,6 +131,76 @@ Socket Socket::createClient(const std::string& address, std::uint16_t port)
     return { handle };
 }
 
+Socket Socket::createUdpServer(std::uint16_t port)
+{
+    const auto domain = AF_INET;
+    const auto type = SOCK_DGRAM;
+    const auto protocol = IPPROTO_UDP;
+    auto const addrInfoPtr = getLocalAddressInfo(domain, type, protocol, port);
+
+    // Create
+    SOCKET handle = ::socket(domain, type, protocol);
+    if (handle == INVALID_SOCKET)
+    {
+        const auto err = ::WSAGetLastError();
+        throw std::runtime_error("Failed to create socket: " + std::to_string(err));
+    }
+
+    // Bind
+    const auto bindResult = ::bind(handle, addrInfoPtr->ai_addr, addrInfoPtr->ai_addrlen);
+    if (bindResult == SOCKET_ERROR)
+    {
+        const auto err = ::WSAGetLastError();
+        ::closesocket(handle);
+        throw std::runtime_error("Failed to bind socket: " + std::to_string(err));
+    }
+
+    // By default, Windows reports an error on the *next* receive if a datagram we sent could not be delivered, which
+    // would make one unreachable client interrupt the server's reads for everyone else
+    BOOL reportConnectionReset = FALSE;
+    DWORD bytesReturned = 0;
+    ::WSAIoctl(handle,
+               SIO_UDP_CONNRESET,
+               &reportConnectionReset,
+               sizeof(reportConnectionReset),
+               nullptr,
+               0,
+               &bytesReturned,
+               nullptr,
+               nullptr);
+
+    Socket socket(handle);
+    socket.setNonBlocking();
+    return socket;
+}
+
+Socket Socket::createUdpClient(const std::string& address, std::uint16_t port)
+{
+    const auto domain = AF_INET;
+    const auto type = SOCK_DGRAM;
+    const auto protocol = IPPROTO_UDP;
+    const auto addrInfoPtr = getAddressInfo(domain, type, protocol, address, port);
+
+    // Create
+    SOCKET handle = ::socket(domain, type, protocol);
+    if (handle == INVALID_SOCKET)
+    {
+        int err = ::WSAGetLastError();
+        throw std::runtime_error("Failed to create socket: " + std::to_string(err));
+    }
+
+    // Connect; for a datagram socket this just sets the default destination and filters incoming datagrams
+    const auto connectResult = ::connect(handle, addrInfoPtr->ai_addr, addrInfoPtr->ai_addrlen);
+    if (connectResult == SOCKET_ERROR)
+    {
+        const auto err = ::WSAGetLastError();
+        ::closesocket(handle);
+        throw std::runtime_error("Failed to connect to server: " + std::to_string(err));
+    }
+
+    return { handle };
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Socket Implementation
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -242,6 +315,171 @@ void Socket::receive(std::vector<char>& buffer)
     }
 }
 
+void Socket::setNonBlocking()
+{
+    u_long nonBlocking = 1;
+    if (::ioctlsocket(handle, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+    {
+        std::cerr << "Failed to make socket non-blocking: " + std::to_string(::WSAGetLastError()) << "\n";
+    }
+}
+
+Socket Socket::tryAccept()
+{
+    SOCKET clientSocket = ::accept(handle, nullptr, nullptr);
+    if (clientSocket != INVALID_SOCKET)
+    {
+        // Sockets accepted from a non-blocking socket are also non-blocking
+        return { clientSocket };
+    }
+
+    const int err = ::WSAGetLastError();
+    if (err != WSAEWOULDBLOCK && err != WSAECONNRESET && isOpen())
+    {
+        std::cerr << "Failed to accept client: " + std::to_string(err) << "\n";
+    }
+
+    return {};
+}
+
+int Socket::trySend(const char* data, std::size_t size)
+{
+    int result = ::send(handle, data, static_cast<int>(size), 0);
+    if (result != SOCKET_ERROR)
+    {
+        return result;
+    }
+
+    return ::WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+}
+
+int Socket::trySend(const SendBuffer* buffers, std::size_t numBuffers)
+{
+    numBuffers = std::min(numBuffers, maxSendBuffers);
+    std::array<WSABUF, maxSendBuffers> wsaBuffers;
+    for (std::size_t i = 0; i < numBuffers; ++i)
+    {
+        wsaBuffers[i].buf = const_cast<char*>(buffers[i].data);
+        wsaBuffers[i].len = static_cast<ULONG>(buffers[i].size);
+    }
+
+    DWORD bytesSent = 0;
+    int result = ::WSASend(handle, wsaBuffers.data(), static_cast<DWORD>(numBuffers), &bytesSent, 0, nullptr, nullptr);
+    if (result != SOCKET_ERROR)
+    {
+        return static_cast<int>(bytesSent);
+    }
+
+    return ::WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+}
+
+int Socket::tryReceive(char* data, std::size_t size)
+{
+    int result = ::recv(handle, data, static_cast<int>(size), 0);
+    if (result > 0)
+    {
+        return result;
+    }
+
+    if (result == 0)
+    {
+        // Connection has been gracefully closed
+        return -1;
+    }
+
+    return ::WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+}
+
+bool Socket::trySendTo(const char* data, std::size_t size, const SocketAddress& address)
+{
+    ::sockaddr_in destination {};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = address.host;
+    destination.sin_port = address.port;
+
+    int result = ::sendto(handle,
+                          data,
+                          static_cast<int>(size),
+                          0,
+                          reinterpret_cast<const ::sockaddr*>(&destination),
+                          sizeof(destination));
+    return result != SOCKET_ERROR;
+}
+
+int Socket::tryReceiveFrom(char* data, std::size_t size, SocketAddress& address)
+{
+    ::sockaddr_in source {};
+    int sourceLength = sizeof(source);
+
+    int result = ::recvfrom(
+            handle, data, static_cast<int>(size), 0, reinterpret_cast<::sockaddr*>(&source), &sourceLength);
+    if (result != SOCKET_ERROR)
+    {
+        address.host = source.sin_addr.s_addr;
+        address.port = source.sin_port;
+        return result;
+    }
+
+    const int err = ::WSAGetLastError();
+    if (err == WSAEMSGSIZE)
+    {
+        // Datagram was truncated
+        address.host = source.sin_addr.s_addr;
+        address.port = source.sin_port;
+        return static_cast<int>(size);
+    }
+
+    return err == WSAEWOULDBLOCK || err == WSAECONNRESET ? 0 : -1;
+}
+
+int Socket::receiveDatagram(char* data, std::size_t size, int timeoutMs)
+{
+    while (isOpen())
+    {
+        // Wait for a datagram to arrive
+        ::fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(handle, &readSet);
+        ::timeval timeout { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+
+        int selectResult = ::select(0, &readSet, nullptr, nullptr, &timeout);
+        if (selectResult == 0)
+        {
+            return 0;
+        }
+        if (selectResult == SOCKET_ERROR)
+        {
+            return -1;
+        }
+
+        int result = ::recv(handle, data, static_cast<int>(size), 0);
+        if (result != SOCKET_ERROR)
+        {
+            return result;
+        }
+
+        const int err = ::WSAGetLastError();
+        if (err == WSAEMSGSIZE)
+        {
+            // Datagram was truncated
+            return static_cast<int>(size);
+        }
+
+        if (err != WSAECONNRESET)
+        {
+            if (isOpen())
+            {
+                std::cerr << "Failed to read from socket: " + std::to_string(err) << "\n";
+            }
+            return -1;
+        }
+
+        // A datagram we sent earlier could not be delivered; this says nothing about incoming datagrams
+    }
+
+    return -1;
+}
+
 }  // namespace Rival
 
 #endif
@@ -0,0 +1,92 @@
+#include "pch.h"
+
+#ifdef _WIN32
+
+// These comments...
+#include "net/SocketPoller.h"
+// ... prevent the auto-formatter from moving the include
+
+#include <winsock2.h>
+
+#include <cstddef>  // std::size_t
+#include <stdexcept>
+#include <string>
+
+namespace Rival {
+
+/** Finds the index of a socket within a list of polled sockets. */
+static std::size_t findSocket(const std::vector<WSAPOLLFD>& pollFds, SOCKET handle)
+{
+    for (std::size_t i = 0; i < pollFds.size(); ++i)
+    {
+        if (pollFds[i].fd == handle)
+        {
+            return i;
+        }
+    }
+    throw std::runtime_error("Socket is not being polled");
+}
+
+SocketPoller::SocketPoller() {}
+
+SocketPoller::~SocketPoller() {}
+
+void SocketPoller::add(const Socket& socket, int token)
+{
+    WSAPOLLFD pollFd {};
+    pollFd.fd = socket.handle;
+    pollFd.events = POLLRDNORM;
+    pollFds.push_back(pollFd);
+    tokens.push_back(token);
+}
+
+void SocketPoller::setWriteInterest(const Socket& socket, int, bool interested)
+{
+    const std::size_t index = findSocket(pollFds, socket.handle);
+    pollFds[index].events = interested ? (POLLRDNORM | POLLWRNORM) : POLLRDNORM;
+}
+
+void SocketPoller::remove(const Socket& socket)
+{
+    const std::size_t index = findSocket(pollFds, socket.handle);
+    pollFds.erase(pollFds.begin() + index);
+    tokens.erase(tokens.begin() + index);
+}
+
+void SocketPoller::wait(std::vector<SocketEvent>& events, int timeoutMs)
+{
+    events.clear();
+
+    if (pollFds.empty())
+    {
+        // WSAPoll fails if there is nothing to poll
+        ::Sleep(timeoutMs);
+        return;
+    }
+
+    int result = ::WSAPoll(pollFds.data(), static_cast<ULONG>(pollFds.size()), timeoutMs);
+    if (result == SOCKET_ERROR)
+    {
+        throw std::runtime_error("Failed to wait for sockets: " + std::to_string(::WSAGetLastError()));
+    }
+
+    for (std::size_t i = 0; i < pollFds.size() && result > 0; ++i)
+    {
+        const SHORT revents = pollFds[i].revents;
+        if (revents == 0)
+        {
+            continue;
+        }
+
+        SocketEvent& event = events.emplace_back();
+        event.token = tokens[i];
+        event.readable = (revents & POLLRDNORM) != 0;
+        event.writable = (revents & POLLWRNORM) != 0;
+        event.closed = (revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+        --result;
+    }
+}
+
+}  // namespace Rival
+
+#endif
@@ -0,0 +1,86 @@
+#include "pch.h"
+
+#include "replay/ReplayReader.h"
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <cstring>  // std::memcmp
+#include <fstream>
+#include <iterator>  // std::istreambuf_iterator
+#include <stdexcept>
+
+#include "commands/GameCommandFactory.h"
+#include "replay/ReplayWriter.h"
+#include "utils/BufferUtils.h"
+#include "GameCommand.h"
+
+namespace Rival {
+
+ReplayReader::ReplayReader(const std::string& filename)
+{
+    std::ifstream is(filename, std::ios::binary);
+    if (!is.is_open())
+    {
+        throw std::runtime_error("Failed to open replay file: " + filename);
+    }
+
+    // Read the entire file to memory; replays are small
+    const std::vector<char> buffer((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    std::size_t offset = 0;
+
+    // Header
+    char magic[sizeof(ReplayWriter::magic)];
+    BufferUtils::readFromBuffer(buffer, offset, magic);
+    if (std::memcmp(magic, ReplayWriter::magic, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("Not a replay file: " + filename);
+    }
+
+    std::uint32_t version = 0;
+    BufferUtils::readFromBuffer(buffer, offset, version);
+    if (version != ReplayWriter::version)
+    {
+        throw std::runtime_error("Unsupported replay version: " + std::to_string(version));
+    }
+
+    // Scenario
+    std::uint32_t scenarioSize = 0;
+    BufferUtils::readFromBuffer(buffer, offset, scenarioSize);
+    if (offset + scenarioSize > buffer.size())
+    {
+        throw std::runtime_error("Replay file is truncated: " + filename);
+    }
+    scenarioData.assign(buffer.cbegin() + offset, buffer.cbegin() + offset + scenarioSize);
+    offset += scenarioSize;
+
+    // Commands
+    GameCommandFactory commandFactory;
+    while (offset < buffer.size())
+    {
+        ReplayTick replayTick;
+        BufferUtils::readFromBuffer(buffer, offset, replayTick.tick);
+
+        std::uint8_t numCommands = 0;
+        BufferUtils::readFromBuffer(buffer, offset, numCommands);
+
+        for (std::uint8_t i = 0; i < numCommands; ++i)
+        {
+            auto command = commandFactory.deserialize(buffer.data(), buffer.size(), offset);
+            if (!command)
+            {
+                // We can't know how much data to skip, so the rest of the file is unusable
+                throw std::runtime_error("Invalid command in replay for tick " + std::to_string(replayTick.tick));
+            }
+            replayTick.commands.push_back(command);
+        }
+
+        finalTick = replayTick.tick;
+
+        if (!replayTick.commands.empty())
+        {
+            ticks.push_back(replayTick);
+        }
+    }
+}
+
+}  // namespace Rival
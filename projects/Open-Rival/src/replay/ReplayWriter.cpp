@@ -0,0 +1,83 @@
+#include "pch.h"
+
+#include "replay/ReplayWriter.h"
+
+#include <stdexcept>
+
+#include "utils/BufferUtils.h"
+#include "GameCommand.h"
+
+namespace Rival {
+
+ReplayWriter::ReplayWriter(const std::string& filename, const std::vector<std::uint8_t>& scenarioData)
+    : os(filename, std::ios::binary | std::ios::trunc)
+{
+    if (!os.is_open())
+    {
+        throw std::runtime_error("Failed to open replay file for writing: " + filename);
+    }
+
+    recordBuffer.reserve(maxRecordSize);
+
+    // Header
+    os.write(magic, sizeof(magic));
+    os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+
+    // Scenario
+    std::uint32_t scenarioSize = static_cast<std::uint32_t>(scenarioData.size());
+    os.write(reinterpret_cast<const char*>(&scenarioSize), sizeof(scenarioSize));
+    os.write(reinterpret_cast<const char*>(scenarioData.data()), scenarioSize);
+}
+
+ReplayWriter::~ReplayWriter()
+{
+    if (os.is_open())
+    {
+        close(lastTick);
+    }
+}
+
+void ReplayWriter::recordCommands(int tick, const std::vector<std::shared_ptr<GameCommand>>& commands)
+{
+    if (commands.empty())
+    {
+        // Nothing to record; empty ticks are implied
+        return;
+    }
+
+    writeRecord(tick, commands);
+    lastTick = tick;
+}
+
+void ReplayWriter::close(int finalTick)
+{
+    if (!os.is_open())
+    {
+        return;
+    }
+
+    // An empty record marks the end of the game
+    writeRecord(finalTick, {});
+    os.close();
+}
+
+void ReplayWriter::writeRecord(int tick, const std::vector<std::shared_ptr<GameCommand>>& commands)
+{
+    if (commands.size() > UINT8_MAX)
+    {
+        throw std::runtime_error("Too many commands to record for tick " + std::to_string(tick));
+    }
+
+    BufferUtils::addToBuffer(recordBuffer, tick);
+    BufferUtils::addToBuffer(recordBuffer, static_cast<std::uint8_t>(commands.size()));
+    for (const auto& command : commands)
+    {
+        command->serialize(recordBuffer);
+    }
+
+    // The output stream is buffered, so this will not result in a write for every tick
+    os.write(recordBuffer.data(), recordBuffer.size());
+    recordBuffer.clear();
+}
+
+}  // namespace Rival
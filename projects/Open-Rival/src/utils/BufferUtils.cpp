@@ -2,10 +2,123 @@
 
 #include "utils/BufferUtils.h"
 
+#include <algorithm>  // std::max
 #include <iostream>
 
 namespace Rival { namespace BufferUtils {
 
+void reserveInBuffer(std::vector<char>& buffer, std::size_t numBytes)
+{
+    std::size_t requiredBufferSize = buffer.size() + numBytes;
+    if (requiredBufferSize <= buffer.capacity())
+    {
+        return;
+    }
+
+    // Grow geometrically to avoid reallocating for every value added
+    buffer.reserve(std::max(requiredBufferSize, buffer.capacity() * 2));
+}
+
+void addUint16ToBuffer(std::vector<char>& buffer, std::uint16_t val)
+{
+    if (buffer.size() + sizeof(val) > buffer.capacity())
+    {
+        throw std::runtime_error("Trying to overfill buffer");
+    }
+
+    buffer.push_back(static_cast<char>(val & 0xff));
+    buffer.push_back(static_cast<char>(val >> 8));
+}
+
+std::uint16_t readUint16FromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    if (offset + sizeof(std::uint16_t) > bufferSize)
+    {
+        throw std::runtime_error("Trying to read past end of buffer");
+    }
+
+    const auto low = static_cast<std::uint8_t>(buffer[offset]);
+    const auto high = static_cast<std::uint8_t>(buffer[offset + 1]);
+    offset += sizeof(std::uint16_t);
+
+    return static_cast<std::uint16_t>(low | (high << 8));
+}
+
+std::uint16_t readUint16FromBuffer(const std::vector<char>& buffer, std::size_t& offset)
+{
+    return readUint16FromBuffer(buffer.data(), buffer.size(), offset);
+}
+
+void addVarUintToBuffer(std::vector<char>& buffer, std::uint32_t val)
+{
+    // Work out the encoded size up-front so that we never write a partial value
+    std::size_t numBytes = 1;
+    for (std::uint32_t remaining = val >> 7; remaining != 0; remaining >>= 7)
+    {
+        ++numBytes;
+    }
+
+    if (buffer.size() + numBytes > buffer.capacity())
+    {
+        throw std::runtime_error("Trying to overfill buffer");
+    }
+
+    while (val >= 0x80)
+    {
+        buffer.push_back(static_cast<char>((val & 0x7f) | 0x80));
+        val >>= 7;
+    }
+    buffer.push_back(static_cast<char>(val));
+}
+
+std::uint32_t readVarUintFromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    std::uint32_t val = 0;
+
+    for (std::size_t i = 0; i < maxVarIntBytes; ++i)
+    {
+        if (offset >= bufferSize)
+        {
+            throw std::runtime_error("Trying to read past end of buffer");
+        }
+
+        const auto byte = static_cast<std::uint8_t>(buffer[offset]);
+        ++offset;
+
+        val |= static_cast<std::uint32_t>(byte & 0x7f) << (7 * i);
+        if ((byte & 0x80) == 0)
+        {
+            return val;
+        }
+    }
+
+    throw std::runtime_error("Invalid variable-length integer");
+}
+
+std::uint32_t readVarUintFromBuffer(const std::vector<char>& buffer, std::size_t& offset)
+{
+    return readVarUintFromBuffer(buffer.data(), buffer.size(), offset);
+}
+
+void addVarIntToBuffer(std::vector<char>& buffer, std::int32_t val)
+{
+    const auto bits = static_cast<std::uint32_t>(val);
+    const std::uint32_t zigzag = (bits << 1) ^ (val < 0 ? 0xffffffffu : 0u);
+    addVarUintToBuffer(buffer, zigzag);
+}
+
+std::int32_t readVarIntFromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset)
+{
+    const std::uint32_t zigzag = readVarUintFromBuffer(buffer, bufferSize, offset);
+    const std::uint32_t bits = (zigzag >> 1) ^ (0u - (zigzag & 1));
+    return static_cast<std::int32_t>(bits);
+}
+
+std::int32_t readVarIntFromBuffer(const std::vector<char>& buffer, std::size_t& offset)
+{
+    return readVarIntFromBuffer(buffer.data(), buffer.size(), offset);
+}
+
 void addStringToBuffer(std::vector<char>& buffer, const std::string& s)
 {
     std::size_t numChars = s.size();
@@ -33,11 +146,16 @@ void addStringToBuffer(std::vector<char>& buffer, const std::string& s)
 }
 
 std::string readStringFromBuffer(const std::vector<char>& buffer, std::size_t& offset)
+{
+    return readStringFromBuffer(buffer.data(), buffer.size(), offset);
+}
+
+std::string readStringFromBuffer(const char* buffer, std::size_t bufferSize, std::size_t& offset)
 {
     std::size_t strLength = 0;
-    readFromBuffer(buffer, offset, strLength);
+    readFromBuffer(buffer, bufferSize, offset, strLength);
 
-    if (offset + strLength * sizeof(char) > buffer.size())
+    if (offset + strLength * sizeof(char) > bufferSize)
     {
         throw std::runtime_error("Trying to read past end of buffer");
     }
@@ -48,7 +166,7 @@ std::string readStringFromBuffer(const std::vector<char>& buffer, std::size_t& o
     for (size_t i = 0; i < strLength; ++i)
     {
         char c;
-        std::memcpy(&c, buffer.data() + offset, sizeof(c));
+        std::memcpy(&c, buffer + offset, sizeof(c));
         offset += sizeof(c);
         s += c;
     }
@@ -0,0 +1,45 @@
+#include "pch.h"
+
+#include "utils/ChecksumUtils.h"
+
+#include <array>
+
+namespace Rival { namespace ChecksumUtils {
+
+/** Reversed form of the standard CRC-32 polynomial. */
+static constexpr std::uint32_t polynomial = 0xedb88320u;
+
+/** Builds the table of remainders for each possible byte value. */
+static std::array<std::uint32_t, 256> makeCrcTable()
+{
+    std::array<std::uint32_t, 256> table {};
+    for (std::uint32_t i = 0; i < table.size(); ++i)
+    {
+        std::uint32_t remainder = i;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            remainder = (remainder & 1) ? (remainder >> 1) ^ polynomial : remainder >> 1;
+        }
+        table[i] = remainder;
+    }
+    return table;
+}
+
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size)
+{
+    static const std::array<std::uint32_t, 256> table = makeCrcTable();
+
+    std::uint32_t crc = 0xffffffffu;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+std::uint32_t crc32(const std::vector<std::uint8_t>& data)
+{
+    return crc32(data.data(), data.size());
+}
+
+}}  // namespace Rival::ChecksumUtils
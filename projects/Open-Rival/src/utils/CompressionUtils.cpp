@@ -0,0 +1,148 @@
+#include "pch.h"
+
+#include "utils/CompressionUtils.h"
+
+#include <algorithm>  // std::min
+#include <limits>
+#include <stdexcept>
+
+#include "utils/BufferUtils.h"
+
+namespace Rival { namespace CompressionUtils {
+
+/** Number of bits used to index the table of previously-seen positions. */
+static constexpr int hashBits = 12;
+
+/** Marks an entry in the table of previously-seen positions that has not been used yet. */
+static constexpr std::size_t noPosition = std::numeric_limits<std::size_t>::max();
+
+/** Hashes the `minMatchLength` bytes starting at the given position. */
+static std::size_t hashAt(const std::vector<std::uint8_t>& data, std::size_t pos)
+{
+    const std::uint32_t bytes = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16);
+    return static_cast<std::size_t>((bytes * 2654435761u) >> (32 - hashBits));
+}
+
+/** Writes the bytes in the range [start, end) as one or more literal runs. */
+static void
+addLiterals(std::vector<char>& compressed, const std::vector<std::uint8_t>& data, std::size_t start, std::size_t end)
+{
+    while (start < end)
+    {
+        const std::size_t length = std::min(end - start, maxLiteralLength);
+        compressed.push_back(static_cast<char>(length - 1));
+        compressed.insert(compressed.cend(), data.cbegin() + start, data.cbegin() + start + length);
+        start += length;
+    }
+}
+
+std::vector<char> compress(const std::vector<std::uint8_t>& data)
+{
+    std::vector<char> compressed;
+
+    // Most recent position at which each hash was seen.
+    // Only the most recent candidate is considered, which is enough to find repeated tiles.
+    std::vector<std::size_t> lastSeen(std::size_t(1) << hashBits, noPosition);
+
+    std::size_t literalStart = 0;
+    std::size_t pos = 0;
+    while (pos + minMatchLength <= data.size())
+    {
+        const std::size_t hash = hashAt(data, pos);
+        const std::size_t candidate = lastSeen[hash];
+        lastSeen[hash] = pos;
+
+        std::size_t matchLength = 0;
+        if (candidate != noPosition && pos - candidate <= maxMatchDistance)
+        {
+            const std::size_t maxLength = std::min(maxMatchLength, data.size() - pos);
+            while (matchLength < maxLength && data[candidate + matchLength] == data[pos + matchLength])
+            {
+                ++matchLength;
+            }
+        }
+
+        if (matchLength < minMatchLength)
+        {
+            ++pos;
+            continue;
+        }
+
+        addLiterals(compressed, data, literalStart, pos);
+        compressed.push_back(static_cast<char>(0x80 + matchLength - minMatchLength));
+        BufferUtils::reserveInBuffer(compressed, BufferUtils::maxVarIntBytes);
+        BufferUtils::addVarUintToBuffer(compressed, static_cast<std::uint32_t>(pos - candidate));
+
+        // Remember the positions covered by the match, so that later data can refer back to them
+        for (std::size_t i = 1; i < matchLength && pos + i + minMatchLength <= data.size(); ++i)
+        {
+            lastSeen[hashAt(data, pos + i)] = pos + i;
+        }
+
+        pos += matchLength;
+        literalStart = pos;
+    }
+
+    addLiterals(compressed, data, literalStart, data.size());
+
+    return compressed;
+}
+
+std::vector<std::uint8_t> decompress(const std::vector<char>& data, std::size_t decompressedSize)
+{
+    std::vector<std::uint8_t> decompressed;
+    decompressed.reserve(decompressedSize);
+
+    std::size_t offset = 0;
+    while (offset < data.size())
+    {
+        const auto control = static_cast<std::uint8_t>(data[offset]);
+        ++offset;
+
+        if (control < 0x80)
+        {
+            const std::size_t length = control + std::size_t(1);
+            if (offset + length > data.size())
+            {
+                throw std::runtime_error("Compressed data ends part-way through a literal run");
+            }
+            if (decompressed.size() + length > decompressedSize)
+            {
+                throw std::runtime_error("Compressed data is larger than expected");
+            }
+
+            decompressed.insert(decompressed.cend(), data.cbegin() + offset, data.cbegin() + offset + length);
+            offset += length;
+        }
+        else
+        {
+            const std::size_t length = control - std::size_t(0x80) + minMatchLength;
+            const std::size_t distance = BufferUtils::readVarUintFromBuffer(data, offset);
+            if (distance == 0 || distance > decompressed.size())
+            {
+                throw std::runtime_error("Compressed data contains an invalid match");
+            }
+            if (decompressed.size() + length > decompressedSize)
+            {
+                throw std::runtime_error("Compressed data is larger than expected");
+            }
+
+            // Copy one byte at a time, since the match may overlap the bytes it produces
+            const std::size_t start = decompressed.size() - distance;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                const std::uint8_t byte = decompressed[start + i];
+                decompressed.push_back(byte);
+            }
+        }
+    }
+
+    if (decompressed.size() != decompressedSize)
+    {
+        throw std::runtime_error("Compressed data is smaller than expected");
+    }
+
+    return decompressed;
+}
+
+}}  // namespace Rival::CompressionUtils
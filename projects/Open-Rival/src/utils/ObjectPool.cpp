@@ -0,0 +1,55 @@
+#include "pch.h"
+
+#include "utils/ObjectPool.h"
+
+#include <new>  // placement new
+
+namespace Rival {
+
+/** Rounds a block size up so that every block in a chunk is suitably aligned for any type. */
+static std::size_t getAlignedBlockSize(std::size_t blockSize)
+{
+    constexpr std::size_t alignment = alignof(std::max_align_t);
+    const std::size_t minSize = blockSize < sizeof(void*) ? sizeof(void*) : blockSize;
+    return (minSize + alignment - 1) / alignment * alignment;
+}
+
+FixedBlockPool::FixedBlockPool(std::size_t blockSize)
+    : blockSize(getAlignedBlockSize(blockSize))
+{
+}
+
+void* FixedBlockPool::allocate()
+{
+    std::scoped_lock lock(mutex);
+
+    if (!freeList)
+    {
+        // Grow the pool by another chunk, and add all of its blocks to the free list
+        chunks.push_back(std::make_unique<char[]>(blockSize * blocksPerChunk));
+        char* chunk = chunks.back().get();
+        for (std::size_t i = 0; i < blocksPerChunk; ++i)
+        {
+            deallocateLocked(chunk + i * blockSize);
+        }
+    }
+
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    return block;
+}
+
+void FixedBlockPool::deallocate(void* block) noexcept
+{
+    std::scoped_lock lock(mutex);
+    deallocateLocked(block);
+}
+
+void FixedBlockPool::deallocateLocked(void* block) noexcept
+{
+    FreeBlock* freeBlock = new (block) FreeBlock;
+    freeBlock->next = freeList;
+    freeList = freeBlock;
+}
+
+}  // namespace Rival
@@ -0,0 +1,205 @@
+#include "pch.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "net/NetUtils.h"
+#include "net/RelayRoom.h"
+#include "net/Server.h"
+#include "PlayerState.h"
+
+using namespace Rival;
+
+namespace {
+
+/** Set when the server has been asked to shut down. */
+std::atomic<bool> stopRequested = false;
+
+void onStopSignal(int)
+{
+    stopRequested = true;
+}
+
+struct RelayOptions
+{
+    std::uint16_t port = 25565;
+    int maxRooms = 16;
+    int maxPlayersPerRoom = PlayerStore::maxPlayers;
+
+    /** Interval at which room metrics are printed, in seconds; 0 to disable. */
+    int statsInterval = 10;
+
+    SlowClientPolicy slowClientPolicy = SlowClientPolicy::Disconnect;
+};
+
+int parseInt(int argc, char* argv[], int index, int min, int max)
+{
+    if (index >= argc)
+    {
+        throw std::runtime_error("No value supplied for argument");
+    }
+    try
+    {
+        int val = std::stoi(argv[index]);
+        if (val < min || val > max)
+        {
+            throw std::out_of_range("Argument out of range");
+        }
+        return val;
+    }
+    catch (const std::invalid_argument&)
+    {
+        throw std::runtime_error("Invalid value supplied for argument");
+    }
+    catch (const std::out_of_range&)
+    {
+        throw std::runtime_error(
+                "Value must be between "         //
+                + std::to_string(min) + " and "  //
+                + std::to_string(max));
+    }
+}
+
+/** Parses the command-line options, returning an error message if they are invalid. */
+std::string parseArgs(int argc, char* argv[], RelayOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        try
+        {
+            if (arg == "-port")
+            {
+                options.port = static_cast<std::uint16_t>(parseInt(argc, argv, ++i, 0, 65535));
+            }
+            else if (arg == "-rooms")
+            {
+                options.maxRooms = parseInt(argc, argv, ++i, 1, 4096);
+            }
+            else if (arg == "-players")
+            {
+                options.maxPlayersPerRoom = parseInt(argc, argv, ++i, 1, PlayerStore::maxPlayers);
+            }
+            else if (arg == "-stats")
+            {
+                options.statsInterval = parseInt(argc, argv, ++i, 0, 3600);
+            }
+            else if (arg == "-slowclients")
+            {
+                const std::string policy = ++i < argc ? argv[i] : "";
+                if (policy == "disconnect")
+                {
+                    options.slowClientPolicy = SlowClientPolicy::Disconnect;
+                }
+                else if (policy == "drop")
+                {
+                    options.slowClientPolicy = SlowClientPolicy::DropPackets;
+                }
+                else
+                {
+                    return "Expected: -slowclients [disconnect|drop]";
+                }
+            }
+            else
+            {
+                return "Invalid argument: " + arg;
+            }
+        }
+        catch (const std::runtime_error& e)
+        {
+            return std::string(e.what()) + "\nExpected: " + arg + " [value]";
+        }
+    }
+
+    return {};
+}
+
+void printMetrics(const std::vector<RoomMetrics>& roomMetrics)
+{
+    std::cout << "Active rooms: " << roomMetrics.size() << "\n";
+    for (const RoomMetrics& metrics : roomMetrics)
+    {
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  Room " << metrics.roomId << ": " << metrics.numClients << " clients";
+        std::cout << ", in " << metrics.packetsInPerSecond << " packets/s (" << metrics.bytesInPerSecond << " B/s)";
+        std::cout << ", out " << metrics.packetsOutPerSecond << " packets/s (" << metrics.bytesOutPerSecond
+                  << " B/s)";
+        std::cout << ", " << metrics.readsPerSecond << " reads/s, " << metrics.writesPerSecond << " writes/s";
+        std::cout << ", max queued " << metrics.maxPendingWriteBytes << " B";
+        if (metrics.packetsDropped > 0 || metrics.slowClientsDisconnected > 0)
+        {
+            std::cout << ", " << metrics.packetsDropped << " packets dropped, " << metrics.slowClientsDisconnected
+                      << " slow clients disconnected";
+        }
+        std::cout << "\n";
+    }
+}
+
+}  // namespace
+
+/**
+ * Entry point for the dedicated relay server.
+ *
+ * This hosts many independent games at once, without any of the game's graphics or audio dependencies.
+ */
+int main(int argc, char* argv[])
+{
+    RelayOptions options;
+    const std::string error = parseArgs(argc, argv, options);
+    if (!error.empty())
+    {
+        std::cerr << error << "\n";
+        return -1;
+    }
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    int exitCode = 0;
+
+    try
+    {
+        NetUtils::initNetworking();
+
+        {
+            Server server(options.port, options.maxPlayersPerRoom, options.maxRooms, options.slowClientPolicy);
+            server.start();
+
+            std::cout << "Relay server listening on port " << options.port << " (" << options.maxRooms
+                      << " rooms, " << options.maxPlayersPerRoom << " players per room)\n";
+
+            auto nextStatsTime = std::chrono::steady_clock::now() + std::chrono::seconds(options.statsInterval);
+            while (!stopRequested)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+                if (options.statsInterval > 0 && std::chrono::steady_clock::now() >= nextStatsTime)
+                {
+                    printMetrics(*server.getRoomMetrics());
+                    nextStatsTime += std::chrono::seconds(options.statsInterval);
+                }
+            }
+
+            std::cout << "Shutting down\n";
+        }
+
+        NetUtils::destroyNetworking();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Unhandled error in relay server\n";
+        std::cerr << e.what() << "\n";
+        exitCode = 1;
+    }
+
+    return exitCode;
+}